@@ -14,16 +14,16 @@ void ofApp::setup(){
     sbMultiTest.init("soundbites/multi", 0.5, 3);
     sbJardins.init("soundbites/jardins", 0.25, 3);
 
-    // mRainy.init("rainy", ambRain, 1, sbMultiTest);
-    mRainy.init("rainy", ambRain,    2, sbThunder, sbCarDriving);
-    // mSunny.init("sunny", ambRain, 1, sbMultiTest);
-    mUrban.init("urban", ambCityHum, 1, sbJardins);
+    // mRainy.init("rainy", ambRain, { sbMultiTest });
+    mRainy.init("rainy", std::move(ambRain),    { sbThunder, sbCarDriving });
+    // mSunny.init("sunny", ambRain, { sbMultiTest });
+    mUrban.init("urban", std::move(ambCityHum), { sbJardins });
 
     currentMood = 0;
 
-    moods.push_back(mRainy);
-    // moods.push_back(mSunny);
-    moods.push_back(mUrban);
+    moods.push_back(std::move(mRainy));
+    // moods.push_back(std::move(mSunny));
+    moods.push_back(std::move(mUrban));
 
     moods[currentMood].getAmbientSound().play();
 }
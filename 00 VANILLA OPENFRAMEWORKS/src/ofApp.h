@@ -1,6 +1,5 @@
 #pragma once
 
-#include <stdarg.h>
 #include "ofMain.h"
 
 class ofApp : public ofBaseApp{
@@ -72,19 +71,12 @@ class ofApp : public ofBaseApp{
 			Sound ambientSound;       // ambient sounds loop for the entire duration of the soundscape
 			vector<Sound> soundbites; // soundbites are small sounds that are dispersed at random times
 
-			void init(string name, Sound ambsnd, int numOfBites, ...) {
-				this->name = name;
-				this->ambientSound = ambsnd;
-
-				va_list vl;
-				va_start(vl, numOfBites);
-
-				for (int i = 0; i < numOfBites; i++) {
-					this->soundbites.push_back(va_arg(vl, Sound));
-				}
-				cout << this->name << " :: " << numOfBites << " soundbites" << endl;
-
-				va_end(vl);
+			// taken by value & moved in, so a caller handing over temporaries doesn't pay for a copy
+			void init(string name, Sound ambsnd, vector<Sound> bites) {
+				this->name = std::move(name);
+				this->ambientSound = std::move(ambsnd);
+				this->soundbites = std::move(bites);
+				cout << this->name << " :: " << this->soundbites.size() << " soundbites" << endl;
 			}
 
 			ofSoundPlayer getRandomSoundbite() { return soundbites[(int)ofRandom(soundbites.size())].getSample(); };
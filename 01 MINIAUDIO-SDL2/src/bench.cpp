@@ -0,0 +1,176 @@
+// how many my_data_source voices one core can keep up with. every voice is read 512 frames at a time the way the
+// device would, once with the old sample at a time path (sin() & adsr() per sample), once with the block synth and
+// once played out of a prerender_cache. then how much of a core a poly_synth takes while a note starts every few
+// milliseconds, and what timing every callback with a callback_timer costs next to the period it has
+//
+//     make bench
+//     ./bin/bench 256 5 500   // voices, seconds rendered per path, poly_synth notes a second
+
+#define MA_NO_DEVICE_IO
+#define MINIAUDIO_IMPLEMENTATION
+#define CALLBACK_TIMING
+
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <chrono>
+
+#include "../libs/miniaudio.h"
+
+#include "my_data_source.h"
+#include "poly_synth.h"
+#include "prerender_cache.h"
+#include "callback_timer.h"
+
+#define BENCH_SAMPLE_RATE 44100
+#define BENCH_PERIOD      512
+
+// the read path as it was, minus the logging
+static void read_per_sample(my_data_source* ds, float* out, ma_uint64 frameCount) {
+    for (ma_uint64 i = 0; i < frameCount; i += 1) {
+        float a = adsr(ds->attack, ds->decay, ds->sustain, ds->release, ds->time / ds->length) * 0.5;
+        float s = sin(2 * 3.14159265358979323846 * ds->frequency * ds->time) * a;
+        ds->time += ds->advance;
+        out[i*2]     = s;
+        out[i*2 + 1] = s;
+    }
+}
+
+// nanoseconds per voice per frame
+static double run(std::vector<my_data_source>& voices, double seconds, bool block) {
+    std::vector<float> out(BENCH_PERIOD * 2);
+    ma_uint64 periods = (ma_uint64)(seconds * BENCH_SAMPLE_RATE / BENCH_PERIOD);
+
+    auto start = std::chrono::steady_clock::now();
+    for (ma_uint64 p = 0; p < periods; p++) {
+        for (my_data_source& ds : voices) {
+            if (block) my_data_source_read(&ds, out.data(), BENCH_PERIOD, NULL);
+            else       read_per_sample(&ds, out.data(), BENCH_PERIOD);
+        }
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    return elapsed / ((double)periods * BENCH_PERIOD * voices.size());
+}
+
+// nanoseconds per voice per frame for `voiceAmount` one second notes, retriggered whenever they end, played out of
+// a cache holding all of it (`cached`) or synthesised. -1 if the cache couldn't be made
+static double run_triggers(int voiceAmount, double seconds, bool cached) {
+    static prerender_cache cache;
+    if (prerender_cache_init(&cache, 330.0f, 1, cached ? 3.0f : 0.0f) != MA_SUCCESS) {
+        prerender_cache_uninit(&cache);
+        return -1.0;
+    }
+    while (cache.ready.load() < cache.capacity) std::this_thread::yield();
+
+    // spread through the note, so they aren't all reading the same few frames
+    std::vector<cached_voice> voices(voiceAmount);
+    for (int i = 0; i < voiceAmount; i++) {
+        cached_voice_init(&voices[i], &cache);
+        cached_voice_seek(&voices[i], (ma_uint64)i * 7919 % voices[i].source.frames);
+    }
+
+    std::vector<float> out(BENCH_PERIOD * 2);
+    ma_uint64 periods = (ma_uint64)(seconds * BENCH_SAMPLE_RATE / BENCH_PERIOD);
+
+    auto start = std::chrono::steady_clock::now();
+    for (ma_uint64 p = 0; p < periods; p++) {
+        for (cached_voice& voice : voices) {
+            ma_uint64 frames;
+            cached_voice_read(&voice, out.data(), BENCH_PERIOD, &frames);
+            if (frames < BENCH_PERIOD) cached_voice_seek(&voice, 0); // retrigger
+        }
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    for (cached_voice& voice : voices) cached_voice_uninit(&voice);
+    prerender_cache_uninit(&cache);
+    return elapsed / ((double)periods * BENCH_PERIOD * voiceAmount);
+}
+
+// fraction of a core spent rendering `seconds` of a poly_synth with `rate` chirps a second
+static double run_poly(double seconds, double rate) {
+    static poly_synth synth;
+    poly_synth_init(&synth);
+    envelope_config chirp = { 0.005f, 0.05f, 0.6f, 0.3f, 0.08f };
+
+    std::vector<float> out(BENCH_PERIOD * 2);
+    ma_uint64 periods = (ma_uint64)(seconds * BENCH_SAMPLE_RATE / BENCH_PERIOD);
+    double framesPerNote = BENCH_SAMPLE_RATE / rate;
+    double nextNote = 0.0;
+
+    double elapsed = 0.0;
+    for (ma_uint64 p = 0; p < periods; p++) {
+        // the notes due this period, each landing on its own frame within it
+        for (; nextNote < (p + 1) * BENCH_PERIOD; nextNote += framesPerNote) {
+            ma_uint64 delay = (ma_uint64)nextNote - p * BENCH_PERIOD;
+            poly_synth_note_on(&synth, 220.0f + (float)(p % 24) * 20.0f, 0.1f, &chirp, delay);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        poly_synth_read(&synth, out.data(), BENCH_PERIOD, NULL);
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    poly_synth_uninit(&synth);
+    return elapsed / seconds;
+}
+
+// nanoseconds a callback_timer_begin() & callback_timer_end() pair adds to a callback
+static double run_timer(int callbacks) {
+    static callback_timer timer;
+    callback_timer_init(&timer, BENCH_SAMPLE_RATE);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < callbacks; i++) {
+        ma_uint64 begin = callback_timer_begin();
+        callback_timer_end(&timer, begin, BENCH_PERIOD);
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    return elapsed / callbacks;
+}
+
+int main(int argc, char** argv) {
+    int voiceAmount = (argc > 1) ? atoi(argv[1]) : 256;
+    double seconds  = (argc > 2) ? atof(argv[2]) : 5.0;
+    double rate     = (argc > 3) ? atof(argv[3]) : 500.0;
+
+    // --- voices held in their sustain so both paths do the same work throughout
+    std::vector<my_data_source> voices(voiceAmount);
+    for (int i = 0; i < voiceAmount; i++) {
+        my_data_source_init(&voices[i]);
+        voices[i].frequency = 110.0f + i;
+        voices[i].length    = 1000000;
+        oscillator_set_frequency(&voices[i].osc, voices[i].frequency, BENCH_SAMPLE_RATE);
+
+        envelope_config hold = { 0.01f, 0.2f, 0.8f, 2.0f, 0.0f };
+        my_data_source_set_envelope(&voices[i], &hold);
+    }
+
+    FILE* sink = tmpfile();
+    double perSample = run(voices, seconds, false);
+    double block     = run(voices, seconds, true);
+    double poly      = run_poly(seconds, rate);
+    double triggered = run_triggers(voiceAmount, seconds, false);
+    double cached    = run_triggers(voiceAmount, seconds, true);
+    double timer     = run_timer(1000000);
+    trace_flush(sink);
+    if (triggered < 0.0 || cached < 0.0) {
+        printf("couldn't allocate the note cache\n");
+        return -1;
+    }
+
+    // a core is spent once a second of audio takes a second to make
+    printf("%d voices, %.1f s each\n", voiceAmount, seconds);
+    printf("  per sample | %7.2f ns per voice frame | %8.0f voices per core\n", perSample, 1e9 / (perSample * BENCH_SAMPLE_RATE));
+    printf("  block      | %7.2f ns per voice frame | %8.0f voices per core\n", block, 1e9 / (block * BENCH_SAMPLE_RATE));
+    printf("  retrigger  | %7.2f ns per voice frame | %8.0f voices per core\n", triggered, 1e9 / (triggered * BENCH_SAMPLE_RATE));
+    printf("  cached     | %7.2f ns per voice frame | %8.0f voices per core\n", cached, 1e9 / (cached * BENCH_SAMPLE_RATE));
+    printf("  poly_synth | %d voice pool, %.0f notes a second | %.2f%% of a core\n", POLY_SYNTH_VOICES, rate, 100.0 * poly);
+    printf("  timing     | %7.2f ns per callback | %.5f%% of a %d frame period\n", timer, 100.0 * timer / (1e9 * BENCH_PERIOD / BENCH_SAMPLE_RATE), BENCH_PERIOD);
+
+    for (my_data_source& ds : voices) my_data_source_uninit(&ds);
+    fclose(sink);
+    return 0;
+}
@@ -16,8 +16,9 @@
 
 #include "../libs/miniaudio.h"
 
-#include "my_data_source.h"
+#include "poly_synth.h"
 #include "entity.h"
+#include "callback_timer.h"
 
 #define SAMPLE_RATE   44100
 
@@ -46,8 +47,17 @@ struct {
 
 // --- ma setup
 static ma_engine engine;
-static ma_sound chirp;
-static my_data_source test;
+static ma_sound chirps;    // plays forever, every bounce is a note on `synth`
+static poly_synth synth;
+static callback_timer timing; // build with `make timing` to fill it in
+
+static const envelope_config chirp = {
+    0.005f, // attack, seconds
+    0.05f,  // decay, seconds
+    0.6f,   // sustain level
+    0.3f,   // release, seconds
+    0.08f   // seconds until the release
+};
 
 // --- sdl setup
 SDL_Window* window = nullptr;
@@ -58,7 +68,9 @@ void data_callback(void* pUserData, ma_uint8* pBuffer, int bufferSizeInBytes)
 {
     /* Reading is just a matter of reading straight from the engine. */
     ma_uint32 bufferSizeInFrames = (ma_uint32)bufferSizeInBytes / ma_get_bytes_per_frame(ma_format_f32, ma_engine_get_channels(&engine));
+    ma_uint64 start = callback_timer_begin();
     ma_engine_read_pcm_frames(&engine, pBuffer, bufferSizeInFrames, NULL);
+    callback_timer_end(&timing, start, bufferSizeInFrames);
 }
 
 static void input() {
@@ -92,12 +104,13 @@ static void update() {
 
     ball.position += ball.direction * (ball.speed * (float)deltaTime);
 
+    // side walls chirp lower than the top & bottom, overlapping whatever is still ringing
     if (ball.position.x > WINDOW_WIDTH || ball.position.x < 0 - ball.size / 2) {
         ball.direction.x = -ball.direction.x;
-        ma_sound_start(&chirp);
+        poly_synth_note_on(&synth, 440.0f, 0.25f, &chirp);
     } else if (ball.position.y > WINDOW_HEIGHT || ball.position.y < 0 - ball.size / 2) {
         ball.direction.y = -ball.direction.y;
-        ma_sound_start(&chirp);
+        poly_synth_note_on(&synth, 660.0f, 0.25f, &chirp);
     }
 
 }
@@ -131,6 +144,18 @@ static void mainloop(void) {
 
     update();
     draw();
+
+    trace_flush(); // print whatever the audio thread logged since the last frame
+
+    #ifdef CALLBACK_TIMING
+        static double untilReport = 1000.0; // ms
+        untilReport -= deltaTime;
+        if (untilReport <= 0.0) {
+            untilReport += 1000.0;
+            callback_timer_stats stats = callback_timer_get(&timing);
+            callback_timer_print(&stats);
+        }
+    #endif
 }
 
 int main() {
@@ -149,18 +174,22 @@ int main() {
         return -1;
     }
 
-    result = my_data_source_init(&test);
+    result = poly_synth_init(&synth);
     if (result != MA_SUCCESS) {
-        printf("Failed to initialise my_data_source.\n");
+        printf("Failed to initialise poly_synth.\n");
         return -1;
     }
 
-    result = ma_sound_init_from_data_source(&engine, &test, 0, NULL, &chirp);
+    result = ma_sound_init_from_data_source(&engine, &synth, 0, NULL, &chirps);
     if (result != MA_SUCCESS) {
         printf("Failed to initialise sound.\n");
         return -1;
     }
 
+    ma_sound_start(&chirps);
+
+    callback_timer_init(&timing, ma_engine_get_sample_rate(&engine));
+
     // --- sdl
     SDL_AudioSpec desiredSpec;
     SDL_AudioSpec obtainedSpec;
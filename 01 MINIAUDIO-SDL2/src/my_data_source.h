@@ -1,9 +1,17 @@
+#ifndef MY_DATA_SOURCE_H
+#define MY_DATA_SOURCE_H
+
 #include "../libs/miniaudio.h"
 #include "logic.h"
+#include "synth.h"
+#include "trace.h"
 
 #define SAMPLE_RATE 44100
 #define PI          3.14159265358979323846
 
+// a note is a pure function of how far into it you are, so it can be seeked, looped & rendered ahead of time
+#define MY_DATA_SOURCE_ENDLESS (~(ma_uint64)0)
+
 struct my_data_source
 {
     ma_data_source_base base;
@@ -11,19 +19,23 @@ struct my_data_source
     ma_uint64 length;
     double time, advance;
     float attack, decay, sustain, release;
+
+    oscillator osc;
+    envelope env;
+    envelope_config config; // what the envelope was triggered with, to replay it from the start on a seek
+    ma_uint64 cursor;       // frames since the trigger
+    ma_uint64 frames;       // the whole note, attack to the end of its release, or MY_DATA_SOURCE_ENDLESS
 };
 
+static ma_result my_data_source_seek(ma_data_source* pDataSource, ma_uint64 frameIndex);
+
 static ma_result my_data_source_read(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead)
 {
     // Read data here. Output in the same format returned by my_data_source_get_data_format().
-    printf("reading %i frames\n", frameCount);
+    trace("reading frames", (double)frameCount);
 
     my_data_source* ds = (my_data_source*)pDataSource;
 
-    if (ds->time > ds->length) {
-        printf("ok\n");
-    }
-
     if (pFramesRead != NULL) {
         *pFramesRead = 0;
     }
@@ -36,20 +48,49 @@ static ma_result my_data_source_read(ma_data_source* pDataSource, void* pFramesO
         return MA_INVALID_ARGS;
     }
 
+    // nothing past the end of the release
+    if (ds->frames != MY_DATA_SOURCE_ENDLESS) {
+        ma_uint64 left = (ds->cursor < ds->frames) ? ds->frames - ds->cursor : 0;
+        if (left == 0) {
+            return MA_AT_END;
+        }
+        if (frameCount > left) {
+            frameCount = left;
+        }
+    }
+
     if (pFramesOut == NULL) {
-        return MA_INVALID_ARGS;
+        // miniaudio reads into nothing to seek forwards
+        my_data_source_seek(ds, ds->cursor + frameCount);
     } else {
         float* pFramesOutF32 = (float*)pFramesOut;
-        for (ma_uint64 i = 0; i < frameCount; i += 1) {
-            float a = adsr(ds->attack, ds->decay, ds->sustain, ds->release, ds->time / ds->length) * 0.5;
+        bool sounding = !envelope_is_idle(&ds->env);
+
+        // a block of the oscillator & a block of the envelope, then multiply them together
+        float wave[SYNTH_BLOCK];
+        float level[SYNTH_BLOCK];
+        for (ma_uint64 done = 0; done < frameCount; ) {
+            int frames = (frameCount - done < SYNTH_BLOCK) ? (int)(frameCount - done) : SYNTH_BLOCK;
 
-            float s = sin(2 * PI * ds->frequency * ds->time) * a; // sin(2 * pi * f * t) * a
+            oscillator_process(&ds->osc, wave, frames);
+            envelope_process(&ds->env, level, frames);
 
-            ds->time += ds->advance;               // advance by 1 sample
+            float* out = pFramesOutF32 + done * 2;
+            for (int i = 0; i < frames; i += 1) {
+                float s = wave[i] * level[i] * 0.5f; // sin(2 * pi * f * t) * a
 
-            for (ma_uint64 c = 0; c < 2; c += 1) { // channels!
-                pFramesOutF32[i*2 + c] = s;
+                out[i*2]     = s; // channels!
+                out[i*2 + 1] = s;
             }
+
+            done += frames;
+        }
+
+        ds->cursor += frameCount;
+        ds->time    = ds->advance * ds->cursor;
+
+        if (sounding && envelope_is_idle(&ds->env)) {
+            trace("envelope finished at", ds->time);
         }
     }
 
@@ -63,18 +104,31 @@ static ma_result my_data_source_read(ma_data_source* pDataSource, void* pFramesO
 static ma_result my_data_source_seek(ma_data_source* pDataSource, ma_uint64 frameIndex)
 {
     // Seek to a specific PCM frame here. Return MA_NOT_IMPLEMENTED if seeking is not supported.
-    printf("seeking @ frameIndex %i\n", frameIndex);
+    trace("seeking @ frameIndex", (double)frameIndex);
 
     my_data_source* ds = (my_data_source*)pDataSource;
 
-    ds->time = frameIndex;
+    if (pDataSource == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    // the oscillator's phase follows from the frame, the envelope is replayed from its trigger a stage at a time.
+    // either way it costs the same wherever it lands
+    ds->osc.phase = fmod(ds->osc.increment * (double)frameIndex, 1.0);
 
-    return MA_NOT_IMPLEMENTED;
+    envelope_init(&ds->env, SAMPLE_RATE);
+    envelope_trigger(&ds->env, &ds->config);
+    envelope_skip(&ds->env, (long long)frameIndex);
+
+    ds->cursor = frameIndex;
+    ds->time   = ds->advance * frameIndex;
+
+    return MA_SUCCESS;
 }
 
 static ma_result my_data_source_get_data_format(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap)
 {
-    printf("get data format\n");
+    trace("get data format");
 
     my_data_source* ds = (my_data_source*)pDataSource;
 
@@ -97,33 +151,59 @@ static ma_result my_data_source_get_data_format(ma_data_source* pDataSource, ma_
     return MA_SUCCESS;
 }
 
-// static ma_result my_data_source_get_cursor(ma_data_source* pDataSource, ma_uint64* pCursor)
-// {
-//     // Retrieve the current position of the cursor here. Return MA_NOT_IMPLEMENTED and set *pCursor to 0 if there is no notion of a cursor.
-//     printf("get cursor\n");
-//     return MA_NOT_IMPLEMENTED;
-// }
-
-// static ma_result my_data_source_get_length(ma_data_source* pDataSource, ma_uint64* pLength)
-// {
-//     // Retrieve the length in PCM frames here. Return MA_NOT_IMPLEMENTED and set *pLength to 0 if there is no notion of a length or if the length is unknown.
-//     printf("get length\n");
-//     pLength = 0;
-//     return MA_NOT_IMPLEMENTED;
-// }
+static ma_result my_data_source_get_cursor(ma_data_source* pDataSource, ma_uint64* pCursor)
+{
+    // Retrieve the current position of the cursor here. Return MA_NOT_IMPLEMENTED and set *pCursor to 0 if there is no notion of a cursor.
+    my_data_source* ds = (my_data_source*)pDataSource;
+
+    if (pDataSource == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    *pCursor = ds->cursor;
+    return MA_SUCCESS;
+}
+
+static ma_result my_data_source_get_length(ma_data_source* pDataSource, ma_uint64* pLength)
+{
+    // Retrieve the length in PCM frames here. Return MA_NOT_IMPLEMENTED and set *pLength to 0 if there is no notion of a length or if the length is unknown.
+    my_data_source* ds = (my_data_source*)pDataSource;
+
+    if (pDataSource == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    if (ds->frames == MY_DATA_SOURCE_ENDLESS) {
+        *pLength = 0;
+        return MA_NOT_IMPLEMENTED;
+    }
+
+    *pLength = ds->frames;
+    return MA_SUCCESS;
+}
 
 static ma_data_source_vtable g_my_data_source_vtable =
 {
     my_data_source_read,
     my_data_source_seek,
-    my_data_source_get_data_format//,
-    // my_data_source_get_cursor,
-    // my_data_source_get_length
+    my_data_source_get_data_format,
+    my_data_source_get_cursor,
+    my_data_source_get_length
 };
 
-ma_result my_data_source_init(my_data_source* pMyDataSource)
+// trigger the note again with a different envelope, from the start
+static void my_data_source_set_envelope(my_data_source* pMyDataSource, const envelope_config* config)
+{
+    long long frames = envelope_frames(config, SAMPLE_RATE);
+
+    pMyDataSource->config = *config;
+    pMyDataSource->frames = (frames < 0) ? MY_DATA_SOURCE_ENDLESS : (ma_uint64)frames;
+    my_data_source_seek(pMyDataSource, 0);
+}
+
+ma_result my_data_source_init(my_data_source* pMyDataSource, float frequency = 440, ma_uint64 length = 1)
 {
-    printf("init\n");
+    trace("init", frequency);
 
     ma_result result;
     ma_data_source_config baseConfig;
@@ -136,26 +216,39 @@ ma_result my_data_source_init(my_data_source* pMyDataSource)
         return result;
     }
 
-    pMyDataSource->frequency  = 440;       // fundamental frequency
+    pMyDataSource->frequency  = frequency; // fundamental frequency
 
     pMyDataSource->time       = 0;
     pMyDataSource->advance    = 1.0 / (SAMPLE_RATE);
-    pMyDataSource->length     = 1;
+    pMyDataSource->length     = length;    // seconds until the release
 
     pMyDataSource->attack     = 0.01;      // % of length
     pMyDataSource->decay      = 0.2;       // % of length
     pMyDataSource->sustain    = 0.8;       // amplitude constant
     pMyDataSource->release    = 2.0 + 1.0; // seconds + 1.0
 
+    // the envelope works in seconds, the fields above are in terms of `length`
+    envelope_config config;
+    config.attack  = pMyDataSource->attack * pMyDataSource->length;
+    config.decay   = pMyDataSource->decay * pMyDataSource->length;
+    config.sustain = pMyDataSource->sustain;
+    config.release = (pMyDataSource->release - 1.0f) * pMyDataSource->length;
+    config.length  = (float)pMyDataSource->length;
+
+    oscillator_init(&pMyDataSource->osc, pMyDataSource->frequency, SAMPLE_RATE);
+    my_data_source_set_envelope(pMyDataSource, &config);
+
     return MA_SUCCESS;
 }
 
 void my_data_source_uninit(my_data_source* pMyDataSource)
 {
-    printf("uninit\n");
+    trace("uninit");
 
     ma_data_source_uninit(&pMyDataSource->base);
 }
 
 #undef SAMPLE_RATE
-#undef PI
\ No newline at end of file
+#undef PI
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef POLY_SYNTH_H
+#define POLY_SYNTH_H
+
+#include <atomic>
+
+#include "../libs/miniaudio.h"
+#include "synth.h"
+#include "trace.h"
+
+// a data source that plays any number of overlapping notes through a fixed pool of voices. notes are started &
+// stopped with events the game thread pushes into a ring, each stamped with the frame it should be heard at, and
+// the audio thread splits its blocks wherever one lands. nothing is allocated after poly_synth_init()
+
+#ifndef POLY_SYNTH_VOICES
+    #define POLY_SYNTH_VOICES 32 // notes that can sound at once, the quietest is stolen past this
+#endif
+
+#ifndef POLY_SYNTH_EVENTS
+    #define POLY_SYNTH_EVENTS 256 // must be a power of two, events past this are dropped until the audio thread catches up
+#endif
+
+#define POLY_SYNTH_SAMPLE_RATE 44100
+
+enum poly_synth_event_type {
+    POLY_SYNTH_NOTE_ON,
+    POLY_SYNTH_NOTE_OFF
+};
+
+struct poly_synth_event {
+    poly_synth_event_type type;
+    ma_uint32 note;           // matches a note off to its note on
+    ma_uint64 frame;          // when to be heard, in frames since the synth started
+    float frequency;
+    float gain;
+    envelope_config envelope;
+};
+
+struct poly_synth_voice {
+    oscillator osc;
+    envelope env;
+    ma_uint32 note;
+    float gain;
+};
+
+struct poly_synth {
+    ma_data_source_base base;
+    poly_synth_voice voices[POLY_SYNTH_VOICES];
+
+    poly_synth_event events[POLY_SYNTH_EVENTS];
+    std::atomic<ma_uint32> event_write;
+    std::atomic<ma_uint32> event_read;
+
+    std::atomic<ma_uint64> cursor; // frames read so far, published by the audio thread
+    ma_uint32 next_note;           // game thread
+};
+
+// ------------------------------------------------------------
+// game thread
+
+static bool poly_synth_push(poly_synth* synth, const poly_synth_event& event) {
+    ma_uint32 write = synth->event_write.load(std::memory_order_relaxed);
+    if (write - synth->event_read.load(std::memory_order_acquire) >= POLY_SYNTH_EVENTS) {
+        trace("poly_synth dropped an event, note", event.note);
+        return false;
+    }
+    synth->events[write & (POLY_SYNTH_EVENTS - 1)] = event;
+    synth->event_write.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+// start a note `delay` frames from now & return something to stop it with, or 0 if the event ring is full. events
+// are taken in the order they were pushed, so a delayed one holds back any pushed after it
+static ma_uint32 poly_synth_note_on(poly_synth* synth, float frequency, float gain, const envelope_config* envelope, ma_uint64 delay = 0) {
+    poly_synth_event event;
+    event.type      = POLY_SYNTH_NOTE_ON;
+    event.note      = ++synth->next_note;
+    event.frame     = synth->cursor.load(std::memory_order_relaxed) + delay;
+    event.frequency = frequency;
+    event.gain      = gain;
+    event.envelope  = *envelope;
+    if (synth->next_note == 0) event.note = ++synth->next_note; // 0 is never a note
+
+    return poly_synth_push(synth, event) ? event.note : 0;
+}
+
+// release `note`, if it's still sounding
+static void poly_synth_note_off(poly_synth* synth, ma_uint32 note, ma_uint64 delay = 0) {
+    poly_synth_event event = {};
+    event.type  = POLY_SYNTH_NOTE_OFF;
+    event.note  = note;
+    event.frame = synth->cursor.load(std::memory_order_relaxed) + delay;
+    poly_synth_push(synth, event);
+}
+
+// ------------------------------------------------------------
+// audio thread
+
+// an idle voice if there is one, otherwise the quietest
+static poly_synth_voice* poly_synth_voice_for(poly_synth* synth) {
+    poly_synth_voice* quietest = &synth->voices[0];
+    for (int i = 0; i < POLY_SYNTH_VOICES; i++) {
+        poly_synth_voice* voice = &synth->voices[i];
+        if (envelope_is_idle(&voice->env)) return voice;
+        if (voice->env.level * voice->gain < quietest->env.level * quietest->gain) quietest = voice;
+    }
+    trace("poly_synth stole the voice playing note", quietest->note);
+    return quietest;
+}
+
+static void poly_synth_apply(poly_synth* synth, const poly_synth_event& event) {
+    if (event.type == POLY_SYNTH_NOTE_ON) {
+        poly_synth_voice* voice = poly_synth_voice_for(synth);
+        voice->note = event.note;
+        voice->gain = event.gain;
+        oscillator_set_frequency(&voice->osc, event.frequency, POLY_SYNTH_SAMPLE_RATE);
+        envelope_trigger(&voice->env, &event.envelope); // from whatever level a stolen voice was at, so it doesn't click
+    } else {
+        for (int i = 0; i < POLY_SYNTH_VOICES; i++) {
+            if (synth->voices[i].note == event.note) envelope_release(&synth->voices[i].env);
+        }
+    }
+}
+
+// add every sounding voice into `mono`
+static void poly_synth_render(poly_synth* synth, float* __restrict mono, int frames) {
+    float wave[SYNTH_BLOCK];
+    float level[SYNTH_BLOCK];
+
+    for (int i = 0; i < frames; i++) mono[i] = 0.0f;
+
+    for (int v = 0; v < POLY_SYNTH_VOICES; v++) {
+        poly_synth_voice* voice = &synth->voices[v];
+        if (envelope_is_idle(&voice->env)) continue;
+
+        oscillator_process(&voice->osc, wave, frames);
+        envelope_process(&voice->env, level, frames);
+
+        float gain = voice->gain;
+        for (int i = 0; i < frames; i++) mono[i] += wave[i] * level[i] * gain;
+    }
+}
+
+static ma_result poly_synth_read(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead)
+{
+    poly_synth* synth = (poly_synth*)pDataSource;
+
+    if (pFramesRead != NULL) {
+        *pFramesRead = 0;
+    }
+
+    if (frameCount == 0 || pFramesOut == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    float* pFramesOutF32 = (float*)pFramesOut;
+    ma_uint64 cursor     = synth->cursor.load(std::memory_order_relaxed);
+    ma_uint32 read       = synth->event_read.load(std::memory_order_relaxed);
+    ma_uint32 write      = synth->event_write.load(std::memory_order_acquire);
+
+    float mono[SYNTH_BLOCK];
+    for (ma_uint64 done = 0; done < frameCount; ) {
+        // everything due by now, late ones included
+        while (read != write && synth->events[read & (POLY_SYNTH_EVENTS - 1)].frame <= cursor) {
+            poly_synth_apply(synth, synth->events[read & (POLY_SYNTH_EVENTS - 1)]);
+            read++;
+        }
+
+        // render up to the next event, the end of the block or the end of the scratch buffer
+        ma_uint64 frames = frameCount - done;
+        if (frames > SYNTH_BLOCK) frames = SYNTH_BLOCK;
+        if (read != write) {
+            ma_uint64 until = synth->events[read & (POLY_SYNTH_EVENTS - 1)].frame - cursor;
+            if (until < frames) frames = until;
+        }
+
+        poly_synth_render(synth, mono, (int)frames);
+
+        float* out = pFramesOutF32 + done * 2;
+        for (ma_uint64 i = 0; i < frames; i += 1) {
+            out[i*2]     = mono[i]; // channels!
+            out[i*2 + 1] = mono[i];
+        }
+
+        done   += frames;
+        cursor += frames;
+    }
+
+    synth->event_read.store(read, std::memory_order_release);
+    synth->cursor.store(cursor, std::memory_order_relaxed);
+
+    if (pFramesRead != NULL) {
+        *pFramesRead = frameCount;
+    }
+
+    return MA_SUCCESS;
+}
+
+static ma_result poly_synth_seek(ma_data_source* pDataSource, ma_uint64 frameIndex)
+{
+    // a live synth has nowhere to seek to
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_result poly_synth_get_data_format(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap)
+{
+    if (pDataSource == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    if (pFormat != NULL) {
+        *pFormat = ma_format_f32;
+    }
+
+    if (pChannels != NULL) {
+        *pChannels = 2;
+    }
+
+    if (pSampleRate != NULL) {
+        *pSampleRate = POLY_SYNTH_SAMPLE_RATE;
+    }
+
+    return MA_SUCCESS;
+}
+
+static ma_data_source_vtable g_poly_synth_vtable =
+{
+    poly_synth_read,
+    poly_synth_seek,
+    poly_synth_get_data_format
+};
+
+ma_result poly_synth_init(poly_synth* pSynth)
+{
+    ma_result result;
+    ma_data_source_config baseConfig;
+
+    baseConfig = ma_data_source_config_init();
+    baseConfig.vtable = &g_poly_synth_vtable;
+
+    result = ma_data_source_init(&baseConfig, &pSynth->base);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    for (int i = 0; i < POLY_SYNTH_VOICES; i++) {
+        oscillator_init(&pSynth->voices[i].osc, 440.0f, POLY_SYNTH_SAMPLE_RATE);
+        envelope_init(&pSynth->voices[i].env, POLY_SYNTH_SAMPLE_RATE);
+        pSynth->voices[i].note = 0;
+        pSynth->voices[i].gain = 0.0f;
+    }
+
+    pSynth->event_write.store(0);
+    pSynth->event_read.store(0);
+    pSynth->cursor.store(0);
+    pSynth->next_note = 0;
+
+    return MA_SUCCESS;
+}
+
+void poly_synth_uninit(poly_synth* pSynth)
+{
+    ma_data_source_uninit(&pSynth->base);
+}
+
+#endif
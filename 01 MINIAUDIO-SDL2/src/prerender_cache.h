@@ -0,0 +1,217 @@
+#ifndef PRERENDER_CACHE_H
+#define PRERENDER_CACHE_H
+
+#include <atomic>
+#include <thread>
+
+#include "../libs/miniaudio.h"
+#include "my_data_source.h"
+
+// the first few seconds of a note that gets triggered over & over, rendered once on a background thread into a
+// buffer every trigger shares. a cached_voice plays from the buffer for as far as it's been rendered and
+// synthesises the rest itself, so a trigger costs a copy instead of a synth until it runs past the cache
+
+#define PRERENDER_CACHE_SAMPLE_RATE 44100
+#define PRERENDER_CACHE_CHUNK       4096 // frames rendered between publishing progress
+
+struct prerender_cache {
+    float frequency;
+    ma_uint64 length;
+
+    float* frames;                 // stereo
+    ma_uint64 capacity;            // frames
+    std::atomic<ma_uint64> ready;  // frames rendered so far, published by the worker
+    std::atomic<bool> stop;
+    std::thread worker;
+};
+
+struct cached_voice {
+    ma_data_source_base base;
+    prerender_cache* cache;
+    my_data_source source; // the same note, seeked to wherever the cache runs out
+    ma_uint64 cursor;
+    bool synthesising;     // `source` is already at `cursor`
+};
+
+// ------------------------------------------------------------
+// cache
+
+static void prerender_cache_work(prerender_cache* cache) {
+    my_data_source source;
+    my_data_source_init(&source, cache->frequency, cache->length);
+
+    for (ma_uint64 done = 0; done < cache->capacity && !cache->stop.load(std::memory_order_relaxed); ) {
+        ma_uint64 frames = cache->capacity - done;
+        if (frames > PRERENDER_CACHE_CHUNK) frames = PRERENDER_CACHE_CHUNK;
+
+        my_data_source_read(&source, cache->frames + done * 2, frames, NULL);
+        done += frames;
+        cache->ready.store(done, std::memory_order_release);
+    }
+
+    my_data_source_uninit(&source);
+}
+
+// start rendering the first `seconds` of the note my_data_source_init(frequency, length) makes. voices can play from
+// it straight away, they synthesise whatever isn't ready yet
+ma_result prerender_cache_init(prerender_cache* cache, float frequency, ma_uint64 length, float seconds) {
+    // no further than the note goes
+    my_data_source probe;
+    my_data_source_init(&probe, frequency, length);
+    ma_uint64 capacity = (ma_uint64)(seconds * PRERENDER_CACHE_SAMPLE_RATE);
+    if (probe.frames != MY_DATA_SOURCE_ENDLESS && capacity > probe.frames) capacity = probe.frames;
+    my_data_source_uninit(&probe);
+
+    cache->frequency = frequency;
+    cache->length    = length;
+    cache->capacity  = capacity;
+    cache->frames    = NULL;
+    cache->ready.store(0);
+    cache->stop.store(false);
+    if (capacity == 0) {
+        return MA_SUCCESS; // nothing to render, voices synthesise all of it
+    }
+
+    cache->frames = (float*)ma_malloc(sizeof(float) * 2 * capacity, NULL);
+    if (cache->frames == NULL) {
+        cache->capacity = 0;
+        return MA_OUT_OF_MEMORY;
+    }
+
+    cache->worker = std::thread(prerender_cache_work, cache);
+
+    return MA_SUCCESS;
+}
+
+// every voice on the cache has to be uninitialised first. safe after a failed init, which never started the worker
+void prerender_cache_uninit(prerender_cache* cache) {
+    cache->stop.store(true, std::memory_order_relaxed);
+    if (cache->worker.joinable()) cache->worker.join();
+    ma_free(cache->frames, NULL);
+}
+
+// ------------------------------------------------------------
+// voice
+
+static ma_result cached_voice_read(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead)
+{
+    cached_voice* voice = (cached_voice*)pDataSource;
+
+    if (pFramesRead != NULL) {
+        *pFramesRead = 0;
+    }
+
+    if (frameCount == 0 || pDataSource == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    float* out      = (float*)pFramesOut;
+    ma_uint64 ready = voice->cache->ready.load(std::memory_order_acquire);
+    ma_uint64 done  = 0;
+
+    // as much as the cache has
+    if (voice->cursor < ready) {
+        ma_uint64 frames = ready - voice->cursor;
+        if (frames > frameCount) frames = frameCount;
+        if (out != NULL) {
+            memcpy(out, voice->cache->frames + voice->cursor * 2, sizeof(float) * 2 * frames);
+        }
+
+        voice->cursor      += frames;
+        voice->synthesising = false;
+        done                = frames;
+    }
+
+    // the rest from the synth
+    if (done < frameCount) {
+        if (!voice->synthesising) {
+            my_data_source_seek(&voice->source, voice->cursor);
+            voice->synthesising = true;
+        }
+
+        ma_uint64 frames = 0;
+        my_data_source_read(&voice->source, (out != NULL) ? out + done * 2 : NULL, frameCount - done, &frames);
+        voice->cursor += frames;
+        done          += frames;
+    }
+
+    if (pFramesRead != NULL) {
+        *pFramesRead = done;
+    }
+
+    return (done == 0) ? MA_AT_END : MA_SUCCESS;
+}
+
+static ma_result cached_voice_seek(ma_data_source* pDataSource, ma_uint64 frameIndex)
+{
+    cached_voice* voice = (cached_voice*)pDataSource;
+
+    voice->cursor       = frameIndex;
+    voice->synthesising = false; // the synth only catches up if it's needed
+
+    return MA_SUCCESS;
+}
+
+static ma_result cached_voice_get_data_format(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap)
+{
+    cached_voice* voice = (cached_voice*)pDataSource;
+    return ma_data_source_get_data_format(&voice->source, pFormat, pChannels, pSampleRate, pChannelMap, channelMapCap);
+}
+
+static ma_result cached_voice_get_cursor(ma_data_source* pDataSource, ma_uint64* pCursor)
+{
+    cached_voice* voice = (cached_voice*)pDataSource;
+
+    *pCursor = voice->cursor;
+    return MA_SUCCESS;
+}
+
+static ma_result cached_voice_get_length(ma_data_source* pDataSource, ma_uint64* pLength)
+{
+    cached_voice* voice = (cached_voice*)pDataSource;
+    return ma_data_source_get_length_in_pcm_frames(&voice->source, pLength);
+}
+
+static ma_data_source_vtable g_cached_voice_vtable =
+{
+    cached_voice_read,
+    cached_voice_seek,
+    cached_voice_get_data_format,
+    cached_voice_get_cursor,
+    cached_voice_get_length
+};
+
+// a voice playing `cache`'s note from the start. as many voices as you like can share a cache
+ma_result cached_voice_init(cached_voice* voice, prerender_cache* cache)
+{
+    ma_result result;
+    ma_data_source_config baseConfig;
+
+    baseConfig = ma_data_source_config_init();
+    baseConfig.vtable = &g_cached_voice_vtable;
+
+    result = ma_data_source_init(&baseConfig, &voice->base);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    result = my_data_source_init(&voice->source, cache->frequency, cache->length);
+    if (result != MA_SUCCESS) {
+        ma_data_source_uninit(&voice->base);
+        return result;
+    }
+
+    voice->cache        = cache;
+    voice->cursor       = 0;
+    voice->synthesising = true;
+
+    return MA_SUCCESS;
+}
+
+void cached_voice_uninit(cached_voice* voice)
+{
+    my_data_source_uninit(&voice->source);
+    ma_data_source_uninit(&voice->base);
+}
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include <math.h>
+
+// frames synthesised at a time, anything working a block at a time keeps scratch buffers this long
+#define SYNTH_BLOCK 256
+
+// ------------------------------------------------------------
+// oscillator - the phase is kept in cycles, [0, 1)
+
+struct oscillator {
+    double phase;
+    double increment; // cycles per sample
+};
+
+static void oscillator_init(oscillator* osc, float frequency, float sampleRate) {
+    osc->phase     = 0.0;
+    osc->increment = frequency / sampleRate;
+}
+
+static void oscillator_set_frequency(oscillator* osc, float frequency, float sampleRate) {
+    osc->increment = frequency / sampleRate;
+}
+
+// sin(2 * pi * phase) for a phase in [0, 1). folded onto a quarter cycle & evaluated as a polynomial with no
+// branches or tables, so a loop over it vectorises. good to about 4e-6 - plenty for 16 bit output
+static inline float sine_cycles(float phase) {
+    float x = phase - 0.5f;                                            // [-0.5, 0.5), sin of this is -sin(2 pi phase)
+    x = copysignf(0.25f - fabsf(0.25f - fabsf(x)), x);                 // [-0.25, 0.25], mirrored about +-0.25
+    x *= 2.0f * 3.14159265f;                                           // [-pi/2, pi/2]
+
+    float x2 = x * x;
+    float p  = x * (1.0f + x2 * (-1.0f/6.0f + x2 * (1.0f/120.0f + x2 * (-1.0f/5040.0f + x2 * (1.0f/362880.0f)))));
+    return -p;
+}
+
+// fill `out` with `frames` samples & advance. the phase of every sample is worked out from the start of the block
+// rather than carried from the last one, so there's no dependency between iterations
+static void oscillator_process(oscillator* osc, float* __restrict out, int frames) {
+    float start     = (float)osc->phase;
+    float increment = (float)osc->increment;
+
+    for (int i = 0; i < frames; i++) {
+        float phase = start + increment * i;
+        phase -= (float)(int)phase; // phase is never negative, truncating is a floor
+        out[i] = sine_cycles(phase);
+    }
+
+    osc->phase = fmod(osc->phase + osc->increment * frames, 1.0);
+}
+
+// ------------------------------------------------------------
+// envelope - attack, decay & release are straight lines, the envelope only makes a decision when one ends
+
+enum envelope_stage {
+    ENVELOPE_IDLE,
+    ENVELOPE_ATTACK,
+    ENVELOPE_DECAY,
+    ENVELOPE_SUSTAIN,
+    ENVELOPE_RELEASE
+};
+
+struct envelope_config {
+    float attack;  // seconds
+    float decay;   // seconds
+    float sustain; // level, 0.0 to 1.0
+    float release; // seconds
+    float length;  // seconds from the trigger until the release starts, 0.0 holds the sustain until envelope_release()
+};
+
+struct envelope {
+    envelope_config config;
+    float sampleRate;
+
+    envelope_stage stage;
+    float level;
+    float increment;     // per sample across the current stage
+    long long remaining; // samples left in the current stage, -1 for as long as it takes
+    long long held;      // samples since the trigger, for `length`
+};
+
+// head for `target` over `seconds`
+static void envelope_ramp(envelope* env, envelope_stage stage, float target, float seconds) {
+    long long samples = (long long)(seconds * env->sampleRate);
+    if (samples < 1) samples = 1;
+
+    env->stage     = stage;
+    env->remaining = samples;
+    env->increment = (target - env->level) / samples;
+}
+
+static void envelope_init(envelope* env, float sampleRate) {
+    env->sampleRate = sampleRate;
+    env->stage      = ENVELOPE_IDLE;
+    env->level      = 0.0f;
+    env->increment  = 0.0f;
+    env->remaining  = -1;
+    env->held       = 0;
+}
+
+// start from wherever the envelope currently is, so retriggering a sounding voice doesn't click
+static void envelope_trigger(envelope* env, const envelope_config* config) {
+    env->config = *config;
+    env->held   = 0;
+    envelope_ramp(env, ENVELOPE_ATTACK, 1.0f, config->attack);
+}
+
+static void envelope_release(envelope* env) {
+    if (env->stage == ENVELOPE_IDLE || env->stage == ENVELOPE_RELEASE) return;
+    envelope_ramp(env, ENVELOPE_RELEASE, 0.0f, env->config.release);
+}
+
+static bool envelope_is_idle(const envelope* env) {
+    return env->stage == ENVELOPE_IDLE;
+}
+
+// the current stage ran out, move on to the next one
+static void envelope_advance(envelope* env) {
+    switch (env->stage) {
+        case ENVELOPE_ATTACK:
+            env->level = 1.0f;
+            envelope_ramp(env, ENVELOPE_DECAY, env->config.sustain, env->config.decay);
+            break;
+        case ENVELOPE_DECAY:
+            env->level     = env->config.sustain;
+            env->stage     = ENVELOPE_SUSTAIN;
+            env->increment = 0.0f;
+            env->remaining = -1;
+            if (env->config.length > 0.0f) {
+                long long end  = (long long)(env->config.length * env->sampleRate);
+                env->remaining = (end > env->held) ? end - env->held : 0;
+            }
+            break;
+        case ENVELOPE_SUSTAIN:
+            envelope_ramp(env, ENVELOPE_RELEASE, 0.0f, env->config.release);
+            break;
+        default:
+            env->level     = 0.0f;
+            env->stage     = ENVELOPE_IDLE;
+            env->increment = 0.0f;
+            env->remaining = -1;
+            break;
+    }
+}
+
+// fill `out` with `frames` levels. each stage is a ramp written in one vectorisable loop
+static void envelope_process(envelope* env, float* __restrict out, int frames) {
+    int done = 0;
+    while (done < frames) {
+        int run = frames - done;
+        if (env->remaining >= 0 && env->remaining < run) run = (int)env->remaining;
+
+        float level     = env->level;
+        float increment = env->increment;
+        for (int i = 0; i < run; i++) out[done + i] = level + increment * i;
+
+        env->level += increment * run;
+        env->held  += run;
+        done       += run;
+        if (env->remaining >= 0) {
+            env->remaining -= run;
+            if (env->remaining == 0) envelope_advance(env);
+        }
+    }
+}
+
+// move on `frames` samples without writing them anywhere, the same as envelope_process() but a stage at a time
+static void envelope_skip(envelope* env, long long frames) {
+    while (frames > 0 && env->stage != ENVELOPE_IDLE) {
+        long long run = frames;
+        if (env->remaining >= 0 && env->remaining < run) run = env->remaining;
+
+        env->level += env->increment * run;
+        env->held  += run;
+        frames     -= run;
+        if (env->remaining >= 0) {
+            env->remaining -= run;
+            if (env->remaining == 0) envelope_advance(env);
+        }
+    }
+}
+
+// samples from the trigger until `config` goes idle, or -1 if it holds its sustain until envelope_release()
+static long long envelope_frames(const envelope_config* config, float sampleRate) {
+    envelope env;
+    envelope_init(&env, sampleRate);
+    envelope_trigger(&env, config);
+
+    long long frames = 0;
+    while (env.stage != ENVELOPE_IDLE) {
+        if (env.remaining < 0) return -1;
+        if (env.remaining == 0) {
+            envelope_advance(&env); // a sustain that was already over by the end of the decay
+            continue;
+        }
+        frames += env.remaining;
+        envelope_skip(&env, env.remaining);
+    }
+    return frames;
+}
+
+#endif
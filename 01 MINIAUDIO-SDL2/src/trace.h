@@ -0,0 +1,79 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <atomic>
+
+// debug logging the audio thread can afford: trace() copies a pointer & a number into a ring and never blocks,
+// allocates or prints. the main loop prints whatever has piled up with trace_flush(). define NO_TRACE to compile
+// every trace() away
+//
+// any number of threads can trace at once (the game thread, the audio thread, a prerender worker): each claims a
+// slot by moving `write` on with a compare & swap, and marks it filled through the slot's own sequence number, so the
+// flush only ever prints slots that are finished and a slow writer can't have its slot taken by a faster one
+
+#ifndef TRACE_CAPACITY
+    #define TRACE_CAPACITY 4096 // must be a power of two, events past this are dropped until the next flush
+#endif
+
+struct trace_event {
+    std::atomic<unsigned int> sequence; // its index when free to write, its index + 1 once written
+    const char* message;                // has to outlive the flush, so string literals only
+    double value;
+};
+
+struct trace_buffer {
+    trace_event events[TRACE_CAPACITY];
+    std::atomic<unsigned int> write;
+    std::atomic<unsigned int> read;
+    std::atomic<unsigned int> dropped;
+
+    trace_buffer() : write(0), read(0), dropped(0) {
+        for (unsigned int i = 0; i < TRACE_CAPACITY; i++) events[i].sequence.store(i, std::memory_order_relaxed);
+    }
+};
+
+static trace_buffer g_trace;
+
+// any thread
+static inline void trace(const char* message, double value = 0.0) {
+    #ifndef NO_TRACE
+        unsigned int write = g_trace.write.load(std::memory_order_relaxed);
+        for (;;) {
+            trace_event& e    = g_trace.events[write & (TRACE_CAPACITY - 1)];
+            int ahead         = (int)(e.sequence.load(std::memory_order_acquire) - write);
+            if (ahead < 0) {
+                // still holding an event from a lap ago, the flush hasn't got to it
+                g_trace.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (ahead > 0) {
+                write = g_trace.write.load(std::memory_order_relaxed); // another thread took it, try the next
+                continue;
+            }
+            if (g_trace.write.compare_exchange_weak(write, write + 1, std::memory_order_relaxed)) {
+                e.message = message;
+                e.value   = value;
+                e.sequence.store(write + 1, std::memory_order_release);
+                return;
+            }
+        }
+    #endif
+}
+
+// any one thread. stops at the first slot still being written, the rest wait for the next flush
+static void trace_flush(FILE* out = stdout) {
+    unsigned int read = g_trace.read.load(std::memory_order_relaxed);
+    for (;; read++) {
+        trace_event& e = g_trace.events[read & (TRACE_CAPACITY - 1)];
+        if (e.sequence.load(std::memory_order_acquire) != read + 1) break;
+        fprintf(out, "%s %g\n", e.message, e.value);
+        e.sequence.store(read + TRACE_CAPACITY, std::memory_order_release);
+    }
+    g_trace.read.store(read, std::memory_order_relaxed);
+
+    unsigned int dropped = g_trace.dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) fprintf(out, "trace dropped %u events\n", dropped);
+}
+
+#endif
@@ -25,11 +25,16 @@ flexibility within openFrameworks and shouldn't be discounted.
 
 #define MA_NO_SDL
 
+// #define CALLBACK_TIMING // time every callback, the counts are drawn in the corner
+#include "callback_timer.h" // from ../common, see config.make
+
 static ma_engine engine;
 static ma_engine_config engineConfig;
 
 static ma_sound sound;
 
+static callback_timer timing;
+
 unsigned short lineCount = 0;
 unsigned short lineFidelity = 8;
 float lineArr[8] = {
@@ -38,7 +43,9 @@ float lineArr[8] = {
 
 void engine_data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
 {
+	ma_uint64 start = callback_timer_begin();
     ma_engine_read_pcm_frames(&engine, pOutput, frameCount, NULL);
+	callback_timer_end(&timing, start, frameCount);
 	lineArr[lineCount] = *(float*)pOutput;
 	lineCount = (lineCount + 1) % lineFidelity;
 }
@@ -47,12 +54,16 @@ void engine_data_callback(ma_device* pDevice, void* pOutput, const void* pInput,
 void ofApp::setup(){
 	engineConfig = ma_engine_config_init();
 	engineConfig.dataCallback = engine_data_callback;
+	engineConfig.noAutoStart = MA_TRUE; // the timer needs the device's sample rate before the first callback
 
 	ma_result result = ma_engine_init(&engineConfig, &engine);
 	if (result != MA_SUCCESS) {
 		printf("Failed to initialise engine.\n");
 	}
 
+	callback_timer_init(&timing, ma_engine_get_sample_rate(&engine));
+	ma_engine_start(&engine);
+
 	result = ma_sound_init_from_file(&engine, ofToDataPath("chirp.wav", true).c_str(), 0, NULL, NULL, &sound);
 	if (result != MA_SUCCESS) {
 		printf("Failed to initialise sound.\n");
@@ -76,6 +87,13 @@ void ofApp::draw(){
 		}
 		ofVertex(ofGetWidth(), ofGetHeight() / 2);
 	ofEndShape();
+
+#ifdef CALLBACK_TIMING
+	callback_timer_stats stats = callback_timer_get(&timing);
+	ofDrawBitmapString("callbacks " + ofToString(stats.callbacks) + ", underruns " + ofToString(stats.underruns), 10, 20);
+	ofDrawBitmapString("mean " + ofToString(stats.mean_us, 0) + " us, p99 < " + ofToString(callback_timer_percentile(&stats, 0.99), 0) + " us, worst " + ofToString(stats.worst_us, 0) + " us", 10, 36);
+	ofDrawBitmapString("load " + ofToString(100.0f * stats.last_load, 0) + "%, worst " + ofToString(100.0f * stats.worst_load, 0) + "%", 10, 52);
+#endif
 }
 
 //--------------------------------------------------------------
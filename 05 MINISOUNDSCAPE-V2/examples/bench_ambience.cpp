@@ -0,0 +1,82 @@
+// renders each procedural ambience for a while, the way a device would pull it, and reports how much of a core it
+// takes along with how big it is next to the minute of 16 bit stereo wav it stands in for. the level is printed
+// too so a silent or runaway generator stands out. then the same for a granular bed at a few grain counts, made from
+// a 10 s crop of a garden recording
+//
+//     make bench_ambience
+//     ./bin/bench_ambience 60 garden.wav   // seconds rendered per generator, clip for the granular bed
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define BLOCK 512
+
+struct bench_case {
+    const char* name;
+    ms_ambience_type type;
+};
+
+// render `source` for `blocks` blocks, returning the seconds it took & adding up its power
+static double run(ma_data_source* source, ma_uint64 blocks, vector<float>& out, double* power) {
+    double elapsed = 0.0;
+    *power = 0.0;
+    for (ma_uint64 b = 0; b < blocks; b++) {
+        auto start = chrono::steady_clock::now();
+        ma_data_source_read_pcm_frames(source, out.data(), BLOCK, NULL);
+        elapsed += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        for (float x : out) *power += x * x;
+    }
+    return elapsed;
+}
+
+int main(int argc, char** argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 60.0;
+    string clip    = (argc > 2) ? argv[2] : "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/jardins3.wav";
+
+    const bench_case cases[] = {
+        { "rain",    MS_AMBIENCE_RAIN    },
+        { "wind",    MS_AMBIENCE_WIND    },
+        { "insects", MS_AMBIENCE_INSECTS },
+    };
+
+    printf("%.0f s of each at %d Hz, a minute of 16 bit stereo wav is %d kB\n", seconds, MS_SAMPLE_RATE, MS_SAMPLE_RATE * 60 * 4 / 1024);
+    printf("%-8s | %10s | %10s | %8s | %6s\n", "", "ns/frame", "% of core", "bytes", "rms");
+
+    vector<float> out(BLOCK * 2);
+    ma_uint64 blocks = (ma_uint64)(seconds * MS_SAMPLE_RATE / BLOCK);
+    double frames    = (double)blocks * BLOCK;
+    for (const bench_case& c : cases) {
+        ms_ambience ambience;
+        ms_ambience_init(&ambience, c.type);
+
+        double power;
+        double elapsed = run(&ambience, blocks, out, &power);
+        printf("%-8s | %10.2f | %9.3f%% | %8zu | %6.3f\n", c.name, 1e9 * elapsed / frames, 100.0 * elapsed / (frames / MS_SAMPLE_RATE), sizeof(ms_ambience), sqrt(power / (frames * 2)));
+
+        ms_ambience_uninit(&ambience);
+    }
+
+    for (ma_uint32 streams : { 8, 16, 32 }) {
+        ms_granular granular;
+        if (ms_granular_init(&granular, clip, streams, 1, 0.0f, 10.0f) != MA_SUCCESS) {
+            printf("couldn't load %s\n", clip.c_str());
+            break;
+        }
+
+        double power;
+        double elapsed = run(&granular, blocks, out, &power);
+        string name    = "grains " + to_string(streams);
+        size_t bytes   = sizeof(ms_granular) + granular.clipFrames * sizeof(float);
+        printf("%-9s| %10.2f | %9.3f%% | %8zu | %6.3f\n", name.c_str(), 1e9 * elapsed / frames, 100.0 * elapsed / (frames / MS_SAMPLE_RATE), bytes, sqrt(power / (frames * 2)));
+
+        ms_granular_uninit(&granular);
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+// renders the same crowd of voices with miniaudio's per-voice spatializer and through ambisonic buses, with the
+// listener turning all the while, and reports how long a block takes on average (the best of three runs). the
+// "unpanned" column plays the voices without any spatialization, anything above it is the cost of panning
+//
+//     make bench
+//     ./bin/bench_ambisonics 2048 20   // voices, seconds rendered per case
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define BLOCK 512
+
+struct bench_case {
+    const char* name;
+    bool spatialized;
+    bool ambisonic;
+    ma_uint32 order;
+    ms_ambisonic_decoder decoder;
+    ma_uint32 channels;
+};
+
+// an octagon for the speaker cases, anticlockwise from ahead
+static const float octagon[8] = { 0.0f, 45.0f, 90.0f, 135.0f, 180.0f, -135.0f, -90.0f, -45.0f };
+
+// --- voices are sine waves on a ring around the listener, so every one is heard from a different direction
+static double run(const bench_case& c, ma_uint32 voiceAmount, double seconds) {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = c.channels;
+    config.sampleRate = MS_SAMPLE_RATE;
+    ma_engine engine;
+    ma_engine_init(&config, &engine);
+
+    ms_ambisonic_bus bus;
+    if (c.ambisonic) ms_ambisonic_bus_init(&bus, &engine, c.order, c.decoder, octagon);
+
+    vector<ma_waveform> waves(voiceAmount);
+    vector<ma_sound> voices(voiceAmount);
+    vector<ms_ambisonic_voice> handles(voiceAmount);
+    for (ma_uint32 i = 0; i < voiceAmount; i++) {
+        ma_waveform_config wave = ma_waveform_config_init(ma_format_f32, 1, MS_SAMPLE_RATE, ma_waveform_type_sine, 0.5 / voiceAmount, 110.0 + i);
+        ma_waveform_init(&wave, &waves[i]);
+        ma_sound_init_from_data_source(&engine, &waves[i], (c.spatialized && !c.ambisonic) ? 0 : MA_SOUND_FLAG_NO_SPATIALIZATION, NULL, &voices[i]);
+
+        float angle = 2.0f * MS_PI * i / voiceAmount;
+        ma_sound_set_position(&voices[i], 8.0f * cosf(angle), 0.0f, 8.0f * sinf(angle));
+        if (c.ambisonic) ms_ambisonic_bus_add_voice(&bus, &voices[i], &handles[i]);
+        ma_sound_start(&voices[i]);
+    }
+
+    vector<float> out(BLOCK * c.channels);
+    ma_uint64 blocks = (ma_uint64)(seconds * MS_SAMPLE_RATE / BLOCK);
+    double total = 0.0;
+    for (ma_uint64 b = 0; b < blocks; b++) {
+        float yaw = 0.01f * b;
+        ma_engine_listener_set_direction(&engine, 0, -sinf(yaw), 0.0f, -cosf(yaw));
+
+        auto start = chrono::steady_clock::now();
+        ma_engine_read_pcm_frames(&engine, out.data(), BLOCK, NULL);
+        total += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    for (ma_uint32 i = 0; i < voiceAmount; i++) {
+        ma_sound_uninit(&voices[i]);
+        if (c.ambisonic) ms_ambisonic_bus_remove_voice(&bus, &handles[i]);
+        ma_waveform_uninit(&waves[i]);
+    }
+    if (c.ambisonic) ms_ambisonic_bus_uninit(&bus);
+    ma_engine_uninit(&engine);
+
+    return total / blocks;
+}
+
+int main(int argc, char** argv) {
+    ma_uint32 maxVoices = (argc > 1) ? (ma_uint32)atoi(argv[1]) : 1024;
+    double seconds      = (argc > 2) ? atof(argv[2]) : 10.0;
+
+    const bench_case cases[] = {
+        { "unpanned -> stereo",    false, false, 0, MS_AMBISONIC_STEREO,   2 },
+        { "spatializer -> stereo", true,  false, 0, MS_AMBISONIC_STEREO,   2 },
+        { "foa -> stereo",         true,  true,  1, MS_AMBISONIC_STEREO,   2 },
+        { "toa -> stereo",         true,  true,  3, MS_AMBISONIC_STEREO,   2 },
+        { "toa -> binaural",       true,  true,  3, MS_AMBISONIC_BINAURAL, 2 },
+        { "unpanned -> 8",         false, false, 0, MS_AMBISONIC_SPEAKERS, 8 },
+        { "spatializer -> 8",      true,  false, 0, MS_AMBISONIC_SPEAKERS, 8 },
+        { "foa -> 8",              true,  true,  1, MS_AMBISONIC_SPEAKERS, 8 },
+        { "toa -> 8",              true,  true,  3, MS_AMBISONIC_SPEAKERS, 8 },
+    };
+
+    double budget = 1000.0 * BLOCK / MS_SAMPLE_RATE;
+    cout << "ms per " << BLOCK << " frame block (" << budget << " ms of audio)" << endl;
+    cout << "voices";
+    for (const bench_case& c : cases) cout << " | " << c.name;
+    cout << endl;
+
+    for (ma_uint32 voices = 16; voices <= maxVoices; voices *= 4) {
+        cout << voices;
+        for (const bench_case& c : cases) {
+            double best = run(c, voices, seconds);
+            for (int i = 0; i < 2; i++) best = min(best, run(c, voices, seconds));
+            cout << " | " << best;
+        }
+        cout << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+// times every ma_engine_read_pcm_frames() call under synthetic workloads - V looping sounds dealt out between N
+// soundscapes, with spatialization, pitch & streaming from disk each switched on & off - and writes the mean, median,
+// p99, p99.9 and worst block of every run as json. the first voice count whose p99.9 goes over the budget is reported
+// per workload, which is where a callback of that length starts dropping out. each sound plays one file, opened by
+// the resource manager as a stream or decoded whole & handed to ms_sound_init_from_data_source()
+//
+//     make bench_engine
+//     ./bin/bench_engine                                        // every workload at 16 to 1024 voices
+//     ./bin/bench_engine --voices 64,256 --seconds 30 --out a.json
+//     ./bin/bench_engine --direct                               // read straight from this thread, as fast as it goes
+//
+// by default a device on the null backend pulls from the engine in real time, from its own thread, as a sound card
+// would. options: --soundscapes N, --voices V[,V...], --seconds S (of audio per run), --budget MS, --block FRAMES,
+// --direct, --out FILE
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+static const char* files[] = { "jardins0.wav", "jardins1.wav", "jardins2.wav", "jardins3.wav", "bird0.wav", "multi0.wav", "multi1.wav", "multi2.wav" };
+
+struct workload {
+    const char* name;
+    bool spatialization;
+    bool pitch;
+    bool streaming;
+};
+
+struct bench_options {
+    ma_uint32 soundscapes = 4;
+    vector<ma_uint32> voices = { 16, 32, 64, 128, 256, 512, 1024 };
+    double seconds  = 20.0;
+    double budget   = 10.0; // ms
+    ma_uint32 block = 512;
+    bool null       = true; // false reads directly
+    string out;
+};
+
+struct bench_result {
+    ma_uint32 voices; // that actually started, streams can run out of file handles
+    vector<double> blocks; // microseconds per read
+};
+
+// --- the null backend's device thread pulls from the engine here, timing each read into a buffer made big enough
+// beforehand. only `count` is shared: the main thread reads it to know when to stop, and the timings once the device
+// is uninitialised
+struct device_timer {
+    ma_engine* engine;
+    double* blocks;
+    ma_uint64 target;
+    std::atomic<ma_uint64> count;
+};
+
+static void on_device_data(ma_device* device, void* pOutput, const void*, ma_uint32 frameCount) {
+    device_timer* timer = (device_timer*)device->pUserData;
+    ma_uint64 count = timer->count.load(std::memory_order_relaxed);
+    if (count >= timer->target) return;
+
+    auto start = chrono::steady_clock::now();
+    ma_engine_read_pcm_frames(timer->engine, pOutput, frameCount, NULL);
+    timer->blocks[count] = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    timer->count.store(count + 1, std::memory_order_release);
+}
+
+static bench_result run(const bench_options& options, const workload& w, ma_uint32 voiceAmount) {
+    bench_result result;
+    result.voices = 0;
+
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    ma_engine_init(&config, &engine);
+
+    // --- N soundscapes, the voices dealt out between them, each a sound of its own over one file
+    srand(1);
+    vector<ms_soundscape> soundscapes(options.soundscapes);
+    for (ma_uint32 n = 0; n < options.soundscapes; n++) {
+        ms_soundscape_init("soundscape " + to_string(n), &engine, SOUNDBITES "jardins3.wav", &soundscapes[n]);
+        ms_soundscape_set_tickrate(&soundscapes[n], 1e9f); // the voices below play throughout, nothing new is started
+        ma_sound_set_volume(soundscapes[n].ambient, 0.1f);
+        ms_soundscape_start(&soundscapes[n]);
+    }
+
+    vector<ma_resource_manager_data_source> sources(voiceAmount);
+    vector<bool> opened(voiceAmount, false);
+    vector<ms_sound> sounds(voiceAmount);
+    ma_uint32 sourceFlags = w.streaming ? MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_STREAM : MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE;
+    for (ma_uint32 v = 0; v < voiceAmount; v++) {
+        ms_sound* sound = &sounds[v];
+        string path     = string(SOUNDBITES) + files[v % 8];
+        ma_data_source* source = &sources[v];
+        // streams can run out of file handles, the sound is left without variants then & never plays
+        opened[v] = ma_resource_manager_data_source_init(ma_engine_get_resource_manager(&engine), path.c_str(), sourceFlags, NULL, &sources[v]) == MA_SUCCESS;
+        if (opened[v]) {
+            ma_data_source_set_looping(source, MA_TRUE);
+            ma_data_source_seek_to_pcm_frame(source, rand() % MS_SAMPLE_RATE); // so the voices don't line up
+        }
+        ms_sound_init_from_data_source("sound " + to_string(v), &engine, 1, &source, opened[v] ? 1 : 0, sound, w.spatialization, w.pitch);
+
+        ms_sound_set_volume(sound, 0.02f);
+        if (w.pitch) ms_sound_set_pitch(sound, 0.8f + 0.4f * (rand() % 100) / 100.0f);
+        if (w.spatialization) {
+            float angle = 2.0f * MS_PI * (rand() % 360) / 360.0f;
+            float distance = 1.0f + (rand() % 40);
+            ms_sound_set_position(sound, distance * sinf(angle), 0.0f, distance * cosf(angle));
+        }
+        if (!opened[v]) continue;
+        ms_soundscape_add_sound(&soundscapes[v % options.soundscapes], sound);
+        if (ms_sound_start(sound) == MA_SUCCESS && ms_sound_is_playing(sound)) result.voices++;
+    }
+
+    // --- time every block, ticking the soundscapes between them like a game loop would
+    ma_uint64 blockAmount = (ma_uint64)(options.seconds * MS_SAMPLE_RATE / options.block);
+    result.blocks.reserve(blockAmount);
+    if (options.null) {
+        device_timer timer;
+        timer.engine = &engine;
+        timer.target = blockAmount;
+        timer.count.store(0);
+        result.blocks.resize(blockAmount);
+        timer.blocks = result.blocks.data();
+
+        ma_backend backends[] = { ma_backend_null };
+        ma_context context;
+        ma_context_init(backends, 1, NULL, &context);
+
+        ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+        deviceConfig.playback.format      = ma_format_f32;
+        deviceConfig.playback.channels    = 2;
+        deviceConfig.sampleRate           = MS_SAMPLE_RATE;
+        deviceConfig.periodSizeInFrames   = options.block;
+        deviceConfig.dataCallback         = on_device_data;
+        deviceConfig.pUserData            = &timer;
+
+        ma_device device;
+        ma_device_init(&context, &deviceConfig, &device);
+        ma_device_start(&device);
+        while (timer.count.load(std::memory_order_acquire) < blockAmount) {
+            for (ms_soundscape& s : soundscapes) ms_soundscape_tick(&s);
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        ma_device_uninit(&device); // joins the device thread, the timings are all ours from here
+        ma_context_uninit(&context);
+        result.blocks.resize(timer.count.load(std::memory_order_acquire));
+    } else {
+        vector<float> out(options.block * 2);
+        for (ma_uint64 b = 0; b < blockAmount; b++) {
+            for (ms_soundscape& s : soundscapes) ms_soundscape_tick(&s);
+
+            auto start = chrono::steady_clock::now();
+            ma_engine_read_pcm_frames(&engine, out.data(), options.block, NULL);
+            result.blocks.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    // --- the sounds go before the data sources they read
+    for (ms_soundscape& s : soundscapes) ms_soundscape_uninit(&s);
+    for (ms_sound& sound : sounds) ms_sound_uninit(&sound);
+    for (ma_uint32 v = 0; v < voiceAmount; v++) {
+        if (opened[v]) ma_resource_manager_data_source_uninit(&sources[v]);
+    }
+    ma_engine_uninit(&engine);
+
+    return result;
+}
+
+static double percentile(const vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t i = (size_t)ceil(q * sorted.size());
+    return sorted[(i == 0) ? 0 : min(i - 1, sorted.size() - 1)];
+}
+
+static vector<ma_uint32> parse_list(const string& list) {
+    vector<ma_uint32> values;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == string::npos) end = list.size();
+        if (end > start) values.push_back((ma_uint32)atoi(list.substr(start, end - start).c_str()));
+        start = end + 1;
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    bench_options options;
+    for (int i = 1; i < argc; i++) {
+        string arg  = argv[i];
+        bool value  = i + 1 < argc;
+        if      (arg == "--soundscapes" && value) options.soundscapes = (ma_uint32)atoi(argv[++i]);
+        else if (arg == "--voices" && value)      options.voices      = parse_list(argv[++i]);
+        else if (arg == "--seconds" && value)     options.seconds     = atof(argv[++i]);
+        else if (arg == "--budget" && value)      options.budget      = atof(argv[++i]);
+        else if (arg == "--block" && value)       options.block       = (ma_uint32)atoi(argv[++i]);
+        else if (arg == "--out" && value)         options.out         = argv[++i];
+        else if (arg == "--direct")               options.null        = false;
+        else {
+            fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (options.soundscapes == 0 || options.block == 0) {
+        fprintf(stderr, "soundscapes & block need to be above 0\n");
+        return -1;
+    }
+
+    const workload workloads[] = {
+        { "plain",          false, false, false },
+        { "spatialized",    true,  false, false },
+        { "pitched",        false, true,  false },
+        { "streamed",       false, false, true  },
+        { "everything",     true,  true,  true  },
+    };
+
+    string json = "{\n";
+    json += "  \"build\": { \"compiler\": \"" __VERSION__ "\", \"features\": [";
+    const char* features[] = {
+        #ifdef MS_HAS_LOD
+            "\"lod\"",
+        #endif
+        #ifdef MS_HAS_OCCLUSION
+            "\"occlusion\"",
+        #endif
+        #ifdef MS_HAS_AMBISONICS
+            "\"ambisonics\"",
+        #endif
+        #ifdef MS_HAS_SPEAKER_ARRAY
+            "\"speaker_array\"",
+        #endif
+        #ifdef MS_HAS_AMBIENCE
+            "\"ambience\"",
+        #endif
+        nullptr
+    };
+    for (int i = 0; features[i] != nullptr; i++) json += string(i ? ", " : "") + features[i];
+    json += "] },\n";
+
+    char line[512];
+    snprintf(line, sizeof(line), "  \"config\": { \"soundscapes\": %u, \"seconds\": %g, \"block\": %u, \"sample_rate\": %d, \"budget_ms\": %g, \"driver\": \"%s\" },\n",
+        options.soundscapes, options.seconds, options.block, MS_SAMPLE_RATE, options.budget, options.null ? "null" : "direct");
+    json += line;
+    json += "  \"runs\": [\n";
+
+    string breaking = "  \"breaking_point\": {";
+    bool firstRun = true;
+    for (const workload& w : workloads) {
+        long long broke = -1;
+        for (ma_uint32 voices : options.voices) {
+            bench_result r = run(options, w, voices);
+            vector<double> sorted = r.blocks;
+            sort(sorted.begin(), sorted.end());
+
+            double mean = 0.0;
+            for (double t : sorted) mean += t;
+            mean /= sorted.empty() ? 1 : sorted.size();
+
+            size_t over = 0;
+            for (double t : sorted) over += t > options.budget * 1000.0;
+            double p999 = percentile(sorted, 0.999);
+            if (broke < 0 && p999 > options.budget * 1000.0) broke = r.voices;
+
+            snprintf(line, sizeof(line), "    { \"workload\": \"%s\", \"voices\": %u, \"blocks\": %zu, \"mean_us\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f, \"worst_us\": %.1f, \"over_budget\": %zu }",
+                w.name, r.voices, sorted.size(), mean, percentile(sorted, 0.5), percentile(sorted, 0.99), p999, sorted.empty() ? 0.0 : sorted.back(), over);
+            json += string(firstRun ? "" : ",\n") + line;
+            firstRun = false;
+
+            fprintf(stderr, "%-12s %5u voices | mean %8.1f us | p50 %8.1f | p99 %8.1f | p99.9 %8.1f | worst %8.1f\n", w.name, r.voices, mean, percentile(sorted, 0.5), percentile(sorted, 0.99), p999, sorted.empty() ? 0.0 : sorted.back());
+        }
+        breaking += string(&w == workloads ? " " : ", ") + "\"" + w.name + "\": " + (broke < 0 ? "null" : to_string(broke));
+    }
+    json += "\n  ],\n" + breaking + " }\n}\n";
+
+    if (options.out.empty()) {
+        fputs(json.c_str(), stdout);
+    } else {
+        FILE* f = fopen(options.out.c_str(), "w");
+        if (f == NULL) {
+            fprintf(stderr, "couldn't write %s\n", options.out.c_str());
+            return -1;
+        }
+        fputs(json.c_str(), f);
+        fclose(f);
+    }
+
+    return 0;
+}
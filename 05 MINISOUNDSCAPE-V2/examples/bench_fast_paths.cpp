@@ -0,0 +1,97 @@
+// times the engine mixing a typical spread of soundscapes: garden soundbites that are neither pitched nor placed,
+// repitched ones, and thunder placed off to the side. built twice by the makefile, once as is & once with
+// MS_NO_FAST_PATHS, so the two show what skipping the resampler & spatializer of the sounds that don't need them saves.
+// both make the same choices from the same seed
+//
+//     make bench_fast_paths
+//     ./bin/bench_fast_paths & ./bin/bench_fast_paths_off     // 32 soundscapes, 60 seconds
+//     ./bin/bench_fast_paths 128 30
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+int main(int argc, char** argv) {
+    ma_uint32 amount = (argc > 1) ? (ma_uint32)atoi(argv[1]) : 32;
+    double seconds   = (argc > 2) ? atof(argv[2]) : 60.0;
+    if (amount == 0 || seconds <= 0.0) {
+        printf("usage: bench_fast_paths [soundscapes] [seconds]\n");
+        return -1;
+    }
+
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    ms_seed(1);
+    vector<ms_soundscape> scapes(amount);
+    vector<ms_sound*> sounds;
+    for (ma_uint32 n = 0; n < amount; n++) {
+        ms_sound* jardins = new ms_sound;
+        ms_sound* bird    = new ms_sound;
+        ms_sound* multi   = new ms_sound;
+        ms_sound* thunder = new ms_sound;
+        ms_sound_init("jardins", &engine, 3, SOUNDBITES "jardins", jardins);
+        ms_sound_init("bird", &engine, 2, SOUNDBITES "bird", bird);
+        ms_sound_init("multi", &engine, 2, SOUNDBITES "multi", multi);
+        ms_sound_init("thunder", &engine, 1, SOUNDBITES "thunder", thunder);
+        sounds.insert(sounds.end(), { jardins, bird, multi, thunder });
+        ms_sound_set_volume(jardins, 0.1f, 0.3f);
+        ms_sound_set_pan(bird, -0.8f, 0.8f);
+        ms_sound_set_pitch(multi, 0.8f, 1.2f);
+        #ifndef MS_NO_SPATIALIZATION
+            ms_sound_set_position(thunder, 10.0f, 0.0f, -5.0f);
+        #endif
+
+        if (ms_soundscape_init("garden " + to_string(n), &engine, SOUNDBITES "jardins3.wav", &scapes[n], 4, jardins, bird, multi, thunder) != MA_SUCCESS) {
+            printf("Failed to load the soundbites.\n");
+            return -1;
+        }
+        ma_sound_set_volume(scapes[n].ambient, 0.05f);
+        ms_soundscape_set_tickrate(&scapes[n], 0.05f);
+        ms_soundscape_start(&scapes[n]);
+    }
+
+    const ma_uint32 block = 512;
+    vector<float> out(block * 2);
+    ma_uint64 blocks = (ma_uint64)(seconds * MS_SAMPLE_RATE / block);
+    double mixing    = 0.0;
+    ma_uint64 voices = 0;
+    for (ma_uint64 b = 0; b < blocks; b++) {
+        for (ms_soundscape& scape : scapes) ms_soundscape_tick(&scape);
+        for (const ms_sound* sound : sounds) voices += ms_sound_is_playing(sound) ? 1 : 0;
+
+        auto start = chrono::steady_clock::now();
+        ma_engine_read_pcm_frames(&engine, out.data(), block, NULL);
+        mixing += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    double busy = (double)voices / blocks;
+    #ifdef MS_HAS_FAST_PATHS
+        const char* build = "fast paths";
+    #else
+        const char* build = "MS_NO_FAST_PATHS";
+    #endif
+    printf("%-16s | %u soundscapes | %.1f voices playing | %.1f us per block | %.0f%% of a core\n",
+        build, amount, busy, 1e6 * mixing / blocks, 100.0 * mixing / (blocks * (double)block / MS_SAMPLE_RATE));
+
+    for (ms_soundscape& scape : scapes) ms_soundscape_uninit(&scape);
+    for (ms_sound* sound : sounds) {
+        ms_sound_uninit(sound);
+        delete sound;
+    }
+    ma_engine_uninit(&engine);
+    return 0;
+}
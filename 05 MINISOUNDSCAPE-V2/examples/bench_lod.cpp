@@ -0,0 +1,125 @@
+// renders the same ring of looping voices with every voice held in the near tier, then the mid tier, then the far
+// tier, and reports how long a block takes on average (the best of five runs) against the near tier. the voices
+// don't move, only the thresholds do, so each tier plays the same scene at the same distances. the time the bed
+// measured mixing the mid & far voices comes from ms_lod_stats, built with MS_PROFILE_NODES the time measured in the
+// near voices themselves as well
+//
+//     make bench_lod
+//     ./bin/bench_lod 256 10      // voices, seconds rendered per tier
+//     ./bin/bench_lod_profiled
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+struct bench_tier {
+    const char* name;
+    ms_lod_tier tier;
+    float near_distance; // thresholds that put a voice 20 m away in the tier
+    float far_distance;
+};
+
+struct tier_result {
+    double block_ms;
+    ms_lod_stats stats;
+};
+
+static tier_result run(const bench_tier& t, ma_uint32 voiceAmount, double seconds) {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+    ma_engine engine;
+    ma_engine_init(&config, &engine);
+
+    ms_soundscape scape;
+    ms_soundscape_init("ring", &engine, SOUNDBITES "jardins3.wav", &scape);
+    ma_sound_set_volume(scape.ambient, 0.0f); // silent, but left playing so it costs the same in every tier
+    ms_soundscape_set_lod(&scape, t.near_distance, t.far_distance);
+
+    const char* names[] = { "bird", "multi", "jardins" };
+    vector<ms_sound> sounds(voiceAmount);
+    for (ma_uint32 i = 0; i < voiceAmount; i++) {
+        ms_sound_init(names[i % 3], &engine, 1, SOUNDBITES + string(names[i % 3]), &sounds[i]);
+        float angle = 2.0f * MS_PI * i / voiceAmount;
+        ms_sound_set_position(&sounds[i], 20.0f * cosf(angle), 0.0f, 20.0f * sinf(angle));
+        ms_sound_set_volume(&sounds[i], 1.0f / voiceAmount);
+        for (ma_sound* voice : sounds[i].sounds) ma_sound_set_looping(voice, true);
+        ms_soundscape_add_sound(&scape, &sounds[i]);
+        ms_sound_start(&sounds[i]);
+    }
+    ma_sound_start(scape.ambient);
+
+    vector<float> out(MS_RENDER_BLOCK * 2);
+    ms_soundscape_update_lod(&scape);
+    ma_engine_read_pcm_frames(&engine, out.data(), MS_RENDER_BLOCK, NULL); // warm up, voices move tier on the first update
+    ms_soundscape_update_lod(&scape);
+    scape.lod_stats = {};
+    scape.lod_stats.last_update = ma_engine_get_time_in_pcm_frames(&engine);
+
+    ma_uint64 blocks = (ma_uint64)(seconds * MS_SAMPLE_RATE / MS_RENDER_BLOCK);
+    double total = 0.0;
+    for (ma_uint64 b = 0; b < blocks; b++) {
+        auto start = chrono::steady_clock::now();
+        ms_soundscape_update_lod(&scape);
+        ma_engine_read_pcm_frames(&engine, out.data(), MS_RENDER_BLOCK, NULL);
+        total += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+    ms_soundscape_update_lod(&scape);
+
+    tier_result result;
+    result.block_ms = total / blocks;
+    result.stats    = ms_soundscape_get_lod_stats(&scape);
+
+    ms_soundscape_uninit(&scape);
+    for (ms_sound& sound : sounds) ms_sound_uninit(&sound);
+    ma_engine_uninit(&engine);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    ma_uint32 voices = (argc > 1) ? (ma_uint32)atoi(argv[1]) : 256;
+    double seconds   = (argc > 2) ? atof(argv[2]) : 10.0;
+    if (voices == 0 || seconds <= 0.0) {
+        printf("usage: bench_lod [voices] [seconds]\n");
+        return -1;
+    }
+
+    const bench_tier tiers[] = {
+        { "near", MS_LOD_NEAR, 1000.0f, 2000.0f },
+        { "mid",  MS_LOD_MID,  1.0f,    1000.0f },
+        { "far",  MS_LOD_FAR,  1.0f,    2.0f    },
+    };
+
+    printf("%u voices, %.0f s | ms per %d frame block (%.2f ms of audio)\n", voices, seconds, MS_RENDER_BLOCK, 1000.0 * MS_RENDER_BLOCK / MS_SAMPLE_RATE);
+    // the tiers take turns, so a machine that slows down or speeds up part way through doesn't favour one of them
+    tier_result best[3];
+    for (int i = 0; i < 5; i++) {
+        for (const bench_tier& t : tiers) {
+            tier_result r = run(t, voices, seconds);
+            if (i == 0 || r.block_ms < best[t.tier].block_ms) best[t.tier] = r;
+        }
+    }
+
+    double nearMs = best[MS_LOD_NEAR].block_ms;
+    for (const bench_tier& t : tiers) {
+        const ms_lod_stats& s = best[t.tier].stats;
+        printf("%-4s | %u voices in tier | %.4f ms per block | %5.1f%% of near", t.name, s.voices[t.tier], best[t.tier].block_ms, 100.0 * best[t.tier].block_ms / nearMs);
+        #ifndef MS_PROFILE_NODES
+            if (t.tier == MS_LOD_NEAR) {
+                printf("\n");
+                continue;
+            }
+        #endif
+        double voiceSeconds = (double)s.voice_frames[t.tier] / MS_SAMPLE_RATE;
+        printf(" | %.2f us in the voices per voice-second", (voiceSeconds > 0.0) ? 1e6 * s.dsp_seconds[t.tier] / voiceSeconds : 0.0);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// mixes the same spread of soundscapes through an ms_parallel with a pool of 1 thread, then 2, and so on up to 8,
+// and reports the time per block of each against the single thread. every run is seeded alike and has to come out
+// the same to the bit, whichever thread rendered which submix. the pool only gets faster with cores to run on, the
+// number the machine has is printed first
+//
+//     make bench_parallel
+//     ./bin/bench_parallel                 // 64 soundscapes on 16 submixes, 20 seconds
+//     ./bin/bench_parallel 128 32 10
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+typedef struct {
+    double block_us;
+    ma_uint64 checksum;
+    ms_parallel_stats stats;
+} run_result;
+
+// fnv-1a over the bits of the mix, so a single flipped sample shows
+static void checksum_add(ma_uint64* hash, const float* samples, size_t count) {
+    const unsigned char* bytes = (const unsigned char*)samples;
+    for (size_t i = 0; i < count * sizeof(float); i++) {
+        *hash = (*hash ^ bytes[i]) * 1099511628211ULL;
+    }
+}
+
+static bool run(ma_uint32 threads, ma_uint32 amount, ma_uint32 submixes, double seconds, run_result* result) {
+    ms_parallel parallel;
+    if (ms_parallel_init(&parallel, threads, 2, MS_SAMPLE_RATE) != MA_SUCCESS) return false;
+
+    vector<ma_engine*> engines;
+    for (ma_uint32 m = 0; m < submixes; m++) {
+        ma_engine* engine = ms_parallel_add_submix(&parallel);
+        if (engine == nullptr) return false;
+        engines.push_back(engine);
+    }
+
+    // the garden of bench_fast_paths, dealt out over the submixes in turn
+    ms_seed(1);
+    vector<ms_soundscape> scapes(amount);
+    vector<ms_sound*> sounds;
+    for (ma_uint32 n = 0; n < amount; n++) {
+        ma_engine* engine = engines[n % submixes];
+        ms_sound* jardins = new ms_sound;
+        ms_sound* bird    = new ms_sound;
+        ms_sound* multi   = new ms_sound;
+        ms_sound* thunder = new ms_sound;
+        ms_sound_init("jardins", engine, 3, SOUNDBITES "jardins", jardins);
+        ms_sound_init("bird", engine, 2, SOUNDBITES "bird", bird);
+        ms_sound_init("multi", engine, 2, SOUNDBITES "multi", multi);
+        ms_sound_init("thunder", engine, 1, SOUNDBITES "thunder", thunder);
+        sounds.insert(sounds.end(), { jardins, bird, multi, thunder });
+        ms_sound_set_volume(jardins, 0.1f, 0.3f);
+        ms_sound_set_pan(bird, -0.8f, 0.8f);
+        ms_sound_set_pitch(multi, 0.8f, 1.2f);
+        #ifndef MS_NO_SPATIALIZATION
+            ms_sound_set_position(thunder, 10.0f, 0.0f, -5.0f);
+        #endif
+
+        if (ms_soundscape_init("garden " + to_string(n), engine, SOUNDBITES "jardins3.wav", &scapes[n], 4, jardins, bird, multi, thunder) != MA_SUCCESS) {
+            return false;
+        }
+        ma_sound_set_volume(scapes[n].ambient, 0.05f);
+        ms_soundscape_set_tickrate(&scapes[n], 0.05f);
+        ms_soundscape_start(&scapes[n]);
+        ms_parallel_add_soundscape(&parallel, &scapes[n]);
+    }
+
+    ma_uint64 blocks = (ma_uint64)(seconds * MS_SAMPLE_RATE / MS_RENDER_BLOCK);
+    vector<float> out(MS_RENDER_BLOCK * 2);
+    result->checksum = 14695981039346656037ULL;
+    for (ma_uint64 b = 0; b < blocks; b++) {
+        ms_parallel_tick(&parallel);
+        ms_parallel_read(&parallel, out.data(), MS_RENDER_BLOCK);
+        checksum_add(&result->checksum, out.data(), out.size());
+    }
+    result->stats    = ms_parallel_get_stats(&parallel);
+    result->block_us = 1e6 * result->stats.wall_seconds / blocks;
+
+    for (ms_soundscape& scape : scapes) {
+        ms_parallel_remove_soundscape(&parallel, &scape);
+        ms_soundscape_uninit(&scape);
+    }
+    for (ms_sound* sound : sounds) {
+        ms_sound_uninit(sound);
+        delete sound;
+    }
+    ms_parallel_uninit(&parallel);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    ma_uint32 amount   = (argc > 1) ? (ma_uint32)atoi(argv[1]) : 64;
+    ma_uint32 submixes = (argc > 2) ? (ma_uint32)atoi(argv[2]) : 16;
+    double seconds     = (argc > 3) ? atof(argv[3]) : 20.0;
+    if (amount == 0 || submixes == 0 || seconds <= 0.0) {
+        printf("usage: bench_parallel [soundscapes] [submixes] [seconds]\n");
+        return -1;
+    }
+
+    printf("%u soundscapes on %u submixes, %.0f s | %u cores\n", amount, submixes, seconds, std::thread::hardware_concurrency());
+
+    run_result single;
+    bool same = true;
+    for (ma_uint32 threads = 1; threads <= 8; threads++) {
+        run_result result;
+        if (!run(threads, amount, submixes, seconds, &result)) {
+            printf("Failed to load the soundbites.\n");
+            return -1;
+        }
+        if (threads == 1) single = result;
+        same = same && result.checksum == single.checksum;
+
+        const ms_parallel_stats& s = result.stats;
+        printf("%u threads | %8.1f us per block | %5.2fx | %llu pooled, %llu serial, %llu missed, %llu stolen, %llu dropped | %s\n",
+            threads, result.block_us, single.block_us / result.block_us, (unsigned long long)s.pooled,
+            (unsigned long long)s.serial, (unsigned long long)s.missed, (unsigned long long)s.stolen, (unsigned long long)s.dropped,
+            result.checksum == single.checksum ? "same mix" : "DIFFERENT");
+    }
+    return same ? 0 : 1;
+}
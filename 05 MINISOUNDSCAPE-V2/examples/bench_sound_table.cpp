@@ -0,0 +1,99 @@
+// starts a batch of sounds over & over, once by calling ms_sound_start() on each in turn and once through
+// ms_sound_table_start(), and reports the time per sound of both. both are seeded alike, so they're also checked to
+// make the same choices of variant, volume & pan
+//
+//     make bench_sound_table
+//     ./bin/bench_sound_table              // 512 sounds, 200 rounds
+//     ./bin/bench_sound_table 2048 50
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+static void stop_all(const vector<ms_sound*>& sounds) {
+    for (ms_sound* sound : sounds) ms_sound_stop(sound);
+}
+
+int main(int argc, char** argv) {
+    size_t amount = (argc > 1) ? (size_t)atol(argv[1]) : 512;
+    int rounds    = (argc > 2) ? atoi(argv[2]) : 200;
+    if (amount == 0 || rounds <= 0) {
+        printf("usage: bench_sound_table [sounds] [rounds]\n");
+        return -1;
+    }
+
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    // every sound is the three multi soundbites with ranges of its own
+    ms_sound_table table;
+    vector<ms_sound*> sounds;
+    vector<ms_sound_handle> handles;
+    for (size_t i = 0; i < amount; i++) {
+        ms_sound* sound = new ms_sound;
+        ms_sound_init("multi", &engine, 1 + i % 4, SOUNDBITES "multi", sound);
+        if (sound->sounds.empty()) {
+            printf("Failed to load the soundbites.\n");
+            return -1;
+        }
+        ms_sound_set_volume(sound, 0.2f, 0.2f + 0.6f * i / amount);
+        ms_sound_set_pan(sound, -1.0f * i / amount, 1.0f * i / amount);
+        ms_sound_set_pitch(sound, 0.9f, 1.1f);
+        sounds.push_back(sound);
+        handles.push_back(ms_sound_table_add(&table, sound));
+    }
+
+    double loopSeconds = 0.0, tableSeconds = 0.0;
+    bool same = true;
+    vector<int> active(amount);
+    vector<float> volume(amount), pan(amount);
+    for (int r = 0; r < rounds; r++) {
+        stop_all(sounds);
+        ms_seed(r + 1);
+        auto start = chrono::steady_clock::now();
+        for (ms_sound* sound : sounds) ms_sound_start(sound);
+        loopSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (size_t i = 0; i < amount; i++) {
+            active[i] = sounds[i]->active;
+            volume[i] = sounds[i]->active_volume;
+            pan[i]    = sounds[i]->active_pan;
+        }
+
+        stop_all(sounds);
+        ms_seed(r + 1);
+        start = chrono::steady_clock::now();
+        ms_sound_table_start(&table, handles.data(), handles.size());
+        tableSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (size_t i = 0; i < amount; i++) {
+            same = same && active[i] == sounds[i]->active && volume[i] == sounds[i]->active_volume && pan[i] == sounds[i]->active_pan;
+        }
+    }
+    stop_all(sounds);
+
+    double starts = (double)amount * rounds;
+    printf("%zu sounds x %d rounds\n", amount, rounds);
+    printf("ms_sound_start       | %8.1f ns per sound\n", 1e9 * loopSeconds / starts);
+    printf("ms_sound_table_start | %8.1f ns per sound | %.2fx | %s choices\n", 1e9 * tableSeconds / starts,
+        loopSeconds / max(tableSeconds, 1e-12), same ? "same" : "DIFFERENT");
+
+    ms_sound_table_uninit(&table);
+    for (ms_sound* sound : sounds) {
+        ms_sound_uninit(sound);
+        delete sound;
+    }
+    ma_engine_uninit(&engine);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// counts the heap allocations made while moving the ms:: owners around and while starting their sounds & soundscapes,
+// which should be none: a move hands a pointer over and a start sets up a voice that's already loaded. both operator
+// new and miniaudio's allocation callbacks are counted. exits 1 if anything allocated
+//
+//     make check_allocations
+//     ./bin/check_allocations
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+static std::atomic<bool> counting(false);
+static std::atomic<ma_uint64> allocations(0);
+
+void* operator new(size_t size) {
+    if (counting.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+// both deletes are replaced, sized & unsized (the array forms forward to them), and neither is inlined: gcc would
+// otherwise see free() called on what the replaced new returned & warn of a mismatch
+[[gnu::noinline]] void operator delete(void* p) noexcept { free(p); }
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept { free(p); }
+
+static void* counted_malloc(size_t size, void*) {
+    if (counting.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size);
+}
+static void* counted_realloc(void* p, size_t size, void*) {
+    if (counting.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    return realloc(p, size);
+}
+static void counted_free(void* p, void*) { free(p); }
+
+// run `step`, returning how many allocations it made
+template <typename F>
+static ma_uint64 count(F step) {
+    allocations.store(0);
+    counting.store(true);
+    step();
+    counting.store(false);
+    return allocations.load();
+}
+
+int main() {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+    config.allocationCallbacks.onMalloc  = counted_malloc;
+    config.allocationCallbacks.onRealloc = counted_realloc;
+    config.allocationCallbacks.onFree    = counted_free;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    int failed = 0;
+    auto report = [&failed](const char* path, ma_uint64 made) {
+        printf("%-34s | %llu allocations | %s\n", path, (unsigned long long)made, made == 0 ? "ok" : "FAILED");
+        if (made != 0) failed++;
+    };
+
+    {
+        // loading allocates, that's not what's being checked
+        ms::Speaker left("left", -4.0, 0.0, -2.0), right("right", 4.0, 0.0, -2.0);
+        ms::Sound jardins("jardins", &engine, 3, SOUNDBITES "jardins");
+        ms::Sound bird("bird", &engine, 1, SOUNDBITES "bird");
+        ms::Sound thunder("thunder", &engine, 1, SOUNDBITES "thunder");
+        ms::Sound silence = ms::Sound::empty(1);
+        if (!jardins.loaded() || !bird.loaded() || !thunder.loaded()) {
+            printf("Failed to load the soundbites.\n");
+            return -1;
+        }
+        thunder.set_pitch(0.8f, 1.2f);
+        bird.add_speakers({ &left, &right });
+
+        ms::Soundscape garden("garden", &engine, SOUNDBITES "jardins3.wav", { &jardins, &bird, &thunder, &silence });
+        if (garden.result() != MA_SUCCESS) {
+            printf("Failed to load the ambient.\n");
+            return -1;
+        }
+
+        report("move a sound", count([&] {
+            ms::Sound moved(std::move(jardins));
+            jardins = std::move(moved);
+        }));
+        report("move a speaker", count([&] {
+            ms::Speaker moved(std::move(left));
+            left = std::move(moved);
+        }));
+        report("move a soundscape", count([&] {
+            ms::Soundscape moved(std::move(garden));
+            garden = std::move(moved);
+        }));
+        report("start a sound", count([&] {
+            bird.start();
+            thunder.start();
+            jardins.start();
+        }));
+        report("start a soundscape", count([&] { garden.start(); }));
+        report("play soundbites", count([&] {
+            for (int i = 0; i < 64; i++) {
+                garden.play_sound();
+                garden.play_sound_skip_empty();
+            }
+        }));
+        report("tick", count([&] {
+            garden.set_tickrate(0.0f);
+            for (int i = 0; i < 64; i++) garden.tick();
+        }));
+    }
+
+    ma_engine_uninit(&engine);
+    return (failed == 0) ? 0 : 1;
+}
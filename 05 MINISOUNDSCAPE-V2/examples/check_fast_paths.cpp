@@ -0,0 +1,123 @@
+// checks that the sounds the fast paths load without the resampler still get pitched when they're asked to be, and
+// that sounds that can doppler keep it. each probe starts a sound, renders a while & compares how far the playing
+// variant's cursor moved against how far it should have at that pitch. exits 1 if any of them is off by more than 5%
+//
+//     make check_fast_paths
+//     ./bin/check_fast_paths
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+static const ma_uint64 FRAMES = 10240;
+
+static ma_engine engine;
+static ms_scene scene;
+
+// render FRAMES frames of the engine & return how far the playing variant of `sound` moved, in frames of the engine's
+// rate so a pitch of 1 is FRAMES whatever the file's rate
+static double advance(const ms_sound* sound) {
+    ma_sound* voice = sound->sounds[sound->active];
+    ma_uint32 rate;
+    ma_sound_get_data_format(voice, NULL, NULL, &rate, NULL, 0);
+
+    ma_uint64 before = 0, after = 0;
+    ma_sound_get_cursor_in_pcm_frames(voice, &before);
+    vector<float> out(MS_RENDER_BLOCK * 2);
+    for (ma_uint64 done = 0; done < FRAMES; done += MS_RENDER_BLOCK) {
+        ma_engine_read_pcm_frames(&engine, out.data(), MS_RENDER_BLOCK, NULL);
+    }
+    ma_sound_get_cursor_in_pcm_frames(sound->sounds[sound->active], &after); // the variant may have been made again
+    return (double)(after - before) * ma_engine_get_sample_rate(&engine) / rate;
+}
+
+// render until a playing variant made again with the resampler has taken over from the old one, see ms_voice_hand_over()
+static void settle() {
+    vector<float> out(MS_RENDER_BLOCK * 2);
+    for (ma_uint64 done = 0; done < 2 * MS_RENDER_BLOCK + MS_HANDOVER_FADE; done += MS_RENDER_BLOCK) {
+        ma_engine_read_pcm_frames(&engine, out.data(), MS_RENDER_BLOCK, NULL);
+    }
+}
+
+static int failed = 0;
+
+static void report(const char* probe, double moved, double expected) {
+    bool ok = moved > expected * 0.95 && moved < expected * 1.05;
+    printf("%-34s | %6.0f frames, %6.0f expected | %s\n", probe, moved, expected, ok ? "ok" : "FAILED");
+    if (!ok) failed++;
+}
+
+int main() {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+    ms_scene_init(&scene, &engine, &config);
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    {
+        // the variants start out without the resampler
+        ms_sound flat;
+        ms_sound_init("flat", &engine, 1, SOUNDBITES "thunder", &flat, WAV, false);
+        if (flat.sounds.empty()) {
+            printf("Failed to load the soundbites.\n");
+            return -1;
+        }
+        ms_sound_start(&flat);
+        report("unpitched", advance(&flat), FRAMES);
+
+        float pitch = 2.0f;
+        ms_sound* sounds[] = { &flat };
+        ms_scene_set_params(&scene, sounds, 1, nullptr, &pitch);
+        settle();
+        report("batched pitch while playing", advance(&flat), FRAMES * 2.0);
+        ms_sound_stop(&flat);
+
+        ms_sound_set_pitch(&flat, 0.5f);
+        ms_sound_start(&flat);
+        report("ms_sound_set_pitch", advance(&flat), FRAMES * 0.5);
+        ms_sound_uninit(&flat);
+    }
+
+    #ifndef MS_NO_SPATIALIZATION
+    {
+        ms_sound spatial;
+        ms_sound_init("spatial", &engine, 1, SOUNDBITES "thunder", &spatial);
+        ms_sound_start(&spatial);
+        float pitch = 1.5f;
+        ms_sound* sounds[] = { &spatial };
+        ms_scene_set_params(&scene, sounds, 1, nullptr, &pitch);
+        settle();
+        report("batched pitch, spatialized", advance(&spatial), FRAMES * 1.5);
+        ms_sound_uninit(&spatial);
+    }
+
+    {
+        // coming straight at the listener at 100 m/s, miniaudio's doppler raises it by c / (c - v)
+        ms_entity car;
+        ms_entity_init(&car, { 0.0f, 0.0f, -200.0f });
+        ms_entity_set(&car, &engine, { 0.0f, 0.0f, -200.0f }, { 0.0f, 0.0f, 100.0f });
+
+        ms_sound engine_noise;
+        ms_sound_init("engine", &engine, 1, SOUNDBITES "thunder", &engine_noise);
+        ms_sound_attach_to_entity(&engine_noise, &scene, &car);
+        ms_sound_start(&engine_noise);
+        vector<float> out(MS_RENDER_BLOCK * 2);
+        ma_engine_read_pcm_frames(&engine, out.data(), MS_RENDER_BLOCK, NULL); // the emitter is bound at the next block
+        report("doppler on an entity", advance(&engine_noise), FRAMES * 343.3 / (343.3 - 100.0));
+        ms_sound_uninit(&engine_noise);
+    }
+    #endif
+
+    ms_scene_uninit(&scene);
+    ma_engine_uninit(&engine);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// renders a few reference soundscapes with a fixed seed and compares each against its golden file in golden/, so a
+// change to mixing, resampling or the generators that alters what comes out fails here instead of going unheard.
+// the error is the difference's power next to the golden's, in dB; anything above -tolerance fails
+//
+//     make golden
+//     ./bin/golden                  // compare, exits 1 if any scene differs
+//     ./bin/golden --tolerance 90   // ... allowing no more than -90 dB of difference
+//     ./bin/golden --update         // the sound changed on purpose, write new golden files
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+#define GOLDEN     "golden/"
+
+struct golden_scene {
+    const char* name;
+    ma_result (*render)(ma_engine* engine, const string& path, double seconds, ma_format format);
+};
+
+// a rain bed with the garden soundbites over it, given a spread of volume & pan
+static ma_result render_rain(ma_engine* engine, const string& path, double seconds, ma_format format) {
+    ms_ambience rain;
+    ms_ambience_init(&rain, MS_AMBIENCE_RAIN, 7, 0.6f);
+
+    ms_sound jardins, bird;
+    ms_sound_init("jardins", engine, 3, SOUNDBITES "jardins", &jardins);
+    ms_sound_init("bird", engine, 1, SOUNDBITES "bird", &bird);
+    ms_sound_set_volume(&jardins, 0.3f, 0.6f);
+    ms_sound_set_pan(&bird, -0.8f, 0.8f);
+
+    ms_soundscape scape;
+    ms_soundscape_init_from_data_source("rain", engine, &rain, &scape, 2, &jardins, &bird);
+    ms_soundscape_set_tickrate(&scape, 0.5f);
+    ms_soundscape_start(&scape);
+
+    ma_result result = ms_render(&scape, path, seconds, nullptr, format);
+
+    ms_soundscape_uninit(&scape);
+    ms_sound_uninit(&jardins);
+    ms_sound_uninit(&bird);
+    ms_ambience_uninit(&rain);
+    return result;
+}
+
+// grains of a garden recording with repitched soundbites, which goes through the resampler
+static ma_result render_garden(ma_engine* engine, const string& path, double seconds, ma_format format) {
+    ms_granular garden;
+    ma_result result = ms_granular_init(&garden, SOUNDBITES "jardins3.wav", 16, 3, 0.0f, 10.0f);
+    if (result != MA_SUCCESS) return result;
+
+    ms_sound multi;
+    ms_sound_init("multi", engine, 1, SOUNDBITES "multi", &multi);
+    ms_sound_set_pitch(&multi, 0.7f, 1.3f);
+    ms_sound_set_volume(&multi, 0.4f, 0.8f);
+
+    ms_soundscape scape;
+    ms_soundscape_init_from_data_source("garden", engine, &garden, &scape, 1, &multi);
+    ms_soundscape_set_tickrate(&scape, 0.7f);
+    ms_soundscape_start(&scape);
+
+    result = ms_render(&scape, path, seconds, nullptr, format);
+
+    ms_soundscape_uninit(&scape);
+    ms_sound_uninit(&multi);
+    ms_granular_uninit(&garden);
+    return result;
+}
+
+// a looping file as the ambient with thunder rolling through it, fading in over the first second
+static ma_result render_storm(ma_engine* engine, const string& path, double seconds, ma_format format) {
+    ms_sound thunder;
+    ms_sound_init("thunder", engine, 1, SOUNDBITES "thunder", &thunder);
+    ms_sound_set_pitch(&thunder, 0.9f, 1.1f);
+    ms_sound_set_pan(&thunder, -0.5f, 0.5f);
+
+    ms_soundscape scape;
+    ms_soundscape_init("storm", engine, SOUNDBITES "jardins0.wav", &scape, 1, &thunder);
+    ms_soundscape_set_tickrate(&scape, 1.0f);
+    ms_soundscape_start(&scape);
+
+    ma_result result = ms_render(&scape, path, seconds, nullptr, format);
+
+    ms_soundscape_uninit(&scape);
+    ms_sound_uninit(&thunder);
+    return result;
+}
+
+// a fresh engine & seed for every scene, so each starts at frame 0 making the same choices
+static ma_result render(const golden_scene& scene, const string& path, double seconds, ma_format format) {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    ma_result result = ma_engine_init(&config, &engine);
+    if (result != MA_SUCCESS) return result;
+
+    ms_seed(1);
+    result = scene.render(&engine, path, seconds, format);
+
+    ma_engine_uninit(&engine);
+    return result;
+}
+
+static ma_result load(const string& path, vector<float>& frames) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 2, MS_SAMPLE_RATE);
+    ma_uint64 frameCount;
+    void* data;
+    ma_result result = ma_decode_file(path.c_str(), &config, &frameCount, &data);
+    if (result != MA_SUCCESS) return result;
+
+    frames.assign((float*)data, (float*)data + frameCount * 2);
+    ma_free(data, NULL);
+    return MA_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+    bool update      = false;
+    double tolerance = 50.0;
+    double seconds   = 3.0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if      (arg == "--update")                   update    = true;
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc)   seconds   = atof(argv[++i]);
+        else {
+            printf("usage: golden [--update] [--tolerance dB] [--seconds s]\n");
+            return -1;
+        }
+    }
+
+    const golden_scene scenes[] = {
+        { "rain",   render_rain   },
+        { "garden", render_garden },
+        { "storm",  render_storm  },
+    };
+
+    // golden files are 16 bit to keep them small, the renders being checked are float. the dither & rounding that
+    // makes for comes to -65 to -80 dB of these scenes, while a different seed is around 0 dB
+    int failed = 0;
+    for (const golden_scene& scene : scenes) {
+        string golden = string(GOLDEN) + scene.name + ".wav";
+
+        if (update) {
+            std::filesystem::create_directories(GOLDEN);
+            ma_result result = render(scene, golden, seconds, ma_format_s16);
+            printf("%-8s | %s\n", scene.name, (result == MA_SUCCESS) ? ("wrote " + golden).c_str() : "failed to render");
+            if (result != MA_SUCCESS) failed++;
+            continue;
+        }
+
+        string rendered = "bin/golden_" + string(scene.name) + ".wav";
+        vector<float> expected, actual;
+        if (render(scene, rendered, seconds, ma_format_f32) != MA_SUCCESS || load(rendered, actual) != MA_SUCCESS) {
+            printf("%-8s | failed to render\n", scene.name);
+            failed++;
+            continue;
+        }
+        if (load(golden, expected) != MA_SUCCESS) {
+            printf("%-8s | no %s, make one with --update\n", scene.name, golden.c_str());
+            failed++;
+            continue;
+        }
+        if (expected.size() != actual.size()) {
+            printf("%-8s | %zu frames rendered, the golden file has %zu\n", scene.name, actual.size() / 2, expected.size() / 2);
+            failed++;
+            continue;
+        }
+
+        double signal = 0.0, noise = 0.0, peak = 0.0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            double d = (double)actual[i] - expected[i];
+            signal  += (double)expected[i] * expected[i];
+            noise   += d * d;
+            peak     = max(peak, fabs(d));
+        }
+        double error = (noise == 0.0) ? -INFINITY : 10.0 * log10(noise / max(signal, 1e-30));
+        bool ok      = error <= -tolerance;
+        printf("%-8s | error %7.1f dB | peak difference %.6f | %s\n", scene.name, error, peak, ok ? "ok" : "FAILED");
+        if (!ok) failed++;
+    }
+
+    if (!update) printf("%d of %zu scenes within -%.0f dB\n", (int)(sizeof(scenes) / sizeof(scenes[0])) - failed, sizeof(scenes) / sizeof(scenes[0]), tolerance);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+// loads every directory given as a soundscape the way a game would, with ms_sound_init() & ms_soundscape_init(), and
+// reports what each file cost: how it's stored, how long opening it took, how long a full decode takes, and the bytes
+// read from disk, held once loaded & needed decoded. then the totals per soundscape and the worst offenders
+//
+// numbered files (jardins0.wav, jardins1.wav, ...) become one ms_sound each, the first file without a number is the
+// ambient. anything else is listed as skipped
+//
+//     make inspect_soundscape
+//     ./bin/inspect_soundscape "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites"
+//     ./bin/inspect_soundscape rain/ city/ --no-decode   // skip the full decodes, they take as long as they take
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <map>
+using namespace std;
+
+#include "minisoundscape.h"
+
+struct inspected_file {
+    ms_load_record record;
+    double decode_seconds;
+};
+
+static bool supported(const string& extension, ms_sound_filetype* filetype) {
+    if (extension == ".wav")  { *filetype = WAV;  return true; }
+    if (extension == ".mp3")  { *filetype = MP3;  return true; }
+    if (extension == ".flac") { *filetype = FLAC; return true; }
+    return false;
+}
+
+static const char* format_name(ma_format format) {
+    switch (format) {
+        case ma_format_u8:  return "u8";
+        case ma_format_s16: return "s16";
+        case ma_format_s24: return "s24";
+        case ma_format_s32: return "s32";
+        case ma_format_f32: return "f32";
+        default:            return "?";
+    }
+}
+
+// seconds a full decode to float at the engine's rate takes, what MA_SOUND_FLAG_DECODE would spend at startup
+static double time_decode(const string& path) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, MS_SAMPLE_RATE);
+    ma_uint64 frames;
+    void* data;
+
+    auto start = chrono::steady_clock::now();
+    ma_result result = ma_decode_file(path.c_str(), &config, &frames, &data);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (result != MA_SUCCESS) return 0.0;
+    ma_free(data, NULL);
+    return elapsed;
+}
+
+static void print_row(const char* name, const char* format, ma_uint32 channels, ma_uint32 rate, double seconds, double open, double decode, size_t file, size_t resident, size_t decoded) {
+    printf("  %-28s | %-6s | %2u | %6u | %8.2f | %8.2f | %9.2f | %9zu | %9zu | %9zu\n",
+        name, format, channels, rate, seconds, 1000.0 * open, 1000.0 * decode, file / 1024, resident / 1024, decoded / 1024);
+}
+
+int main(int argc, char** argv) {
+    bool decode = true;
+    vector<string> directories;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--no-decode") decode = false;
+        else                      directories.push_back(arg);
+    }
+    if (directories.empty()) {
+        printf("usage: inspect_soundscape directory... [--no-decode]\n");
+        return -1;
+    }
+
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    ms_metrics_profile_loads(true);
+
+    vector<inspected_file> everything;
+    for (const string& directory : directories) {
+        if (!std::filesystem::is_directory(directory)) {
+            printf("%s isn't a directory\n", directory.c_str());
+            continue;
+        }
+
+        // numbered files by the name before the number, ms_sound_init() counts up from 0. the rest in order
+        map<string, ms_sound_filetype> families;
+        vector<string> others, skipped;
+        vector<std::filesystem::path> numbered;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            ms_sound_filetype filetype;
+            if (!entry.is_regular_file() || !supported(entry.path().extension().string(), &filetype)) continue;
+
+            string stem   = entry.path().stem().string();
+            size_t digits = stem.find_last_not_of("0123456789") + 1;
+            if (digits < stem.size() && digits > 0) {
+                numbered.push_back(entry.path());
+                if (stem.substr(digits) == "0") families[stem.substr(0, digits)] = filetype;
+            } else {
+                others.push_back(entry.path().string());
+            }
+        }
+        sort(others.begin(), others.end());
+        for (const auto& path : numbered) {
+            string stem = path.stem().string();
+            if (families.count(stem.substr(0, stem.find_last_not_of("0123456789") + 1)) == 0) skipped.push_back(path.filename().string() + ", its numbering doesn't start at 0");
+        }
+        for (size_t i = 1; i < others.size(); i++) {
+            skipped.push_back(std::filesystem::path(others[i]).filename().string() + ", only one ambient per soundscape & it isn't numbered");
+        }
+        sort(skipped.begin(), skipped.end());
+
+        string name = std::filesystem::path(directory).filename().string();
+        if (name.empty()) name = std::filesystem::path(directory).parent_path().filename().string();
+
+        // loading it is what's being measured
+        vector<ms_sound*> sounds;
+        for (const auto& family : families) {
+            ms_sound* sound = new ms_sound;
+            ms_sound_init(family.first, &engine, 1, (std::filesystem::path(directory) / family.first).string(), sound, family.second);
+            sounds.push_back(sound);
+        }
+        ms_soundscape scape;
+        bool hasAmbient = !others.empty();
+        if (hasAmbient) {
+            ms_soundscape_init(name, &engine, others[0], &scape);
+            for (ms_sound* sound : sounds) ms_soundscape_add_sound(&scape, sound);
+        }
+
+        vector<inspected_file> files;
+        for (const ms_load_record& record : ms_metrics_take_loads()) {
+            files.push_back({ record, (decode && record.result == MA_SUCCESS) ? time_decode(record.path) : 0.0 });
+        }
+
+        printf("%s | %zu sounds%s\n", name.c_str(), sounds.size(), hasAmbient ? (", ambient " + std::filesystem::path(others[0]).filename().string()).c_str() : ", no ambient");
+        printf("  %-28s | %-6s | %2s | %6s | %8s | %8s | %9s | %9s | %9s | %9s\n", "file", "format", "ch", "rate", "seconds", "open ms", "decode ms", "file kB", "held kB", "decoded kB");
+
+        inspected_file total = {};
+        for (const inspected_file& f : files) {
+            const ms_load_record& r = f.record;
+            string file = std::filesystem::path(r.path).filename().string();
+            if (r.result != MA_SUCCESS) {
+                printf("  %-28s | failed to load (%d)\n", file.c_str(), r.result);
+                continue;
+            }
+            print_row(file.c_str(), format_name(r.format), r.channels, r.sample_rate, r.duration, r.load_seconds, f.decode_seconds, r.file_bytes, r.resident_bytes, r.decoded_bytes);
+
+            total.record.duration       += r.duration;
+            total.record.load_seconds   += r.load_seconds;
+            total.decode_seconds        += f.decode_seconds;
+            total.record.file_bytes     += r.file_bytes;
+            total.record.resident_bytes += r.resident_bytes;
+            total.record.decoded_bytes  += r.decoded_bytes;
+        }
+        printf("  %-28s | %6s | %2s | %6s | %8.2f | %8.2f | %9.2f | %9zu | %9zu | %9zu\n", "total", "", "", "",
+            total.record.duration, 1000.0 * total.record.load_seconds, 1000.0 * total.decode_seconds,
+            total.record.file_bytes / 1024, total.record.resident_bytes / 1024, total.record.decoded_bytes / 1024);
+        for (const string& reason : skipped) printf("  skipped %s\n", reason.c_str());
+        printf("\n");
+
+        everything.insert(everything.end(), files.begin(), files.end());
+
+        if (hasAmbient) ms_soundscape_uninit(&scape);
+        for (ms_sound* sound : sounds) {
+            ms_sound_uninit(sound);
+            delete sound;
+        }
+    }
+
+    // where startup time & memory go
+    if (everything.size() > 1) {
+        auto slowest = max_element(everything.begin(), everything.end(), [](const inspected_file& a, const inspected_file& b) {
+            return a.record.load_seconds + a.decode_seconds < b.record.load_seconds + b.decode_seconds;
+        });
+        auto largest = max_element(everything.begin(), everything.end(), [](const inspected_file& a, const inspected_file& b) {
+            return a.record.decoded_bytes < b.record.decoded_bytes;
+        });
+        printf("slowest | %s, %.2f ms to open, %.2f ms to decode\n", slowest->record.path.c_str(), 1000.0 * slowest->record.load_seconds, 1000.0 * slowest->decode_seconds);
+        printf("largest | %s, %zu kB decoded\n", largest->record.path.c_str(), largest->record.decoded_bytes / 1024);
+    }
+
+    ma_engine_uninit(&engine);
+    return 0;
+}
@@ -0,0 +1,81 @@
+// renders a garden soundscape to a wav file as fast as the cpu allows: a bed of rain or wind, or grains of a garden
+// recording, with the jardins & bird soundbites played over it every couple of seconds. prints how much faster
+// than real time it got there, which is what to watch when baking beds or rendering in ci
+//
+//     make render_soundscape
+//     ./bin/render_soundscape 600 garden.wav             // seconds, output
+//     ./bin/render_soundscape 600 garden.wav rain --s16  // ... with a rain bed, as 16 bit
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+int main(int argc, char** argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 60.0;
+    string path    = (argc > 2) ? argv[2] : "soundscape.wav";
+    string bed     = (argc > 3) ? argv[3] : "garden";
+    ma_format format = (argc > 4 && string(argv[4]) == "--s16") ? ma_format_s16 : ma_format_f32;
+
+    srand(1); // the same soundbites at the same times on every render
+
+    // --- nothing pulls from the engine but ms_render()
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    // --- the bed
+    ms_ambience ambience;
+    ms_granular granular;
+    ma_data_source* ambient;
+    if (bed == "garden") {
+        if (ms_granular_init(&granular, SOUNDBITES "jardins3.wav", 24, 1, 0.0f, 10.0f) != MA_SUCCESS) {
+            printf("Failed to load jardins3.wav.\n");
+            return -1;
+        }
+        ambient = &granular;
+    } else {
+        ms_ambience_init(&ambience, (bed == "wind") ? MS_AMBIENCE_WIND : (bed == "insects") ? MS_AMBIENCE_INSECTS : MS_AMBIENCE_RAIN);
+        ambient = &ambience;
+    }
+
+    // --- soundbites over it
+    ms_sound jardins, bird;
+    ms_sound_init("jardins", &engine, 3, SOUNDBITES "jardins", &jardins);
+    ms_sound_init("bird", &engine, 1, SOUNDBITES "bird", &bird);
+    ms_sound_set_volume(&jardins, 0.3f, 0.6f);
+    ms_sound_set_pan(&bird, -0.8f, 0.8f);
+
+    ms_soundscape garden;
+    ms_soundscape_init_from_data_source("garden", &engine, ambient, &garden, 2, &jardins, &bird);
+    ms_soundscape_set_tickrate(&garden, 2.0f);
+    ms_soundscape_start(&garden);
+
+    ms_render_stats stats;
+    ma_result result = ms_render(&garden, path, seconds, &stats, format);
+    if (result != MA_SUCCESS) {
+        printf("Failed to render to %s (%d).\n", path.c_str(), result);
+    } else {
+        printf("%s | %.1f s of audio in %.3f s | %.0fx real time\n", path.c_str(), stats.audio_seconds, stats.wall_seconds, stats.realtime_factor);
+    }
+
+    ms_soundscape_uninit(&garden);
+    ms_sound_uninit(&jardins);
+    ms_sound_uninit(&bird);
+    if (bed == "garden") ms_granular_uninit(&granular);
+    else                 ms_ambience_uninit(&ambience);
+    ma_engine_uninit(&engine);
+
+    return (result == MA_SUCCESS) ? 0 : -1;
+}
@@ -0,0 +1,161 @@
+// pans a few sine waves across a ring of speakers, one per channel, and writes every channel to a multichannel wav
+// instead of a sound card. four voices sit still at speakers 0, 2, 4 & 6 and one circles the ring every four seconds,
+// so each channel should only ever carry its own tone plus the circling one as it passes. the loudness of every
+// channel is printed at the end
+//
+//     make render
+//     ./bin/render_speaker_array 8 12 ring.wav          // channels, seconds, output
+//     ./bin/render_speaker_array 8 12 ring.wav --null   // the same through miniaudio's null backend, in real time
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define BLOCK 512
+
+struct capture {
+    ma_encoder* encoder;
+    ma_uint32 channels;
+    ma_uint64 frames;
+    ma_uint64 target;
+    vector<double> power; // summed squares per channel
+};
+
+static void capture_block(capture* c, const float* frames, ma_uint64 frameCount) {
+    if (c->frames >= c->target) return;
+    if (frameCount > c->target - c->frames) frameCount = c->target - c->frames;
+
+    ma_encoder_write_pcm_frames(c->encoder, frames, frameCount, NULL);
+    for (ma_uint64 f = 0; f < frameCount; f++) {
+        for (ma_uint32 n = 0; n < c->channels; n++) c->power[n] += frames[f * c->channels + n] * frames[f * c->channels + n];
+    }
+    c->frames += frameCount;
+}
+
+// --- the null backend pulls blocks on its own thread, whatever the engine mixes is passed through here
+static void on_process(void* pUserData, float* pFramesOut, ma_uint64 frameCount) {
+    capture_block((capture*)pUserData, pFramesOut, frameCount);
+}
+
+// the circling voice, `seconds` into the render
+static void circle(ma_sound* voice, double seconds) {
+    float angle = 2.0f * MS_PI * (float)(seconds / 4.0);
+    ma_sound_set_position(voice, -5.0f * sinf(angle), 0.0f, -5.0f * cosf(angle));
+}
+
+int main(int argc, char** argv) {
+    ma_uint32 channels = (argc > 1) ? (ma_uint32)atoi(argv[1]) : 8;
+    double seconds     = (argc > 2) ? atof(argv[2]) : 12.0;
+    const char* path   = (argc > 3) ? argv[3] : "speaker_array.wav";
+    bool realtime      = (argc > 4) && string(argv[4]) == "--null";
+
+    if (channels < 1 || channels > MS_SPEAKER_ARRAY_MAX_SPEAKERS) {
+        printf("between 1 and %d channels please\n", MS_SPEAKER_ARRAY_MAX_SPEAKERS);
+        return -1;
+    }
+
+    ma_encoder_config encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, channels, MS_SAMPLE_RATE);
+    ma_encoder encoder;
+    if (ma_encoder_init_file(path, &encoderConfig, &encoder) != MA_SUCCESS) {
+        printf("Failed to open %s.\n", path);
+        return -1;
+    }
+
+    capture c;
+    c.encoder  = &encoder;
+    c.channels = channels;
+    c.frames   = 0;
+    c.target   = (ma_uint64)(seconds * MS_SAMPLE_RATE);
+    c.power.assign(channels, 0.0);
+
+    // --- the engine either renders on demand or drives a device on the null backend
+    ma_context context;
+    ma_backend backends[] = { ma_backend_null };
+    ma_engine_config config = ma_engine_config_init();
+    config.channels   = channels;
+    config.sampleRate = MS_SAMPLE_RATE;
+    if (realtime) {
+        if (ma_context_init(backends, 1, NULL, &context) != MA_SUCCESS) {
+            printf("Failed to initialise the null backend.\n");
+            return -1;
+        }
+        config.pContext           = &context;
+        config.periodSizeInFrames = BLOCK;
+        config.onProcess          = on_process;
+        config.pProcessUserData   = &c;
+    } else {
+        config.noDevice = MA_TRUE;
+    }
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    // --- an even ring, channel 0 ahead & the rest anticlockwise
+    float azimuths[MS_SPEAKER_ARRAY_MAX_SPEAKERS];
+    for (ma_uint32 n = 0; n < channels; n++) azimuths[n] = 360.0f * n / channels;
+
+    ms_speaker_array array;
+    ms_speaker_array_init(&array, &engine, azimuths);
+
+    const int voiceAmount = 5;
+    ma_waveform waves[voiceAmount];
+    ma_sound voices[voiceAmount];
+    ms_speaker_voice handles[voiceAmount];
+    for (int i = 0; i < voiceAmount; i++) {
+        ma_waveform_config wave = ma_waveform_config_init(ma_format_f32, channels, MS_SAMPLE_RATE, ma_waveform_type_sine, 0.2, 220.0 * (i + 1));
+        ma_waveform_init(&wave, &waves[i]);
+        ma_sound_init_from_data_source(&engine, &waves[i], MA_SOUND_FLAG_NO_SPATIALIZATION, NULL, &voices[i]);
+        ma_sound_set_attenuation_model(&voices[i], ma_attenuation_model_none);
+
+        if (i < voiceAmount - 1) {
+            float angle = azimuths[(2 * i) % channels] * MS_PI / 180.0f;
+            ma_sound_set_position(&voices[i], -5.0f * sinf(angle), 0.0f, -5.0f * cosf(angle));
+        } else {
+            circle(&voices[i], 0.0);
+        }
+
+        ms_speaker_array_add_voice(&array, &voices[i], &handles[i]);
+        ma_sound_start(&voices[i]);
+    }
+
+    // --- move the circling voice every block until enough has been captured
+    if (realtime) {
+        auto start = chrono::steady_clock::now();
+        while (c.frames < c.target) {
+            circle(&voices[voiceAmount - 1], chrono::duration<double>(chrono::steady_clock::now() - start).count());
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    } else {
+        vector<float> out(BLOCK * channels);
+        while (c.frames < c.target) {
+            circle(&voices[voiceAmount - 1], (double)c.frames / MS_SAMPLE_RATE);
+            ma_engine_read_pcm_frames(&engine, out.data(), BLOCK, NULL);
+            capture_block(&c, out.data(), BLOCK);
+        }
+    }
+
+    ma_engine_stop(&engine);
+    for (int i = 0; i < voiceAmount; i++) {
+        ma_sound_uninit(&voices[i]);
+        ms_speaker_array_remove_voice(&array, &handles[i]);
+        ma_waveform_uninit(&waves[i]);
+    }
+    ms_speaker_array_uninit(&array);
+    ma_engine_uninit(&engine);
+    if (realtime) ma_context_uninit(&context);
+    ma_encoder_uninit(&encoder);
+
+    printf("wrote %llu frames of %u channels to %s\n", (unsigned long long)c.frames, channels, path);
+    for (ma_uint32 n = 0; n < channels; n++) {
+        printf("  channel %2u at %6.1f degrees | rms %.4f\n", n, azimuths[n], sqrt(c.power[n] / c.frames));
+    }
+    return 0;
+}
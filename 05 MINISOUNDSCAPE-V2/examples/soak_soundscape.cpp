@@ -0,0 +1,93 @@
+// builds a soundscape, plays a few blocks of it and tears it down again, over & over, watching the process's resident
+// memory. anything init leaves behind after uninit shows up as growth, which fails the run once it passes the
+// tolerance. the first tenth of the run is a warm up, miniaudio & the allocator settle in during it
+//
+//     make soak_soundscape
+//     ./bin/soak_soundscape                         // 10000 soundscapes, at most 1024 kB of growth
+//     ./bin/soak_soundscape 100000 --tolerance 256
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <unistd.h>
+using namespace std;
+
+#include "minisoundscape.h"
+
+#define SOUNDBITES "../../00 VANILLA OPENFRAMEWORKS/bin/data/soundbites/"
+
+// resident set size in kB, from /proc
+static long resident_kb() {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL) return 0;
+    long pages = 0, resident = 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+int main(int argc, char** argv) {
+    long iterations = 10000;
+    long tolerance  = 1024;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if      (arg == "--tolerance" && i + 1 < argc) tolerance  = atol(argv[++i]);
+        else if (isdigit(arg[0]))                      iterations = atol(argv[i]);
+        else {
+            printf("usage: soak_soundscape [iterations] [--tolerance kB]\n");
+            return -1;
+        }
+    }
+
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice   = MA_TRUE;
+    config.channels   = 2;
+    config.sampleRate = MS_SAMPLE_RATE;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        printf("Failed to initialise audio engine.\n");
+        return -1;
+    }
+
+    ms_seed(1);
+    vector<float> out(MS_RENDER_BLOCK * 2);
+    long warm     = max(1L, iterations / 10);
+    long baseline = 0;
+    auto started  = chrono::steady_clock::now();
+
+    for (long i = 0; i < iterations; i++) {
+        // two soundbites & a file ambient, the way a game loads a zone
+        ms_sound bird, multi;
+        ms_sound_init("bird", &engine, 1, SOUNDBITES "bird", &bird);
+        ms_sound_init("multi", &engine, 2, SOUNDBITES "multi", &multi);
+        ms_sound_set_pitch(&multi, 0.8f, 1.2f);
+
+        ms_soundscape scape;
+        if (ms_soundscape_init("soak", &engine, SOUNDBITES "multi0.wav", &scape, 2, &bird, &multi) != MA_SUCCESS) {
+            printf("Failed to load the soundbites.\n");
+            return -1;
+        }
+        ms_soundscape_start(&scape);
+        ms_soundscape_play_sound(&scape);
+        for (int b = 0; b < 4; b++) ma_engine_read_pcm_frames(&engine, out.data(), MS_RENDER_BLOCK, NULL);
+
+        ms_soundscape_uninit(&scape);
+        ms_sound_uninit(&bird);
+        ms_sound_uninit(&multi);
+
+        if ((i + 1) % warm == 0) {
+            long resident = resident_kb();
+            if (i + 1 == warm) baseline = resident;
+            printf("%8ld soundscapes | %6ld kB resident\n", i + 1, resident);
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    long growth    = resident_kb() - baseline;
+    bool ok        = growth <= tolerance;
+    printf("%.1f us per soundscape | %+ld kB since the warm up | %s\n", 1e6 * seconds / iterations, growth, ok ? "ok" : "FAILED");
+
+    ma_engine_uninit(&engine);
+    return ok ? 0 : 1;
+}
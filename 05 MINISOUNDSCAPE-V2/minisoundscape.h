@@ -2,7 +2,18 @@
 #define MINISOUNDSCAPE_H
 
 #include <stdarg.h> // variadic arguments
+#include <math.h>   // sqrtf, powf, floor, fmod
+#include <string.h> // memset, memcpy
+#include <atomic>
+#include <algorithm> // push_heap, pop_heap, sort, unique
 #include <vector>
+#include <string>
+#include <unordered_map> // the name index, see ms_intern()
+#include <utility>       // std::exchange, moving the ms:: owners
+#include <initializer_list>
+#include <type_traits>   // std::remove_const_t, for ms::span
+#include <chrono>    // steady_clock, timing ms_render()
+#include <thread>    // the ms_parallel pool
 #include "miniaudio.h"
 
 /* --- utilities --- */
@@ -10,8 +21,39 @@
 // map a value from an input range to an output range
 #define MAP(x, in_min, in_max, out_min, out_max) ((x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min)
 
+#define MS_PI 3.14159265f
+
+// one step of a xorshift. minisoundscape keeps generators of its own rather than using rand(), so nothing else in
+// the program moves them & a seed makes the same numbers on every platform
+static inline ma_uint32 ms_xorshift(ma_uint32* state) {
+    ma_uint32 s = *state;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    *state = s;
+    return s;
+}
+
+// one draw from a xorshift, [0, 1)
+static inline float ms_random01(ma_uint32* state) {
+    return (ms_xorshift(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+// every random choice ms_sound & ms_soundscape make (which variant, its volume, pan & pitch, which speaker, which
+// soundbite) comes from here
+static ma_uint32 g_ms_random = 1;
+
+// start the choices over. the same seed makes the same choices, see "Deterministic renders" below
+void ms_seed(ma_uint32 seed) {
+    g_ms_random = (seed == 0) ? 1 : seed; // a xorshift never leaves zero
+}
+
+static inline ma_uint32 ms_rand() {
+    return ms_xorshift(&g_ms_random);
+}
+
 // return a random number within a given range
-#define RAND_IN_RANGE(start, end)                (MAP((float)(rand() % 100) / 100, -1.0f, 1.0f, start, end))
+#define RAND_IN_RANGE(start, end)                (MAP((float)(ms_rand() % 100) / 100, -1.0f, 1.0f, start, end))
 
 /* --- default macros --- */
 
@@ -39,6 +81,110 @@
     #define MS_DEFAULT_VOLUME 1.0
 #endif
 
+#ifndef MS_DEFAULT_LOD_NEAR_DISTANCE
+    #define MS_DEFAULT_LOD_NEAR_DISTANCE 10.0 // voices closer than this get full spatialization & doppler
+#endif
+
+#ifndef MS_DEFAULT_LOD_FAR_DISTANCE
+    #define MS_DEFAULT_LOD_FAR_DISTANCE 40.0  // voices further than this are summed into the soundscape's bed in mono
+#endif
+
+#ifndef MS_LOD_BED_VOICES
+    #define MS_LOD_BED_VOICES 256             // most mid & far voices a soundscape's bed mixes, any more stay near
+#endif
+
+#ifndef MS_LOD_BED_CHUNK
+    #define MS_LOD_BED_CHUNK 512              // frames the bed reads from a voice's data source at once
+#endif
+
+#ifndef MS_LOD_HYSTERESIS
+    #define MS_LOD_HYSTERESIS 0.1             // fraction of a threshold a voice must cross before changing tier
+#endif
+
+#ifndef MS_DEFAULT_MAX_EMITTERS
+    #define MS_DEFAULT_MAX_EMITTERS 4096
+#endif
+
+#ifndef MS_SCENE_COMMAND_CAPACITY
+    #define MS_SCENE_COMMAND_CAPACITY 1024      // commands that can be queued for the audio thread on top of one per emitter
+#endif
+
+#ifndef MS_ENTITY_MAX_EXTRAPOLATION
+    #define MS_ENTITY_MAX_EXTRAPOLATION 0.5     // seconds an entity's last position is carried along its velocity for
+#endif
+
+#ifndef MS_OCCLUSION_MIN_CUTOFF
+    #define MS_OCCLUSION_MIN_CUTOFF 400.0       // low-pass cutoff in Hz of a fully occluded voice
+#endif
+
+#ifndef MS_OCCLUSION_MAX_CUTOFF
+    #define MS_OCCLUSION_MAX_CUTOFF 20000.0     // low-pass cutoff in Hz of an unoccluded voice
+#endif
+
+#ifndef MS_OCCLUSION_TILE_LOSS
+    #define MS_OCCLUSION_TILE_LOSS 1.0          // gain kept for every open tile sound travels through
+#endif
+
+#ifndef MS_AMBISONIC_MAX_SPEAKERS
+    #define MS_AMBISONIC_MAX_SPEAKERS 16        // most speakers an ambisonic bus can decode to
+#endif
+
+#ifndef MS_AMBISONIC_ENCODER_VOICES
+    #define MS_AMBISONIC_ENCODER_VOICES 64      // voices per encoder node, at most 254. a bus adds encoders as it fills up
+#endif
+
+#ifndef MS_SPEAKER_ARRAY_MAX_SPEAKERS
+    #define MS_SPEAKER_ARRAY_MAX_SPEAKERS 32    // most physical speakers (and device channels) a speaker array can drive
+#endif
+
+#ifndef MS_SPEAKER_ARRAY_PANNER_VOICES
+    #define MS_SPEAKER_ARRAY_PANNER_VOICES 64   // voices per panner node, at most 254. an array adds panners as it fills up
+#endif
+
+#ifndef MS_AMBIENCE_BLOCK
+    #define MS_AMBIENCE_BLOCK 64                // frames an ambience generator renders at once, its slow controls move this often. a multiple of 4
+#endif
+
+#ifndef MS_RENDER_BLOCK
+    #define MS_RENDER_BLOCK 512                 // frames ms_render() mixes between soundscape ticks, like a device period
+#endif
+
+#ifndef MS_HANDOVER_FADE
+    #define MS_HANDOVER_FADE 256                // frames a playing variant made again with the resampler crossfades from the old one over
+#endif
+
+#ifndef MS_DEFAULT_PARALLEL_DEADLINE
+    #define MS_DEFAULT_PARALLEL_DEADLINE 0.5    // fraction of a block's length the ms_parallel pool has to render it in
+#endif
+
+#ifndef MS_PARALLEL_MISSES
+    #define MS_PARALLEL_MISSES 8                // blocks in a row over the deadline before ms_parallel falls back to one thread
+#endif
+
+#ifndef MS_PARALLEL_SIT_OUT
+    #define MS_PARALLEL_SIT_OUT 256             // blocks ms_parallel renders on one thread before trying the pool again
+#endif
+
+#ifndef MS_GRANULAR_STREAMS
+    #define MS_GRANULAR_STREAMS 32              // most grain streams a granular ambience can run at once. a multiple of 4
+#endif
+
+#ifndef MS_TRACE_CAPACITY
+    #define MS_TRACE_CAPACITY 8192              // trace events each thread keeps between ms_trace_write() calls, a power of two. later ones are dropped
+#endif
+
+#ifndef MS_TRACE_THREADS
+    #define MS_TRACE_THREADS 8                  // most threads that can record trace events at once, an exited one's buffer is reused once written
+#endif
+
+#ifndef MS_ARENA_BLOCK
+    #define MS_ARENA_BLOCK 4096                 // bytes a sound's or soundscape's arena grows by, larger allocations get a block of their own
+#endif
+
+#ifndef MS_VBAP_TABLE_SIZE
+    #define MS_VBAP_TABLE_SIZE 720              // directions the speaker array's gains are worked out for, 720 is every half degree
+#endif
+
 /*
 
     minisoundscape is an addon for miniaudio that adds utilities
@@ -64,570 +210,6344 @@
     Macros for optimisation
 
      - MS_VERBOSE           | Prints status updates on what minisoundscape is doing, e.g. initialising or ticking a soundscape, playing a sound, loading a soundfile, etc.
+     - MS_TRACE             | Records timestamped loads, starts, ticks, fades & callbacks for ms_trace_write() to save as a chrome trace
+     - MS_PROFILE_NODES     | Times every node minisoundscape puts in the engine's graph, reported per soundscape by ms_metrics_get()
      - MS_NO_SOUNDSCAPE     | Removes ms_soundscape related code. Useful if you only want the ms_sound objects
      - MS_NO_SPATIALIZATION | Removes ms_origin_point related code. Useful if you aren't doing any spatialization!
+     - MS_NO_LOD            | Removes distance based level of detail. Every spatialized voice is then fully spatialized regardless of distance
+     - MS_NO_OCCLUSION      | Removes the tile grid occlusion map
+     - MS_NO_AMBISONICS     | Removes the ambisonic bus
+     - MS_NO_SPEAKER_ARRAY  | Removes vector base amplitude panning onto physical speakers
+     - MS_NO_AMBIENCE       | Removes the procedural & granular ambience generators
+     - MS_NO_METRICS        | Removes the runtime counters behind ms_metrics_get()
+     - MS_NO_FAST_PATHS     | Every voice goes through miniaudio's pitch & spatialization stages, whether its sound needs them or not
+     - MS_NO_PARALLEL       | Removes ms_parallel, the renderer that mixes soundscape submixes on a pool of threads
 
+    Memory
 
-*/
+    a sound's variants are carved out of an arena of its own in one piece, and a soundscape's ambient & bed out of
+    another, so they sit next to each other & are handed back in one release. ms_soundscape_uninit() uninitialises
+    its ambient & bed and leaves its sounds to whoever made them, a sound can be in more than one soundscape.
+    uninitialising a sound again does nothing. examples/soak_soundscape.cpp builds & tears down soundscapes in a loop
+    and checks resident memory stays flat.
 
-typedef struct ms_sound         ms_sound;
-typedef struct ms_soundscape    ms_soundscape;
-typedef struct ms_sound_speaker ms_sound_speaker;
+    Names
 
-/* --- ms_sound --- */
+    every name given to ms_sound_init() & ms_soundscape_init() is interned once with ms_intern(), and sounds &
+    soundscapes carry the id as well as the name. starting a sound compares flags & ids only, placeholders from
+    ms_sound_init_empty() are marked `empty` rather than known by their name. ms_lookup() goes from a name to its id
+    through a hash index without interning it, and ms_soundscape_find_sound() & ms_sound_table_find() go from an id
+    or a name to the sound, for tools & loading configs.
 
-struct ms_sound {
-    std::string name;
-    int weight;
-    vector<ma_sound*> sounds;
-    // ranges work as an array of size 2. the 0th item is the start of the range, and the 1st item is the end of the range
-    // e.g. setting `pan_range` to `{ -0.5, 0.5 }` would mean that panning will be randomly chosen from -0.5 to 0.5
-    float pan_range[2];
-    float pitch_range[2];
-    float volume_range[2];
-    #ifndef MS_NO_SPATIALIZATION
-    vector<ms_sound_speaker*> speakers;
-    #endif
-};
+    Fast paths
 
-typedef enum {
-    WAV,
-    MP3,
-    FLAC
-} ms_sound_filetype;
+    miniaudio resamples every voice to pitch it and spatializes every voice that isn't loaded without it, even at a
+    pitch of 1 & sitting on the listener. ms_sound_init() loads variants without the spatializer, and ms_sound_classify()
+    switches it back on for a spatialized sound placed by speakers, a path, an entity or ms_sound_set_position(). the
+    setters reclassify a sound, so place its variants through them rather than with ma_sound_set_position().
 
-/* --- ms_soundscape --- */
+    the resampler can only be left out when a voice is made, so ms_sound_init() loads variants without it too. once a
+    sound is given a pitch other than 1 (by ms_sound_set_pitch() or ms_scene_set_params()), or can doppler - only a
+    spatialized sound moved by a path or an entity has a velocity - its variants are made again with the resampler.
+    the one playing is handed over at a time the audio thread hasn't reached: the old variant fades out over
+    MS_HANDOVER_FADE frames as the new one fades in from where the old one will be. a sound without the resampler
+    starts a frame earlier than one with it at a pitch of 1, the resampler's latency, and sounds alike otherwise.
+    define MS_NO_FAST_PATHS to put every voice through both, examples/bench_fast_paths.cpp builds with & without it to
+    compare and examples/check_fast_paths.cpp checks pitch & doppler still reach the voices. the variants of a sound
+    made with ms_sound_init_from_data_source() play data sources the caller owns and can't be made again, so whether
+    they have the resampler is decided when they're made.
 
-#ifndef MS_NO_SOUNDSCAPE
-struct ms_soundscape {
-    std::string name;
-    ma_sound* ambient;
-    ma_engine* engine;
-    vector<ms_sound*> sounds;
-    ma_uint64 timeSinceLastTick; // long long
-    float tickrate;
-};
-#endif /*  MS_NO_SOUNDSCAPE */
+    C++ owners
 
-/* --- ms_sound_speaker ---*/
+    ms::Sound, ms::Soundscape & ms::Speaker own an ms_sound, ms_soundscape & ms_sound_speaker: they initialise it
+    when they're made, uninitialise it when they go, and can be moved but not copied. where the C functions take
+    `...` they take a braced list or an ms::span of pointers:
 
-#ifndef MS_NO_SPATIALIZATION
-struct ms_sound_speaker {
-    std::string name;
-    double x;
-    double y;
-    double z;
-    ms_sound* sound;
-};
-#endif /* MS_NO_SPATIALIZATION */
+        ms::Sound bird("bird", &engine, 1, "soundbites/bird");
+        ms::Sound thunder("thunder", &engine, 1, "soundbites/thunder");
+        ms::Soundscape storm("storm", &engine, "ambient/rain.wav", { &bird, &thunder });
 
-/* --- ms_sound --- */
+    each owner only tears down what it made, a soundscape leaves its sounds to their ms::Sound, and one whose ambient
+    data source couldn't be played made nothing, which ok() tells. moving an owner
+    doesn't allocate, and neither does starting a sound or a soundscape, which examples/check_allocations.cpp counts.
 
-void      ms_sound_init(std::string name, ma_engine* engine, unsigned int weight, std::string filepath, ms_sound* sound, ms_sound_filetype filetype = MS_DEFAULT_FILETYPE, bool enable_spatialization = true);
-void      ms_sound_init_empty(ms_sound* sound, unsigned int weight);
-void      ms_sound_uninit(ms_sound* sound);
+    Sound tables
 
-bool      ms_sound_is_playing(const ms_sound* sound);
+    an ms_sound_table keeps what starting a sound reads - its volume, pan & pitch ranges, weight, flags & variants -
+    for many sounds in arrays of one field each, so a batch of them can be randomised & started in one pass with
+    ms_sound_table_start() instead of ms_sound_start() on each in turn. the ms_sound stays the owner, the table only
+    mirrors it: ms_sound_table_add() returns the sound's handle, the ms_sound_set_*() functions keep the table in step
+    and ms_sound_uninit() takes the sound out again. examples/bench_sound_table.cpp compares the two.
 
-ma_result ms_sound_start(ms_sound* sound);
-ma_result ms_sound_stop(const ms_sound* sound);
+    Level of detail
 
-#ifndef MS_NO_SPATIALIZATION
-void      ms_sound_set_spatialization(ms_sound* sound, bool spatialization);
-void      ms_sound_add_speaker(ms_sound* sound, const unsigned int speakerAmount, ...);
-void      ms_sound_add_speaker(ms_sound* sound, ms_sound_speaker* speaker);
-void      ms_sound_set_position(ms_sound* sound, double x, double y, double z);
-#endif /* MS_NO_SPATIALIZATION */
-void      ms_sound_set_volume(ms_sound* sound, float volume);
-void      ms_sound_set_volume(ms_sound* sound, float start, float end);
-void      ms_sound_set_pitch(ms_sound* sound, float pitch);
-void      ms_sound_set_pitch(ms_sound* sound, float start, float end);
-void      ms_sound_set_pan(ms_sound* sound, float pan);
-void      ms_sound_set_pan(ms_sound* sound, float start, float end);
+    spatialized voices are sorted into three tiers by their distance to the listener every time
+    ms_soundscape_tick() is called:
+     - near | full spatialization & doppler, exactly as miniaudio would do it
+     - mid  | mixed by the soundscape's bed in mono, attenuation & panning are worked out once per tick
+     - far  | as mid, but summed into one centred signal
 
-void ms_sound_init(std::string name, ma_engine* engine, unsigned int weight, std::string filepath, ms_sound* sound, ms_sound_filetype filetype, bool enable_spatialization) {
-    sound->name            = name;
-    sound->weight          = weight;
+    the bed is a node of its own (ms_lod_bed) with no inputs. mid & far voices are detached from the graph & the bed
+    reads their data sources itself, mixes them down to mono, steps them linearly at their pitch & adds them up, so
+    none of the sound's own stages - its resampler, spatializer, gainer & the mix into the endpoint - run for them.
+    the voice's own volume & pan still apply, on top of the tier's. occluded voices, ones
+    going through an ambisonic bus or a speaker array, ones whose data source has more than MS_LOD_BED_MAX_CHANNELS
+    channels, and any past the bed's MS_LOD_BED_VOICES slots stay near.
 
-    // -1.0f to 1.0f
-    sound->pan_range[0]    = 0.0f;
-    sound->pan_range[1]    = 0.0f;
+    the bed times both of its mixes whatever is defined, ms_soundscape_get_lod_stats() reports them as the mid & far
+    tiers' dsp_seconds. near voices are only timed with MS_PROFILE_NODES. reading a data source - decoding it & the
+    decoder converting it to the engine's rate - is most of what any voice costs & every tier pays it, so the saving
+    is modest: examples/bench_lod.cpp plays one ring of voices in each tier, far comes out some 5-10% under near &
+    mid about even with it.
 
-    // 0.0f to inf
-    sound->pitch_range[0]  = 1.0f;
-    sound->pitch_range[1]  = 1.0f;
+    the thresholds can be changed with ms_soundscape_set_lod(), and ms_soundscape_get_lod_stats() reports how many
+    voices sit in each tier, the frames they played & the time measured on them, per tier.
 
-    // 0.0f to inf
-    sound->volume_range[0] = 1.0f;
-    sound->volume_range[1] = 1.0f;
+    Scenes & moving emitters
 
-    #ifdef MS_VERBOSE
-        std::cout << "ms_sound_init :: initialising " << sound->name << std::endl;
-    #endif
+    an ms_scene is hooked into the engine's `onProcess` callback and does its work on the audio thread
+    once per block. anything the game thread asks of it is queued and picked up at the next block.
 
-    ma_uint32 flags = 0;
-    #ifndef MS_NO_SPATIALIZATION
-    if (!enable_spatialization) flags = MA_SOUND_FLAG_NO_SPATIALIZATION;
-    #else
-    flags = MA_SOUND_FLAG_NO_SPATIALIZATION;
-    #endif
+    emitters move a voice along an ms_path (a line or a spline through points) or with an ms_entity (a
+    position & velocity the game thread publishes whenever it likes, extrapolated in between). every
+    block the position halfway through the next block & the velocity across it are set on the voice, so
+    miniaudio's gain smoothing interpolates within the block and its doppler effect comes for free.
 
-    unsigned short i = 0;
-    while (true) {
-        std::string str = filepath + to_string(i);
-        switch (filetype) {
-            case WAV:  str += ".wav";  break;
-            case MP3:  str += ".mp3";  break;
-            case FLAC: str += ".flac"; break;
-        }
-        if (!std::filesystem::exists(str)) break; // check if our file exists, if it doesn't we break the while loop
+        ma_engine_config config = ma_engine_config_init();
+        ms_scene_init(&scene, &engine, &config); // before ma_engine_init()
+        ma_engine_init(&config, &engine);
+        ...
+        ms_path_init_line(&road, { -20, 0, -5 }, { 20, 0, -5 }, 6.0);
+        ms_sound_set_path(&car, &scene, &road);  // every start of `car` drives down the road
 
-        #ifdef MS_VERBOSE
-            else std::cout << "ms_sound_init :: loading " << str << std::endl;
-        #endif
+    the volume, pitch & pan of many playing sounds can be changed together with ms_scene_set_params(). the values
+    are copied into a struct of arrays & applied in one go at the next block, so they're heard at the same time.
 
-        ma_sound* s = new ma_sound;
-        ma_result result = ma_sound_init_from_file(engine, str.c_str(), flags, NULL, NULL, s);
+    a sound uninitialised while a command naming its voices is still queued, its emitter's removal or a batch, is
+    stopped straight away & its voices are freed by the scene once the audio thread has read the command. so
+    uninitialise the sounds that were in a scene before the scene.
 
-        #ifndef MS_NO_SPATIALIZATION
-            ma_sound_set_positioning(s, ma_positioning_relative);
-        #endif
+    Occlusion
 
-        if (result != MA_SUCCESS) {
-            #ifdef MS_VERBOSE
-                std::cout << "ms_sound_init :: " << str << " failed to initialise and will not be added to " << sound->name << std::endl;
-            #endif
-        } else {
-            sound->sounds.push_back(s);
-        }
+    an ms_occlusion_grid describes the world as tiles on the x/z plane, each letting through some fraction of
+    the sound that passes it. whenever the listener changes tile, or a tile changes, ms_occlusion_grid_update()
+    floods the grid from the listener's tile on the game thread & publishes a gain and low-pass cutoff for every
+    tile. the audio thread then only looks up the tile each occluded voice is standing on, once per block.
 
-        i++;
-    }
-}
+    Ambisonics
 
-void ms_sound_init_empty(ms_sound* sound, unsigned int weight) {
-    sound->name = "empty";
-    sound->weight = weight;
-}
+    instead of every voice panning itself to the output channels, sounds can be encoded into an ms_ambisonic_bus
+    of first (4 channels) or third (16 channels) order. voices are plugged straight into encoder nodes that take
+    MS_AMBISONIC_ENCODER_VOICES voices each, so there's no extra node per voice. each voice then only works out its
+    direction & distance once per block, and the bus is rotated to face the listener & decoded once per block:
+     - MS_AMBISONIC_STEREO   | two cardioids pointing left & right
+     - MS_AMBISONIC_BINAURAL | eight virtual speakers around the head, each heard with a rough delay & head shadow
+     - MS_AMBISONIC_SPEAKERS | a ring of speakers, one per engine channel, at the given azimuths
 
-void ms_sound_uninit(ms_sound* sound) {
-    for (size_t i = sound->sounds.size(); i == 0; i--) {
-        delete sound->sounds[i];
-    }
-}
+        ms_ambisonic_bus_init(&bus, &engine, 3, MS_AMBISONIC_BINAURAL);
+        ms_sound_set_ambisonic(&birds, &bus);
 
-bool ms_sound_is_playing(const ms_sound* sound) {
-    for (ma_sound* s : sound->sounds) {
-        if (ma_sound_is_playing(s)) return true;
-    }
-    return false;
-}
+    only the listener's yaw is followed, and encoded voices have no doppler. see examples/bench_ambisonics.cpp.
 
-ma_result ms_sound_start(ms_sound* sound) {
-    if (!ms_sound_is_playing(sound) && sound->name != "empty") {
-        size_t i = rand() % sound->sounds.size();
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_start :: playing " << sound->name << "[" << to_string(i) << "]" << endl;
-        #endif
-        ma_sound_set_pitch (sound->sounds[i], RAND_IN_RANGE(sound->pitch_range[0],  sound->pitch_range[1]));
-        ma_sound_set_volume(sound->sounds[i], RAND_IN_RANGE(sound->volume_range[0], sound->volume_range[1]));
-        ma_sound_set_pan   (sound->sounds[i], RAND_IN_RANGE(sound->pan_range[0],    sound->pan_range[1]));
-        #ifndef MS_NO_SPATIALIZATION
-            if (sound->speakers.size() > 0) {
-                ms_sound_speaker* speaker = sound->speakers[rand() % sound->speakers.size()];
-                ma_sound_set_position(sound->sounds[i], speaker->x, speaker->y, speaker->z);
-            }
-        #endif /* MS_NO_SPATIALIZATION */
-        return ma_sound_start(sound->sounds[i]);
-    }
-    return MA_SUCCESS;
-}
+    Speaker arrays
 
-ma_result ms_sound_stop(const ms_sound* sound) {
-    if (ms_sound_is_playing(sound)) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_stop :: stopping " << sound->name << endl;
-        #endif
-        for (size_t i = 0; i < sound->sounds.size(); i++) {
-            ma_sound_stop(sound->sounds[i]);
-        }
-    }
-    return MA_SUCCESS;
-}
+    for installations with a real speaker per device channel, an ms_speaker_array pans sounds across a horizontal
+    ring of physical speakers with vector base amplitude panning: each voice is only ever heard from the two
+    speakers either side of it. the gains for every direction are worked out once in ms_speaker_array_init(), so
+    a voice only looks its gains up again when it or the listener has moved - a voice sat at an ms_sound_speaker
+    costs nothing but the mixing. the engine needs as many channels as the device has outputs.
 
-#ifndef MS_NO_SPATIALIZATION
-void ms_sound_set_spatialization(ms_sound* sound, bool spatialization) {
-    for (ma_sound* s : sound->sounds) {
-        ma_sound_set_spatialization_enabled(s, spatialization);
-    }
-}
+        float ring[8] = { 0, 45, 90, 135, 180, 225, 270, 315 }; // degrees anticlockwise from ahead, per channel
+        ms_speaker_array_init(&array, &engine, ring);
+        ms_sound_set_speaker_array(&birds, &array);
 
-void ms_sound_add_speaker(ms_sound* sound, const unsigned int speakerAmount, ...) {
-    va_list vl;
-    va_start(vl, speakerAmount);
+    see examples/render_speaker_array.cpp, which renders a multichannel wav without any audio hardware.
 
-    for (size_t i = 0; i < speakerAmount; i++) {
-        sound->speakers.push_back(va_arg(vl, ms_sound_speaker*));
-    }
+    Procedural ambience
 
-    va_end(vl);
-}
+    an ms_ambience is a data source that synthesises an endless ambient bed instead of looping a long file, so it
+    takes under a kilobyte whatever it plays for. it can be used as a soundscape's ambient:
+     - MS_AMBIENCE_RAIN    | filtered hiss with droplets ringing through resonant band-passes
+     - MS_AMBIENCE_WIND    | low-passed noise & a whistling band, both swept by slow random gusts
+     - MS_AMBIENCE_INSECTS | four chirpers, each pulsing a high tone in phrases of its own
 
-void ms_sound_add_speaker(ms_sound* sound, ms_sound_speaker* speaker) {
-    ms_sound_add_speaker(sound, 1, speaker);
-}
+        ms_ambience_init(&rain, MS_AMBIENCE_RAIN);
+        ms_soundscape_init_from_data_source("storm", &engine, &rain, &storm, 2, &thunder, &birds);
 
-void ms_sound_set_position(ms_sound* sound, double x, double y, double z) {
-    for (ma_sound* s : sound->sounds) {
-	    ma_sound_set_position(s, -5, 0, 0);
-    }
-}
-#endif /* MS_NO_SPATIALIZATION */
+    each generator runs four filters or oscillators side by side on interleaved lanes, so its loops vectorise.
+    ms_ambience_set_intensity() makes it rain harder, blow stronger or sing busier. see examples/bench_ambience.cpp.
 
-void ms_sound_set_volume(ms_sound* sound, float volume) {
-    if (volume < 0.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_volume :: `volume` must be greater than or equal to 0" << std::endl;
-        #endif
-        volume = 0.0f;
-    }
+    an ms_granular does the same for recorded beds: it keeps a few seconds of a clip and plays overlapping grains out
+    of it, each from a random place at a random pitch, length & window, so it never audibly loops.
 
-    sound->volume_range[0] = volume;
-    sound->volume_range[1] = volume;
-}
+        ms_granular_init(&garden, "garden.wav", 24, 1, 0.0f, 10.0f); // 24 grains at once out of the first 10 s
+        ms_granular_set_grains(&garden, 0.08f, 0.4f, 0.03f);          // 80 to 400 ms long, +- 3% in pitch
+        ms_soundscape_init_from_data_source("garden", &engine, &garden, &garden_scape, 1, &birds);
 
-void ms_sound_set_volume(ms_sound* sound, float start, float end) {
-    if (start < end) { // swap start and end
-        float v0 = start;
-        float v1 = end;
-        start = v1;
-        end = v0;
-    }
+    up to MS_GRANULAR_STREAMS grains play at once. windows & mixing are done a block at a time for each, reading
+    the clip is the only part that stays scalar.
 
-    if (start < 0.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_volume_range :: `start` must be greater than or equal to 0" << std::endl;
-        #endif
-        start = 0.0f;
-    }
+    both report a cursor and can be seeked. what they play follows from the seed alone (as long as intensity &
+    grain settings are left alone), so a seek starts again & renders up to the frame - it costs as much as playing
+    that far did.
 
-    sound->volume_range[0] = start;
-    sound->volume_range[1] = end;
-}
+    Offline rendering
 
-void ms_sound_set_pitch(ms_sound* sound, float pitch) {
-    if (pitch <= 0.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_pitch :: `pitch` must be greater than 0" << std::endl;
-        #endif
-    }
+    ms_render() plays soundscapes into a wav file as fast as the cpu allows rather than as fast as a device asks.
+    the engine has to be made with `noDevice` so nothing else pulls from it. engine time only moves as frames are
+    read, so it's the clock: every MS_RENDER_BLOCK frames each soundscape is ticked, then the next block is mixed,
+    exactly as if a device with that period were running.
 
-    sound->pitch_range[0] = pitch;
-    sound->pitch_range[1] = pitch;
-}
+        config.noDevice = MA_TRUE;
+        ...
+        ms_render_stats stats;
+        ms_render(&garden, "garden_bed.wav", 600.0, &stats); // ten minutes of the garden
+        printf("%.0fx real time\n", stats.realtime_factor);
 
-void ms_sound_set_pitch(ms_sound* sound, float start, float end) {
-    if (start < end) { // swap start and end
-        float p0 = start;
-        float p1 = end;
-        start = p1;
+    miniaudio's encoder only writes wav, so a .flac path fails with MA_FORMAT_NOT_SUPPORTED. see
+    examples/render_soundscape.cpp.
+
+    Deterministic renders
+
+    nothing in minisoundscape calls rand(). its random choices come from a generator of its own that ms_seed() starts
+    over, ambiences & granular beds follow their own seeds, and under ms_render() the engine's clock is the frames
+    mixed so far, a block of MS_RENDER_BLOCK at a time. seed, build the soundscapes on a fresh engine & render, and
+    the file comes out the same every time, to the bit for float (integer renders are dithered from a fixed seed too).
+
+        ms_seed(1);
+        ...
+        ms_render(&garden, "garden.wav", 4.0);
+
+    examples/golden.cpp renders a few reference soundscapes like this and compares them against the files in
+    examples/golden/, so a change to mixing or resampling that alters the sound shows up as a failure.
+
+    Parallel rendering
+
+    miniaudio mixes an engine's whole graph on the one thread that reads it, so one heavy soundscape holds up the rest.
+    an ms_parallel splits soundscapes over submixes, each an engine of its own, and renders the submixes of a block on
+    a pool of threads. every thread has a queue of submixes and steals from the others' once its own is empty, then
+    the reading thread sums them in order. the submixes share one resource manager, so a file is decoded once.
+
+        ms_parallel parallel;
+        ms_parallel_init(&parallel, 4);                       // the reading thread & three workers
+        ma_engine* forest = ms_parallel_add_submix(&parallel);
+        ma_engine* city   = ms_parallel_add_submix(&parallel);
+        ms_soundscape_init("birds", forest, "birds.wav", &birds, 1, &tits);
+        ms_soundscape_init("traffic", city, "traffic.wav", &traffic, 1, &horns);
+        ms_parallel_add_soundscape(&parallel, &birds);        // ticked by ms_parallel_tick() from now on
+        ms_parallel_add_soundscape(&parallel, &traffic);
+        ...
+        ma_sound_init_from_data_source(&engine, &parallel, MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_NO_PITCH, NULL, &mix);
+        ...
+        ms_parallel_tick(&parallel);                          // every frame, on the game thread
+
+    reading it only renders & sums, so it can be played through a device's engine as above: the soundscapes are ticked
+    on the game thread by ms_parallel_tick(), like ms_soundscape_tick() on its own, and never by the threads that mix.
+    it can also be read directly with ms_parallel_read(). ticked between reads of MS_RENDER_BLOCK frames, the mix
+    comes out the same to the bit however many threads there are. a pooled block that takes longer than its deadline
+    (half its length, see ms_parallel_set_deadline()) counts as missed. after MS_PARALLEL_MISSES in a row the reading
+    thread renders every submix itself for MS_PARALLEL_SIT_OUT blocks and then tries the pool again. the reading thread
+    never waits on the pool for longer than the block lasts: a submix still rendering by then is dropped from the block,
+    counted in ms_parallel_stats::dropped, and sits out every block until it's caught up. each submix has its own
+    listener. examples/bench_parallel.cpp mixes the same soundscapes on 1 to 8 threads.
+
+    Metrics
+
+    while MS_VERBOSE prints from wherever it is, the metrics are counters kept as relaxed atomics: voices started &
+    rejected, ticks, files loaded, failed & found already in memory, scene commands dropped and the bytes of audio
+    data resident. ms_metrics_get() copies them out along with how many voices each soundscape has playing, without
+    ever making the audio thread wait, so a HUD can draw them every frame.
+
+        ms_metrics_snapshot m = ms_metrics_get();
+        printf("%llu started, %lld kB resident\n", m.voices_started, m.bytes_resident / 1024);
+
+    to find the files that make startup slow or memory heavy, ms_metrics_profile_loads(true) keeps an ms_load_record
+    for every file ms_sound_init() & ms_soundscape_init() open: its format, channels, rate & length, the time spent
+    opening it, the bytes read from disk & held in memory, and what it would take fully decoded.
+    ms_metrics_take_loads() hands them over. examples/inspect_soundscape.cpp prints them for a directory.
+
+    Node profiling
+
+    with MS_PROFILE_NODES defined, every node minisoundscape adds to the engine's graph is timed for every block:
+    each sound's voices (decoding, resampling & spatializing them), its occlusion filter, each soundscape's ambient &
+    bed and the ambisonic & speaker array nodes. each node's vtable is swapped for a copy that times the original's
+    onProcess, so that's a clock read either side & nothing else on the audio thread. the swap happens before the node
+    is attached, so the audio thread never sees it half done: nodes miniaudio would attach as they're made are made
+    with MS_NODE_PROFILE_FLAGS while profiling, then attached. real time is the engine's clock, not a timed endpoint,
+    which is in the graph from the start. the time is a node's own work, what it spends mixing its inputs isn't counted. ms_metrics_get() then adds it up per
+    soundscape as a share of all the time measured and as a fraction of real time, and lists the nodes, costliest
+    first. nodes no soundscape owns, like the ambisonic bus, are listed with an empty soundscape. the timings add up
+    until ms_metrics_reset().
+
+        for (const ms_metrics_soundscape& s : ms_metrics_get().soundscapes) {
+            printf("%s | %.0f%% of dsp, %.1f%% of a core\n", s.name.c_str(), 100 * s.dsp_share, 100 * s.dsp_load);
+        }
+
+    Tracing
+
+    with MS_TRACE defined, loads, decodes, ms_sound_start() calls, ticks, fades and scene blocks are recorded as
+    timestamped spans into a buffer per thread, which that thread alone writes to & never waits on. fades are
+    recorded when they're set, lasting as long as they were given. the engine's device callback is traced too if
+    ms_trace_data_callback() is handed to it. ms_trace_write() saves whatever has been recorded since it was last
+    called as chrome trace event json, so the ui & audio threads can be lined up in chrome://tracing or perfetto.
+
+        config.dataCallback = ms_trace_data_callback;
+        ms_trace_thread_name("ui");
+        ...
+        ma_uint64 start = ms_trace_begin();
+        draw();
+        ms_trace_end("draw", start);                 // the game's own spans go on the same timeline
+        ...
+        ms_trace_write("hitch.json");
+
+    without MS_TRACE the calls compile away.
+
+
+*/
+
+// level of detail needs both soundscapes (for the bed) and spatialization
+#if !defined(MS_NO_SPATIALIZATION) && !defined(MS_NO_SOUNDSCAPE) && !defined(MS_NO_LOD)
+    #define MS_HAS_LOD
+#endif
+
+#if !defined(MS_NO_SPATIALIZATION) && !defined(MS_NO_OCCLUSION)
+    #define MS_HAS_OCCLUSION
+#endif
+
+#if !defined(MS_NO_SPATIALIZATION) && !defined(MS_NO_AMBISONICS)
+    #define MS_HAS_AMBISONICS
+#endif
+
+#if !defined(MS_NO_SPATIALIZATION) && !defined(MS_NO_SPEAKER_ARRAY)
+    #define MS_HAS_SPEAKER_ARRAY
+#endif
+
+#ifndef MS_NO_AMBIENCE
+    #define MS_HAS_AMBIENCE
+#endif
+
+#ifndef MS_NO_METRICS
+    #define MS_HAS_METRICS
+#endif
+
+#ifndef MS_NO_FAST_PATHS
+    #define MS_HAS_FAST_PATHS
+#endif
+
+// submixes are ticked as soundscapes
+#if !defined(MS_NO_SOUNDSCAPE) && !defined(MS_NO_PARALLEL)
+    #define MS_HAS_PARALLEL
+#endif
+
+// node timings are reported through the metrics
+#if defined(MS_PROFILE_NODES) && !defined(MS_HAS_METRICS)
+    #undef MS_PROFILE_NODES
+#endif
+
+typedef struct ms_sound         ms_sound;
+typedef struct ms_sound_table   ms_sound_table;
+typedef ma_uint32               ms_sound_handle;
+typedef struct ms_soundscape    ms_soundscape;
+typedef struct ms_sound_speaker ms_sound_speaker;
+typedef struct ms_scene         ms_scene;
+typedef struct ms_path          ms_path;
+typedef struct ms_entity        ms_entity;
+typedef struct ms_occlusion_grid ms_occlusion_grid;
+typedef struct ms_param_batch   ms_param_batch;
+typedef struct ms_ambisonic_bus  ms_ambisonic_bus;
+typedef struct ms_ambisonic_encoder ms_ambisonic_encoder;
+typedef struct ms_ambisonic_voice ms_ambisonic_voice;
+typedef struct ms_speaker_array  ms_speaker_array;
+typedef struct ms_speaker_panner ms_speaker_panner;
+typedef struct ms_speaker_voice  ms_speaker_voice;
+typedef struct ms_ambience       ms_ambience;
+typedef struct ms_parallel       ms_parallel;
+
+/* --- ms_metrics --- */
+
+#ifdef MS_HAS_METRICS
+// what opening one file took, see ms_metrics_profile_loads()
+struct ms_load_record {
+    std::string path;
+    std::string owner;       // the ms_sound or soundscape that opened it
+    ma_result result;
+    ma_format format;        // as stored in the file
+    ma_uint32 channels;
+    ma_uint32 sample_rate;
+    ma_uint64 frames;
+    double duration;         // seconds it plays for
+    double load_seconds;     // spent in ma_sound_init_from_file()
+    size_t file_bytes;       // read from disk
+    size_t resident_bytes;   // held by miniaudio from now on, 0 when an earlier load already holds the file
+    size_t decoded_bytes;    // it would take decoded to float at the engine's rate, as MA_SOUND_FLAG_DECODE does
+};
+
+#ifdef MS_PROFILE_NODES
+// one node being timed. its vtable is swapped for `wrapped`, a copy whose onProcess times the original's, so the
+// audio thread gets from the node to its record without looking anything up
+struct ms_node_profile {
+    ma_node_vtable wrapped;          // has to come first
+    const ma_node_vtable* original;
+    ma_node* node;
+    ma_node_graph* graph;            // the engine's it was made in
+    std::string name;
+    const ms_sound* sound;           // whose voices or filter it is, the soundscape is looked up when it's read
+    const ms_soundscape* soundscape; // ... or whose ambient or bed. neither for nodes soundscapes share
+    ma_engine* engine;               // set on the one record per engine that keeps its clock rather than timing a node
+    ma_uint64 clock_start;           // ... the engine's time when it was started or reset
+    std::atomic<ma_uint64> ns;       // audio thread, spent in the original onProcess
+    std::atomic<ma_uint64> frames;   // audio thread, frames it put out
+    ma_uint64 tiered_ns;             // game thread, how much of `ns` ms_soundscape_update_lod() has put in a tier
+};
+#endif
+
+// counters every part of minisoundscape bumps as it goes, relaxed atomics so any thread can read them mid-flight
+struct ms_metrics {
+    std::atomic<ma_uint64> voices_started;   // variants ms_sound_start() started
+    std::atomic<ma_uint64> voices_rejected;  // ms_sound_start() calls that started nothing, the sound was playing or had no variants
+    std::atomic<ma_uint64> ticks;            // soundscape ticks that went on to play a sound
+    std::atomic<ma_uint64> loads;            // files opened
+    std::atomic<ma_uint64> load_failures;
+    std::atomic<ma_uint64> cache_hits;       // opened files miniaudio already had in memory for another sound
+    std::atomic<ma_uint64> commands_dropped; // scene commands lost to a full ring
+    std::atomic<ma_int64>  bytes_resident;   // audio data held for loaded files & granular clips
+    bool profile_loads;                      // game thread, keep an ms_load_record for every file ms_sound_init() & ms_soundscape_init() open
+    vector<ms_load_record> load_records;
+    #ifdef MS_PROFILE_NODES
+    vector<ms_node_profile*> nodes;          // game thread, every node being timed
+    #endif
+    #ifndef MS_NO_SOUNDSCAPE
+    vector<const ms_soundscape*> soundscapes; // game thread, every soundscape between init & uninit
+    #endif
+};
+
+static ms_metrics g_ms_metrics;
+
+typedef struct {
+    std::string name;
+    unsigned int voices; // variants playing, the ambient included
+    double dsp_seconds;  // spent processing its nodes, 0 without MS_PROFILE_NODES
+    double dsp_share;    // ... as a share of all the node time measured
+    double dsp_load;     // ... as a fraction of the audio mixed meanwhile, 1.0 would be a whole core
+} ms_metrics_soundscape;
+
+// one sound, ambient, bed or shared node's processing, see "Node profiling"
+typedef struct {
+    std::string name;       // the sound's, "<soundscape> ambient", "ambisonic bus", ...
+    std::string soundscape; // empty for nodes soundscapes share
+    double seconds;
+    double share;
+    double load;
+} ms_metrics_node;
+
+// a copy of the counters at one moment, see ms_metrics_get()
+struct ms_metrics_snapshot {
+    ma_uint64 voices_started;
+    ma_uint64 voices_rejected;
+    ma_uint64 ticks;
+    ma_uint64 loads;
+    ma_uint64 load_failures;
+    ma_uint64 cache_hits;
+    ma_uint64 commands_dropped;
+    ma_int64  bytes_resident;
+    vector<ms_metrics_soundscape> soundscapes;
+    double dsp_seconds;           // spent in timed nodes, these three only with MS_PROFILE_NODES
+    double audio_seconds;         // audio the engines mixed meanwhile
+    vector<ms_metrics_node> nodes; // costliest first
+};
+
+#define MS_METRIC_ADD(counter, amount) g_ms_metrics.counter.fetch_add(amount, std::memory_order_relaxed)
+#else
+#define MS_METRIC_ADD(counter, amount)
+#endif /* MS_HAS_METRICS */
+
+// nodes miniaudio would attach to the endpoint as they're made are made unattached while they're timed, so the
+// vtable is swapped before the audio thread can reach them. ms_node_profile_attach() attaches them after
+#ifdef MS_PROFILE_NODES
+#define MS_NODE_PROFILE_FLAGS MA_SOUND_FLAG_NO_DEFAULT_ATTACHMENT
+#else
+#define MS_NODE_PROFILE_FLAGS 0
+#endif
+
+/* --- ms_trace --- */
+
+#ifdef MS_TRACE
+struct ms_trace_event {
+    const char* name;   // has to outlive the write, so string literals only
+    char detail[24];    // which sound, file or soundscape, copied & cut short
+    char phase;         // 'X' a span, 'i' an instant
+    ma_uint64 start;    // nanoseconds
+    ma_uint64 duration;
+};
+
+// one per thread, only that thread writes to it. the same ring as the scene's commands: dropping when full rather
+// than waiting, emptied by ms_trace_write()
+struct ms_trace_thread {
+    ms_trace_event events[MS_TRACE_CAPACITY];
+    std::atomic<ma_uint32> write;
+    std::atomic<ma_uint32> read;
+    std::atomic<ma_uint32> dropped;
+    std::atomic<bool> owned; // by a running thread, handed back when it exits
+    std::atomic<bool> used;  // ever, so ms_trace_write() can skip the rest
+    char name[16];
+};
+
+// hands the calling thread's buffer back when the thread exits, so threads that come & go (an ms_parallel pool
+// being restarted, say) don't use up MS_TRACE_THREADS
+struct ms_trace_slot {
+    ms_trace_thread* thread = nullptr;
+    ~ms_trace_slot() {
+        if (thread != nullptr) thread->owned.store(false, std::memory_order_release);
+    }
+};
+
+static ms_trace_thread g_ms_trace_threads[MS_TRACE_THREADS];
+static thread_local ms_trace_slot t_ms_trace;
+
+static inline ma_uint64 ms_trace_now() {
+    return (ma_uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const ma_uint64 g_ms_trace_epoch = ms_trace_now(); // timestamps are written relative to this
+
+// the calling thread's buffer, claimed on its first event. a buffer a thread has handed back is only claimed again
+// once ms_trace_write() has emptied it, so its events aren't put down to the next thread. nullptr while every one
+// is taken or waiting to be written
+static inline ms_trace_thread* ms_trace_this_thread() {
+    if (t_ms_trace.thread != nullptr) return t_ms_trace.thread;
+
+    for (ma_uint32 t = 0; t < MS_TRACE_THREADS; t++) {
+        ms_trace_thread& thread = g_ms_trace_threads[t];
+        bool owned = false;
+        if (!thread.owned.compare_exchange_strong(owned, true, std::memory_order_acq_rel)) continue;
+        if (thread.read.load(std::memory_order_acquire) != thread.write.load(std::memory_order_relaxed)) {
+            thread.owned.store(false, std::memory_order_release);
+            continue;
+        }
+        thread.name[0] = 0;
+        thread.used.store(true, std::memory_order_release);
+        t_ms_trace.thread = &thread;
+        return &thread;
+    }
+    return nullptr;
+}
+
+static inline void ms_trace_record(const char* name, char phase, ma_uint64 start, ma_uint64 duration, const char* detail) {
+    ms_trace_thread* thread = ms_trace_this_thread();
+    if (thread == nullptr) return;
+
+    ma_uint32 write = thread->write.load(std::memory_order_relaxed);
+    if (write - thread->read.load(std::memory_order_acquire) >= MS_TRACE_CAPACITY) {
+        thread->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ms_trace_event& event = thread->events[write & (MS_TRACE_CAPACITY - 1)];
+    event.name     = name;
+    event.phase    = phase;
+    event.start    = start;
+    event.duration = duration;
+    event.detail[0] = 0;
+    if (detail != nullptr) {
+        size_t length = strlen(detail);
+        if (length > sizeof(event.detail) - 1) {
+            detail += length - (sizeof(event.detail) - 1); // the end of a path says more than its start
+            length  = sizeof(event.detail) - 1;
+        }
+        memcpy(event.detail, detail, length);
+        event.detail[length] = 0;
+    }
+    thread->write.store(write + 1, std::memory_order_release);
+}
+#endif /* MS_TRACE */
+
+// the start of a span, closed by ms_trace_end(). any thread, costs a clock read & compiles away without MS_TRACE
+static inline ma_uint64 ms_trace_begin() {
+    #ifdef MS_TRACE
+        return ms_trace_now();
+    #else
+        return 0;
+    #endif
+}
+
+static inline void ms_trace_end(const char* name, ma_uint64 start, const char* detail = nullptr) {
+    #ifdef MS_TRACE
+        ms_trace_record(name, 'X', start, ms_trace_now() - start, detail);
+    #else
+        (void)name;
+        (void)start;
+        (void)detail;
+    #endif
+}
+
+static inline void ms_trace_instant(const char* name, const char* detail = nullptr) {
+    #ifdef MS_TRACE
+        ms_trace_record(name, 'i', ms_trace_now(), 0, detail);
+    #else
+        (void)name;
+        (void)detail;
+    #endif
+}
+
+// a span starting now that's known to last `seconds`, e.g. a fade miniaudio carries out on its own
+static inline void ms_trace_ahead(const char* name, double seconds, const char* detail = nullptr) {
+    #ifdef MS_TRACE
+        ms_trace_record(name, 'X', ms_trace_now(), (ma_uint64)(seconds * 1e9), detail);
+    #else
+        (void)name;
+        (void)seconds;
+        (void)detail;
+    #endif
+}
+
+// what the calling thread is called in the trace, e.g. "ui". the thread running ms_trace_data_callback() is "audio"
+static inline void ms_trace_thread_name(const char* name) {
+    #ifdef MS_TRACE
+        ms_trace_thread* thread = ms_trace_this_thread();
+        if (thread == nullptr) return;
+        strncpy(thread->name, name, sizeof(thread->name) - 1);
+    #else
+        (void)name;
+    #endif
+}
+
+/* --- ms_arena --- */
+
+// a bump allocator. a sound's variants are carved from its arena next to each other, as are a soundscape's ambient &
+// bed, rather than new'd one at a time. ms_arena_release() hands them all back at once
+struct ms_arena {
+    vector<void*> blocks;
+    size_t used     = 0; // bytes taken from the last block
+    size_t capacity = 0; // ... out of
+};
+
+// `size` zeroed bytes starting on a cache line. nothing is constructed, it's for miniaudio's plain structs
+static void* ms_arena_alloc(ms_arena* arena, size_t size) {
+    size = (size + 63) & ~(size_t)63;
+    if (arena->blocks.empty() || arena->used + size > arena->capacity) {
+        size_t capacity = (size > MS_ARENA_BLOCK) ? size : MS_ARENA_BLOCK;
+        void* block = ma_aligned_malloc(capacity, 64, NULL);
+        if (block == NULL) return nullptr;
+        arena->blocks.push_back(block);
+        arena->used     = 0;
+        arena->capacity = capacity;
+    }
+    void* allocation = (unsigned char*)arena->blocks.back() + arena->used;
+    arena->used += size;
+    memset(allocation, 0, size);
+    return allocation;
+}
+
+template <typename T>
+static T* ms_arena_new(ms_arena* arena, size_t count = 1) {
+    return (T*)ms_arena_alloc(arena, sizeof(T) * count);
+}
+
+// everything carved from `arena` goes at once, uninitialise what's in it first
+static void ms_arena_release(ms_arena* arena) {
+    for (void* block : arena->blocks) ma_aligned_free(block, NULL);
+    arena->blocks.clear();
+    arena->used     = 0;
+    arena->capacity = 0;
+}
+
+// how far `arena` has got, for ms_arena_rewind() to go back to
+struct ms_arena_mark {
+    size_t blocks;
+    size_t used;
+    size_t capacity;
+};
+
+static inline ms_arena_mark ms_arena_get_mark(const ms_arena* arena) {
+    return { arena->blocks.size(), arena->used, arena->capacity };
+}
+
+// everything carved from `arena` since `mark` goes, uninitialise what's in it first
+static inline void ms_arena_rewind(ms_arena* arena, ms_arena_mark mark) {
+    while (arena->blocks.size() > mark.blocks) {
+        ma_aligned_free(arena->blocks.back(), NULL);
+        arena->blocks.pop_back();
+    }
+    arena->used     = mark.used;
+    arena->capacity = mark.capacity;
+}
+
+/* --- ms_id --- */
+
+// a name interned once, so sounds & soundscapes are told apart by comparing integers rather than strings
+typedef ma_uint32 ms_id;
+#define MS_ID_NONE 0
+
+// every name interned so far by id - 1, and the hash index from name back to id. only the init functions & tools
+// touch it, on the game thread
+struct ms_id_registry {
+    vector<std::string> names;
+    std::unordered_map<std::string, ms_id> ids;
+};
+
+static ms_id_registry g_ms_ids;
+
+// the id of `name`, interning it the first time it's seen. the same name always gets the same id
+ms_id ms_intern(const std::string& name) {
+    auto found = g_ms_ids.ids.find(name);
+    if (found != g_ms_ids.ids.end()) return found->second;
+
+    g_ms_ids.names.push_back(name);
+    ms_id id = (ms_id)g_ms_ids.names.size();
+    g_ms_ids.ids.emplace(name, id);
+    return id;
+}
+
+// the id of `name` if anything has been given that name, MS_ID_NONE otherwise. nothing is interned
+ms_id ms_lookup(const std::string& name) {
+    auto found = g_ms_ids.ids.find(name);
+    return (found != g_ms_ids.ids.end()) ? found->second : MS_ID_NONE;
+}
+
+// the name `id` was interned from, "" for MS_ID_NONE
+const std::string& ms_id_name(ms_id id) {
+    static const std::string none;
+    return (id == MS_ID_NONE || id > g_ms_ids.names.size()) ? none : g_ms_ids.names[id - 1];
+}
+
+/* --- ms_node_profile --- */
+
+#ifdef MS_PROFILE_NODES
+static void ms_node_profile_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut) {
+    ms_node_profile* profile = (ms_node_profile*)((ma_node_base*)pNode)->vtable;
+
+    auto start = std::chrono::steady_clock::now();
+    profile->original->onProcess(pNode, ppFramesIn, pFrameCountIn, ppFramesOut, pFrameCountOut);
+    ma_uint64 elapsed = (ma_uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    profile->ns.fetch_add(elapsed, std::memory_order_relaxed);
+    profile->frames.fetch_add(*pFrameCountOut, std::memory_order_relaxed);
+}
+#endif
+
+// start timing `node`, which plays for `sound` or belongs to `soundscape`. game thread, compiles away without
+// MS_PROFILE_NODES. the node must not be attached yet, the audio thread would be reading the vtable that's swapped
+// here: make it with MS_NODE_PROFILE_FLAGS & attach it after. a node already being timed is left as it is
+static void ms_node_profile_watch(ma_node* node, const std::string& name, const ms_sound* sound, const ms_soundscape* soundscape) {
+    #ifdef MS_PROFILE_NODES
+        ma_node_base* base = (ma_node_base*)node;
+        ms_node_profile* profile = nullptr;
+        for (ms_node_profile* p : g_ms_metrics.nodes) {
+            if (p->node == node && p->engine == nullptr) profile = p;
+        }
+        if (profile != nullptr && base->vtable == &profile->wrapped) return;
+
+        // a node at the address of one that's gone without being forgotten
+        if (profile == nullptr) {
+            profile = new ms_node_profile;
+            g_ms_metrics.nodes.push_back(profile);
+        }
+        profile->original          = base->vtable;
+        profile->wrapped           = *base->vtable;
+        profile->wrapped.onProcess = ms_node_profile_process;
+        profile->node              = node;
+        profile->graph             = ma_node_get_node_graph(node);
+        profile->name              = name;
+        profile->sound             = sound;
+        profile->soundscape        = soundscape;
+        profile->engine            = nullptr;
+        profile->clock_start       = 0;
+        profile->tiered_ns         = 0;
+        profile->ns.store(0, std::memory_order_relaxed);
+        profile->frames.store(0, std::memory_order_relaxed);
+        base->vtable = &profile->wrapped;
+    #else
+        (void)node;
+        (void)name;
+        (void)sound;
+        (void)soundscape;
+    #endif
+}
+
+// attach `node`, made with MS_NODE_PROFILE_FLAGS & then watched, to the endpoint as miniaudio would have
+static void ms_node_profile_attach(ma_engine* engine, ma_node* node) {
+    #ifdef MS_PROFILE_NODES
+        ma_node_attach_output_bus(node, 0, ma_engine_get_endpoint(engine), 0);
+    #else
+        (void)engine;
+        (void)node;
+    #endif
+}
+
+// keep `engine`'s clock, which the time spent in its nodes is measured against. the engine's time is read rather
+// than its endpoint timed, the endpoint is already in the graph & may be processing. kept until the last node timed
+// in the engine is forgotten
+static void ms_node_profile_watch_engine(ma_engine* engine) {
+    #ifdef MS_PROFILE_NODES
+        for (ms_node_profile* p : g_ms_metrics.nodes) {
+            if (p->engine == engine) return;
+        }
+        ms_node_profile* profile = new ms_node_profile;
+        profile->original    = nullptr;
+        profile->node        = ma_engine_get_endpoint(engine);
+        profile->graph       = ma_engine_get_node_graph(engine);
+        profile->name        = "endpoint";
+        profile->sound       = nullptr;
+        profile->soundscape  = nullptr;
+        profile->engine      = engine;
+        profile->clock_start = ma_engine_get_time_in_pcm_frames(engine);
+        profile->tiered_ns   = 0;
+        profile->ns.store(0, std::memory_order_relaxed);
+        profile->frames.store(0, std::memory_order_relaxed);
+        g_ms_metrics.nodes.push_back(profile);
+    #else
+        (void)engine;
+    #endif
+}
+
+// stop timing `node`, once it's been uninitialised
+static void ms_node_profile_forget(const ma_node* node) {
+    #ifdef MS_PROFILE_NODES
+        vector<ms_node_profile*>& nodes = g_ms_metrics.nodes;
+        ma_node_graph* graph = nullptr;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->node != node || nodes[i]->engine != nullptr) continue;
+            graph = nodes[i]->graph;
+            delete nodes[i];
+            nodes.erase(nodes.begin() + i);
+            break;
+        }
+        if (graph == nullptr) return;
+
+        // the engine's clock goes with the last of its nodes, which have to be uninitialised before the engine
+        for (const ms_node_profile* p : nodes) {
+            if (p->graph == graph && p->engine == nullptr) return;
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->graph != graph) continue;
+            delete nodes[i];
+            nodes.erase(nodes.begin() + i);
+            return;
+        }
+    #else
+        (void)node;
+    #endif
+}
+
+/* --- ms_lod --- */
+
+#ifdef MS_HAS_LOD
+typedef enum {
+    MS_LOD_NEAR,
+    MS_LOD_MID,
+    MS_LOD_FAR
+} ms_lod_tier;
+
+struct ms_lod_stats {
+    unsigned int voices[3];   // playing voices per tier, indexed by ms_lod_tier
+    ma_uint64 voice_frames[3]; // frames played by the voices of each tier, added up over the voices. a count, not a cost
+    double dsp_seconds[3];    // measured time spent on the voices of each tier. mid & far are always timed by the bed,
+                              // near only with MS_PROFILE_NODES
+    ma_uint64 last_update;    // engine time of the last ms_soundscape_update_lod() call
+};
+
+struct ms_sound;
+
+#define MS_LOD_BED_MAX_CHANNELS 8 // voices whose data source has more channels than this stay near
+
+// a miniaudio node, `base` has to come first. a soundscape's mid & far voices are detached from the graph & read
+// here straight from their data sources, mixed down to mono & resampled linearly. far voices are summed into one
+// centred signal, mid voices are panned onto the first two channels. no inputs, one output with the engine's channels
+struct ms_lod_bed {
+    ma_node_base base;
+    ma_uint32 channels;
+    ma_uint32 sample_rate;
+    std::atomic<ma_uint32> epoch{0}; // odd while the audio thread is mixing, see ms_lod_bed_remove()
+    std::atomic<ma_uint64> ns[3];    // audio thread, time spent mixing mid & far voices, indexed by ms_lod_tier
+    ma_uint64 taken_ns[3];           // game thread, how much of `ns` ms_soundscape_update_lod() has counted
+
+    // game thread
+    ma_uint32 free_slots[MS_LOD_BED_VOICES];
+    ma_uint32 free_count;
+    ms_sound* sounds[MS_LOD_BED_VOICES]; // whose voice is in each slot
+
+    // set by the game thread before `voices`, which publishes them
+    std::atomic<ma_sound*> voices[MS_LOD_BED_VOICES];
+    std::atomic<float> gains[MS_LOD_BED_VOICES]; // attenuation at the voice's distance, its own volume goes on top
+    std::atomic<float> pans[MS_LOD_BED_VOICES];  // how far to the listener's right it is, mid voices only
+    std::atomic<bool> far[MS_LOD_BED_VOICES];
+    ma_format formats[MS_LOD_BED_VOICES];        // of the voice's data source
+    ma_uint32 source_channels[MS_LOD_BED_VOICES];
+    ma_uint32 source_rates[MS_LOD_BED_VOICES];
+
+    // audio thread, where the last block left each slot
+    ma_sound* previous[MS_LOD_BED_VOICES]; // a new voice starts from silence & jumps straight to its gains
+    float applied[MS_LOD_BED_VOICES][2];   // left & right gains
+    float x0[MS_LOD_BED_VOICES];           // the two source frames the next output frame falls between
+    float x1[MS_LOD_BED_VOICES];
+    ma_uint64 t[MS_LOD_BED_VOICES];        // ... & how far from x0 to x1, 32.32 fixed point
+
+    // audio thread scratch
+    unsigned char raw[MS_LOD_BED_CHUNK * MS_LOD_BED_MAX_CHANNELS * sizeof(float)];
+    float converted[MS_LOD_BED_CHUNK * MS_LOD_BED_MAX_CHANNELS];
+    float mono[MS_LOD_BED_CHUNK + 2]; // after the frames x0 & x1 of the slot being read
+    float resampled[MS_LOD_BED_CHUNK];
+    float far_sum[MS_LOD_BED_CHUNK];
+};
+#endif /* MS_HAS_LOD */
+
+/* --- ms_sound --- */
+
+// the parts of miniaudio's processing a sound's voices need, see ms_sound_classify()
+#define MS_SOUND_STAGE_PITCH       1 // the variants were made with the resampler, see ms_sound_add_pitch_stage()
+#define MS_SOUND_STAGE_SPATIALIZER 2 // spatialized & placed away from the listener, by speakers, a scene or a position
+
+struct ms_sound {
+    std::string name;
+    ms_id id = MS_ID_NONE; // `name` interned
+    bool empty = false;    // made by ms_sound_init_empty(), a silence that's never started
+    int weight;
+    vector<ma_sound*> sounds;
+    ms_arena arena; // `sounds` live here
+    // ranges work as an array of size 2. the 0th item is the start of the range, and the 1st item is the end of the range
+    // e.g. setting `pan_range` to `{ -0.5, 0.5 }` would mean that panning will be randomly chosen from -0.5 to 0.5
+    float pan_range[2];
+    float pitch_range[2];
+    float volume_range[2];
+    // the variant picked by the last ms_sound_start() along with the volume & pan it was given
+    int active = -1;
+    float active_volume = 1.0f;
+    float active_pan = 0.0f;
+    #ifndef MS_NO_SPATIALIZATION
+    vector<ms_sound_speaker*> speakers;
+    bool spatialized = false; // what the user asked for - level of detail may still switch the spatializer off
+    ms_scene* scene = nullptr; // set when the sound is moved by an emitter
+    int emitter = -1;
+    const ms_path* path = nullptr;
+    bool positioned = false; // placed with ms_sound_set_position()
+    ms_scene* stranded = nullptr; // the scene whose ring had no room to remove its emitter yet, see ms_scene_defer_remove()
+    #endif
+    bool repitched = false; // given a pitch other than 1 by ms_scene_set_params(), keeps the resampler from then on
+    ms_scene* reached_by = nullptr; // the scene whose ring last named one of its voices, in a batch or to an emitter
+    ma_uint32 reached_until = 0;    // ... & that command. the voices are only freed once the audio thread is past it
+    vector<ma_sound*> handed_over;  // variants replaced by ms_sound_add_pitch_stage() while playing, fading out until the sound goes
+    ma_uint32 stages = 0; // the MS_SOUND_STAGE_* its variants go through, see ms_sound_classify()
+    #ifdef MS_HAS_OCCLUSION
+    ma_lpf_node* occlusion = nullptr; // every variant feeds this filter when the sound is occluded
+    #endif
+    #ifdef MS_HAS_AMBISONICS
+    ms_ambisonic_voice* ambisonic = nullptr; // every variant (or the occlusion filter) feeds this slot of an encoder
+    #endif
+    #ifdef MS_HAS_SPEAKER_ARRAY
+    ms_speaker_voice* speaker_array = nullptr; // ... or this slot of a speaker array's panner
+    #endif
+    #ifdef MS_HAS_LOD
+    ms_lod_tier lod_tier = MS_LOD_NEAR; // anything but near means its playing variant is in `bed`
+    ms_lod_bed* bed = nullptr;
+    ma_uint32 bed_slot = 0;
+    #endif
+    ms_sound_table* table = nullptr; // the table mirroring this sound, see ms_sound_table_add()
+    ms_sound_handle handle = 0;      // ... & where in it
+};
+
+typedef enum {
+    WAV,
+    MP3,
+    FLAC
+} ms_sound_filetype;
+
+// what starting a sound picks: which variant & the volume, pan & pitch it plays at
+typedef struct {
+    ma_uint32 variant;
+    float volume;
+    float pan;
+    float pitch;
+} ms_sound_choice;
+
+/* --- ms_sound_table --- */
+
+#define MS_SOUND_TABLE_EMPTY 1 // a placeholder from ms_sound_init_empty(), never started
+#define MS_SOUND_HANDLE_NONE 0xFFFFFFFF
+
+// the part of many sounds that starting them reads, one array per field & indexed by handle: ranges, weights, flags &
+// where each sound's variants sit in `variants`. ms_sound_table_start() makes the choices for a whole batch of sounds
+// in one pass over these rather than chasing each ms_sound's pointers
+struct ms_sound_table {
+    vector<ms_sound*> sounds; // handle -> the sound it mirrors
+    vector<ms_id> ids;
+    vector<float> volume_start, volume_end;
+    vector<float> pan_start, pan_end;
+    vector<float> pitch_start, pitch_end;
+    vector<ma_uint32> weight;
+    vector<ma_uint32> flags;
+    vector<ma_uint32> variant_first;
+    vector<ma_uint32> variant_count;
+    vector<ma_sound*> variants;       // every sound's variants back to back
+    vector<ms_sound_choice> choices;  // ms_sound_table_start()'s scratch, kept to save allocating
+    vector<ma_uint32> chosen;
+};
+
+/* --- ms_soundscape --- */
+
+#ifndef MS_NO_SOUNDSCAPE
+struct ms_soundscape {
+    std::string name;
+    ms_id id = MS_ID_NONE; // `name` interned
+    ma_sound* ambient;
+    ma_engine* engine;
+    vector<ms_sound*> sounds;
+    ms_arena arena; // the ambient & bed live here
+    ma_uint64 timeSinceLastTick; // long long
+    float tickrate;
+    #ifdef MS_HAS_LOD
+    ms_lod_bed* bed; // mid & far voices are mixed by this node instead of the graph
+    float lod_near;
+    float lod_far;
+    ms_lod_stats lod_stats;
+    #endif
+};
+
+// what an ms_render() call did
+typedef struct {
+    ma_uint64 frames;       // written to the file
+    double audio_seconds;   // how long they play for
+    double wall_seconds;    // how long they took to make
+    double realtime_factor; // audio seconds made per second, above 1.0 is faster than real time
+} ms_render_stats;
+#endif /*  MS_NO_SOUNDSCAPE */
+
+/* --- ms_ambience --- */
+
+#ifdef MS_HAS_AMBIENCE
+typedef enum {
+    MS_AMBIENCE_RAIN,
+    MS_AMBIENCE_WIND,
+    MS_AMBIENCE_INSECTS
+} ms_ambience_type;
+
+// four biquads run side by side, one per lane of frames interleaved as lane0 lane1 lane2 lane3
+typedef struct {
+    float b0[4], b1[4], b2[4], a1[4], a2[4];
+    float z1[4], z2[4];
+} ms_biquad4;
+
+// a data source, `base` has to come first. stereo at MS_SAMPLE_RATE
+struct ms_ambience {
+    ma_data_source_base base;
+    ms_ambience_type type;
+    ma_uint32 sampleRate;
+    ma_uint32 seed;
+    ma_uint64 cursor;             // frames read since the start
+    std::atomic<float> intensity; // 0.0 to 1.0
+
+    ma_uint32 noise[4]; // one xorshift per lane
+    ma_uint32 random;   // slow decisions, gusts & phrases
+    ms_biquad4 filter;
+    float mix[4][2];    // how much of each lane goes left & right
+
+    // always a whole block is rendered, reads are served from here
+    float block[MS_AMBIENCE_BLOCK * 2];
+    ma_uint32 block_position;
+
+    // wind
+    float gust;
+    float gust_target;
+    ma_uint32 gust_left; // blocks until the next gust is picked
+
+    // insects
+    float phase[4], increment[4];             // carrier, in cycles
+    float pulse_phase[4], pulse_increment[4]; // chirps within a phrase, in cycles
+    float gate[4];                            // fades each insect in & out of its phrases
+    ma_uint32 phrase_left[4];                 // blocks until each insect starts or stops
+    ma_bool8 singing[4];
+};
+
+// a data source playing grains out of a short mono clip held in memory, `base` has to come first. stereo at
+// MS_SAMPLE_RATE. every stream plays one grain after another, each from a random place at a random pitch, length &
+// window. streams are kept as arrays so the per block bookkeeping across all of them vectorises
+struct ms_granular {
+    ma_data_source_base base;
+    ma_uint32 sampleRate;
+    float* clip;
+    ma_uint64 clipFrames;
+    ma_uint32 streams; // in use, the rest stay silent
+    ma_uint32 seed;
+    ma_uint32 random;
+    ma_uint64 cursor;  // frames read since the start
+
+    std::atomic<float> min_length;   // frames
+    std::atomic<float> max_length;   // frames
+    std::atomic<float> pitch_spread; // +- around the clip's own pitch
+
+    // per stream, the grain it's playing
+    ma_uint32 start[MS_GRANULAR_STREAMS];    // first clip frame it reads
+    float age[MS_GRANULAR_STREAMS];          // frames since it started, negative while waiting to
+    float inv_length[MS_GRANULAR_STREAMS];   // 1 / frames it lasts
+    float span[MS_GRANULAR_STREAMS];         // clip frames it reads, its length times its pitch
+    float shape[MS_GRANULAR_STREAMS];        // 0 a hann window, towards 1 a flatter top
+    float gain_left[MS_GRANULAR_STREAMS];
+    float gain_right[MS_GRANULAR_STREAMS];
+
+    float block[MS_AMBIENCE_BLOCK * 2];
+    ma_uint32 block_position;
+};
+#endif /* MS_HAS_AMBIENCE */
+
+/* --- ms_sound_speaker ---*/
+
+#ifndef MS_NO_SPATIALIZATION
+struct ms_sound_speaker {
+    std::string name;
+    double x;
+    double y;
+    double z;
+    ms_sound* sound;
+    const ms_path* path = nullptr; // sounds started here travel this path, offset by the speaker's position
+};
+#endif /* MS_NO_SPATIALIZATION */
+
+/* --- ms_path & ms_entity --- */
+
+#ifndef MS_NO_SPATIALIZATION
+typedef enum {
+    MS_PATH_LINE,  // straight lines between the points
+    MS_PATH_SPLINE // catmull-rom spline through the points
+} ms_path_type;
+
+typedef enum {
+    MS_PATH_ONCE,     // stop at the last point
+    MS_PATH_LOOP,     // jump back to the first point
+    MS_PATH_PING_PONG // travel back & forth
+} ms_path_mode;
+
+struct ms_path {
+    ms_path_type type;
+    ms_path_mode mode;
+    vector<ma_vec3f> points;
+    double duration; // seconds taken to travel from the first to the last point
+};
+
+// written by one thread at a time with ms_entity_set(), read by the audio thread. a sequence lock keeps reads consistent
+struct ms_entity {
+    std::atomic<ma_uint32> sequence{0};
+    std::atomic<float> position[3];
+    std::atomic<float> velocity[3];
+    std::atomic<ma_uint64> time{0}; // engine time the position was taken at
+};
+#endif /* MS_NO_SPATIALIZATION */
+
+/* --- ms_occlusion_grid --- */
+
+#ifdef MS_HAS_OCCLUSION
+struct ms_occlusion_grid {
+    ma_uint32 width;
+    ma_uint32 height;
+    float spacing;  // distance between the centres of neighbouring tiles
+    float origin_x; // centre of tile (0, 0)
+    float origin_z;
+    vector<float> transmission; // fraction of sound let through each tile, 1.0f is open & 0.0f is a solid wall
+
+    // gain & cutoff per tile as heard from `listener`. two copies, the audio thread reads `published` while the
+    // game thread refills the other one - but only once the audio thread has said it is done with it via `in_use`
+    vector<float> gain[2];
+    vector<float> cutoff[2];
+    std::atomic<int> published{0};
+    std::atomic<int> in_use{0};
+
+    // game thread only
+    int listener = -1;    // tile the listener was on at the last update
+    bool dirty = true;    // a tile lost transmission, everything needs flooding again
+    vector<ma_uint32> raised; // tiles that gained transmission since the last update, only these need re-flooding
+    vector<std::pair<float, ma_uint32> > heap;
+};
+#endif /* MS_HAS_OCCLUSION */
+
+/* --- ms_ambisonic_bus --- */
+
+#ifdef MS_HAS_AMBISONICS
+typedef enum {
+    MS_AMBISONIC_STEREO,
+    MS_AMBISONIC_BINAURAL,
+    MS_AMBISONIC_SPEAKERS
+} ms_ambisonic_decoder;
+
+// both are miniaudio nodes, `base` has to come first
+struct ms_ambisonic_bus {
+    ma_node_base base;
+    ma_engine* engine;
+    ma_uint32 order;
+    ma_uint32 channels; // (order + 1)^2, in ACN order with SN3D normalisation
+    ma_uint32 outputs;  // the engine's channels
+    ms_ambisonic_decoder decoder;
+
+    // one row per speaker (or virtual speaker when binaural), facing forward. rotated into `rotated` every block
+    ma_uint32 speakers;
+    float decode[MS_AMBISONIC_MAX_SPEAKERS][16];
+    float rotated[MS_AMBISONIC_MAX_SPEAKERS][16];
+
+    // binaural only, each virtual speaker reaches the far ear late & darker
+    ma_uint32 delay[MS_AMBISONIC_MAX_SPEAKERS];
+    float shadow_gain[MS_AMBISONIC_MAX_SPEAKERS];
+    float shadow_coefficient[MS_AMBISONIC_MAX_SPEAKERS];
+    float shadow_state[MS_AMBISONIC_MAX_SPEAKERS];
+    ma_bool8 near_left[MS_AMBISONIC_MAX_SPEAKERS]; // which ear is the near one
+    float history[MS_AMBISONIC_MAX_SPEAKERS][64];
+    ma_uint32 history_position;
+    float scratch[256 * MS_AMBISONIC_MAX_SPEAKERS];
+
+    ms_ambisonic_encoder* encoders; // game thread, every encoder feeding the bus
+};
+
+// takes a voice on each input bus & mixes them all into the bus's channels
+struct ms_ambisonic_encoder {
+    ma_node_base base;
+    ms_ambisonic_bus* bus;
+    ms_ambisonic_encoder* next;
+    ma_uint32 inputs; // the engine's channels
+
+    // game thread
+    ma_uint32 free_slots[MS_AMBISONIC_ENCODER_VOICES];
+    ma_uint32 free_count;
+
+    std::atomic<ma_sound*> voices[MS_AMBISONIC_ENCODER_VOICES]; // whose position each slot is encoded from
+    float gains[MS_AMBISONIC_ENCODER_VOICES][16];                // where the last block left off, the next one ramps from here
+    ma_sound* previous[MS_AMBISONIC_ENCODER_VOICES];             // audio thread only, a new voice jumps straight to its gains
+};
+
+struct ms_ambisonic_voice {
+    ms_ambisonic_encoder* encoder;
+    ma_uint32 slot; // the encoder's input bus
+};
+#endif /* MS_HAS_AMBISONICS */
+
+/* --- ms_speaker_array --- */
+
+#ifdef MS_HAS_SPEAKER_ARRAY
+// a direction is heard from the pair of speakers either side of it
+typedef struct {
+    ma_uint32 channel[2]; // device channels
+    float gain[2];
+} ms_vbap_gains;
+
+struct ms_speaker_array {
+    ma_engine* engine;
+    ma_uint32 channels; // the engine's, one per device output
+    ma_uint32 speakers;
+    float azimuths[MS_SPEAKER_ARRAY_MAX_SPEAKERS];      // radians anticlockwise from ahead, sorted
+    ma_uint32 outputs[MS_SPEAKER_ARRAY_MAX_SPEAKERS];   // the device channel each of `azimuths` is wired to
+    ms_vbap_gains table[MS_VBAP_TABLE_SIZE];            // row n is for the direction 2 pi n / MS_VBAP_TABLE_SIZE
+
+    ms_speaker_panner* panners; // game thread, every panner feeding the endpoint
+};
+
+// a miniaudio node, `base` has to come first. takes a voice on each input bus & mixes them all onto the speakers
+struct ms_speaker_panner {
+    ma_node_base base;
+    ms_speaker_array* array;
+    ms_speaker_panner* next;
+
+    // game thread
+    ma_uint32 free_slots[MS_SPEAKER_ARRAY_PANNER_VOICES];
+    ma_uint32 free_count;
+
+    std::atomic<ma_sound*> voices[MS_SPEAKER_ARRAY_PANNER_VOICES];
+    ms_vbap_gains gains[MS_SPEAKER_ARRAY_PANNER_VOICES];   // audio thread, where the last block left off
+    ma_vec3f positions[MS_SPEAKER_ARRAY_PANNER_VOICES];    // audio thread, where the voice was relative to the listener then
+    ma_sound* previous[MS_SPEAKER_ARRAY_PANNER_VOICES];    // audio thread, a new voice jumps straight to its gains
+};
+
+struct ms_speaker_voice {
+    ms_speaker_panner* panner;
+    ma_uint32 slot; // the panner's input bus
+};
+#endif /* MS_HAS_SPEAKER_ARRAY */
+
+/* --- ms_param_batch --- */
+
+// live parameters for many voices, one array per parameter so the audio thread's pass over them vectorises
+struct ms_param_batch {
+    vector<ma_sound*> voices;
+    vector<float> volume; // each is either empty (left alone) or as long as `voices`
+    vector<float> pitch;
+    vector<float> pan;
+};
+
+/* --- ms_scene --- */
+
+typedef enum {
+    MS_SCENE_EMITTER_SET,   // give an emitter a path or entity
+    MS_SCENE_EMITTER_BIND,  // hand an emitter the voice it moves & restart its path
+    MS_SCENE_EMITTER_REMOVE,
+    MS_SCENE_EMITTER_OCCLUDE, // give an emitter the filter its voice is occluded through
+    MS_SCENE_SET_OCCLUSION_GRID,
+    MS_SCENE_APPLY_PARAMS
+} ms_scene_command_type;
+
+struct ms_scene_command {
+    ms_scene_command_type type;
+    ma_uint32 emitter;
+    ms_param_batch* batch;
+    #ifndef MS_NO_SPATIALIZATION
+    const ms_path* path;
+    ms_entity* entity;
+    ma_vec3f origin;
+    ma_sound* voice;
+    #endif
+    #ifdef MS_HAS_OCCLUSION
+    ma_lpf_node* filter;
+    ms_occlusion_grid* grid;
+    #endif
+};
+
+// voices let go of while a command still on the ring could reach them, see ms_scene_retire()
+struct ms_retired_voices {
+    ma_uint32 command;
+    vector<ma_sound*> voices;
+    ms_arena arena; // empty when only the voices go
+};
+
+#ifndef MS_NO_SPATIALIZATION
+// an emitter whose removal didn't fit on the ring, pushed by ms_scene_collect() once it does. the emitter may still
+// move a voice until then, so whatever its sound lets go of meanwhile waits here & is retired with the removal
+struct ms_deferred_removal {
+    ma_uint32 emitter;
+    ms_sound* sound; // nullptr once the sound has been uninitialised
+    ms_retired_voices retired; // `command` is the removal's, once it's pushed
+};
+#endif
+
+struct ms_scene {
+    ma_engine* engine;
+
+    // single producer (the game thread) single consumer (the audio thread) ring of commands
+    vector<ms_scene_command> commands;
+    std::atomic<ma_uint32> command_read{0};
+    std::atomic<ma_uint32> command_write{0};
+
+    #ifndef MS_NO_SPATIALIZATION
+    // emitter handles, game thread only
+    vector<ma_uint32> free_emitters;
+
+    // emitters, audio thread only. packed into `emitter_count` long arrays so the per block loop stays tight
+    ma_uint32 emitter_count;
+    vector<ma_uint32> emitter_slot;   // handle -> packed index, or ~0 if unused
+    vector<ma_uint32> emitter_handle; // packed index -> handle
+    vector<const ms_path*> emitter_path;
+    vector<ms_entity*> emitter_entity;
+    vector<ma_vec3f> emitter_origin;
+    vector<ma_sound*> emitter_voice;
+    vector<ma_uint64> emitter_start;
+    #endif
+
+    // batches are handed back to `free_batches` by the game thread once the audio thread has read past `command`
+    vector<ms_param_batch*> free_batches;
+    vector<std::pair<ma_uint32, ms_param_batch*> > sent_batches;
+
+    #ifdef MS_HAS_OCCLUSION
+    ms_occlusion_grid* occlusion; // audio thread only
+    vector<ma_lpf_node*> emitter_filter;
+    vector<float> emitter_cutoff; // cutoff the filter was last set to
+    // filters that are no longer used, freed by the game thread once the audio thread has read past `command`
+    vector<std::pair<ma_uint32, ma_lpf_node*> > retired;
+    #endif
+
+    // voices of uninitialised sounds along with the arena they were carved from, uninitialised & freed the same way
+    vector<ms_retired_voices> retired_voices;
+    #ifndef MS_NO_SPATIALIZATION
+    vector<ms_deferred_removal> deferred_removals; // oldest first, game thread only
+    #endif
+};
+
+/* --- ms_parallel --- */
+
+#ifdef MS_HAS_PARALLEL
+// a soundscape submix: an engine of its own for soundscapes to be built on, rendered a block at a time by whichever
+// thread of the pool claims it
+struct ms_submix {
+    ma_engine engine;
+    vector<ms_soundscape*> soundscapes; // ticked by ms_parallel_tick()
+    vector<float> block;                // the last block it rendered
+    std::atomic<ma_uint32> rendered{0}; // which block that was, so one still rendering when its block is summed is left out
+    std::atomic<bool> busy{false};      // being rendered, a thread that claims it for the next block while it's late skips it
+};
+
+// one thread's share of a block's submixes, [next, end). the thread takes them from the front, and so does any
+// other thread that has run out of its own, so each is claimed exactly once without a lock. both ends are in the one
+// word, next in the low half, so a claim always sees the end of the same block
+struct alignas(64) ms_parallel_queue {
+    std::atomic<ma_uint64> range{0};
+};
+
+// what an ms_parallel has done so far
+typedef struct {
+    ma_uint64 blocks;       // mixed
+    ma_uint64 pooled;       // of them spread over the pool
+    ma_uint64 serial;       // of them rendered by the reading thread alone, while the pool sat out after missing
+    ma_uint64 missed;       // pooled blocks that took longer than the deadline
+    ma_uint64 stolen;       // submixes rendered by another thread than the one they were queued for
+    ma_uint64 dropped;      // submixes left out of a block, still rendering once the block's length had gone by
+    double    wall_seconds; // spent rendering & summing blocks
+} ms_parallel_stats;
+
+struct ms_parallel {
+    ma_data_source_base base; // first, so it can be played through an engine like any data source
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+    ma_resource_manager resources; // shared by the submixes, so a file loaded on two of them is decoded once
+    vector<ms_submix*> submixes;
+
+    // the pool. thread 0 is whichever one reads, 1 on are workers waiting for their `wake`
+    ma_uint32 threads;
+    vector<std::thread> workers;
+    vector<ma_event> wake;
+    vector<ms_parallel_queue> queues;
+    std::atomic<ma_uint32> block_index{0}; // of the block being rendered, counting from 1
+    std::atomic<ma_uint64> remaining{0};   // submixes of the block not rendered yet, under the block's index in the high half
+    std::atomic<ma_uint64> stolen{0};
+    std::atomic<bool> quit{false};
+    ma_uint32 frames; // in a block, MS_RENDER_BLOCK
+
+    // reading thread only
+    float deadline;         // fraction of a block's length a pooled block may take
+    ma_uint32 misses;       // pooled blocks in a row over the deadline
+    ma_uint32 sitting_out;  // blocks left to render on one thread before the pool is tried again
+    vector<float> mixed;    // the summed block being read out
+    ma_uint32 mixed_position;
+    ma_uint64 cursor;
+    ms_parallel_stats stats;
+};
+#endif /* MS_HAS_PARALLEL */
+
+/* --- ms_sound --- */
+
+void      ms_sound_init(std::string name, ma_engine* engine, unsigned int weight, std::string filepath, ms_sound* sound, ms_sound_filetype filetype = MS_DEFAULT_FILETYPE, bool enable_spatialization = true);
+void      ms_sound_init_from_data_source(std::string name, ma_engine* engine, unsigned int weight, ma_data_source* const* sources, size_t sourcesAmount, ms_sound* sound, bool enable_spatialization = true, bool enable_pitch = true);
+void      ms_sound_init_empty(ms_sound* sound, unsigned int weight);
+void      ms_sound_uninit(ms_sound* sound);
+
+bool      ms_sound_is_playing(const ms_sound* sound);
+
+ma_result ms_sound_start(ms_sound* sound);
+ma_result ms_sound_stop(const ms_sound* sound);
+
+#ifndef MS_NO_SPATIALIZATION
+void      ms_sound_set_spatialization(ms_sound* sound, bool spatialization);
+void      ms_sound_add_speaker(ms_sound* sound, const unsigned int speakerAmount, ...);
+void      ms_sound_add_speaker(ms_sound* sound, ms_sound_speaker* speaker);
+void      ms_sound_set_position(ms_sound* sound, double x, double y, double z);
+ma_result ms_sound_set_path(ms_sound* sound, ms_scene* scene, const ms_path* path);
+ma_result ms_sound_attach_to_entity(ms_sound* sound, ms_scene* scene, ms_entity* entity);
+void      ms_sound_detach(ms_sound* sound);
+#endif /* MS_NO_SPATIALIZATION */
+void      ms_sound_set_volume(ms_sound* sound, float volume);
+void      ms_sound_set_volume(ms_sound* sound, float start, float end);
+void      ms_sound_set_pitch(ms_sound* sound, float pitch);
+void      ms_sound_set_pitch(ms_sound* sound, float start, float end);
+void      ms_sound_set_pan(ms_sound* sound, float pan);
+void      ms_sound_set_pan(ms_sound* sound, float start, float end);
+
+static void ms_sound_classify(ms_sound* sound);
+
+/* --- ms_sound_table --- */
+
+void            ms_sound_table_uninit(ms_sound_table* table);
+ms_sound_handle ms_sound_table_add(ms_sound_table* table, ms_sound* sound);
+void            ms_sound_table_remove(ms_sound_table* table, ms_sound* sound);
+void            ms_sound_table_start(ms_sound_table* table, const ms_sound_handle* handles, size_t count, ma_result* results = nullptr);
+ms_sound_handle ms_sound_table_pick(const ms_sound_table* table);
+ms_sound_handle ms_sound_table_find(const ms_sound_table* table, ms_id id);
+ms_sound_handle ms_sound_table_find(const ms_sound_table* table, const std::string& name);
+static void     ms_sound_table_sync(const ms_sound* sound);
+
+/* --- ms_scene --- */
+
+ma_result ms_scene_init(ms_scene* scene, ma_engine* engine, ma_engine_config* config, ma_uint32 maxEmitters = MS_DEFAULT_MAX_EMITTERS);
+void      ms_scene_uninit(ms_scene* scene);
+void      ms_scene_process(void* pUserData, float* pFramesOut, ma_uint64 frameCount);
+ma_result ms_scene_set_params(ms_scene* scene, ms_sound* const* sounds, size_t soundsAmount, const float* volume, const float* pitch = nullptr, const float* pan = nullptr);
+
+#ifndef MS_NO_SPATIALIZATION
+int       ms_scene_add_emitter(ms_scene* scene, const ms_path* path, ma_vec3f origin = { 0.0f, 0.0f, 0.0f });
+int       ms_scene_add_emitter(ms_scene* scene, ms_entity* entity);
+ma_result ms_scene_bind_emitter(ms_scene* scene, int emitter, ma_sound* voice, const ms_path* path = nullptr, ma_vec3f origin = { 0.0f, 0.0f, 0.0f });
+bool      ms_scene_remove_emitter(ms_scene* scene, int emitter);
+
+void      ms_path_init_line(ms_path* path, ma_vec3f from, ma_vec3f to, double duration, ms_path_mode mode = MS_PATH_ONCE);
+void      ms_path_init_line(ms_path* path, const ma_vec3f* points, size_t pointAmount, double duration, ms_path_mode mode = MS_PATH_ONCE);
+void      ms_path_init_spline(ms_path* path, const ma_vec3f* points, size_t pointAmount, double duration, ms_path_mode mode = MS_PATH_ONCE);
+ma_vec3f  ms_path_evaluate(const ms_path* path, double seconds);
+
+void      ms_entity_init(ms_entity* entity, ma_vec3f position = { 0.0f, 0.0f, 0.0f });
+void      ms_entity_set(ms_entity* entity, ma_engine* engine, ma_vec3f position, ma_vec3f velocity = { 0.0f, 0.0f, 0.0f });
+ma_vec3f  ms_entity_get(const ms_entity* entity, ma_uint64 time, ma_uint32 sampleRate, ma_vec3f* velocity = nullptr);
+#endif /* MS_NO_SPATIALIZATION */
+
+static void ms_scene_collect(ms_scene* scene);
+static bool ms_scene_push(ms_scene* scene, const ms_scene_command& command);
+static void ms_scene_retire(ms_scene* scene, ma_uint32 command, const vector<ma_sound*>& voices, ms_arena* arena);
+#ifndef MS_NO_SPATIALIZATION
+static void ms_scene_defer_remove(ms_scene* scene, ma_uint32 emitter, ms_sound* sound);
+static void ms_scene_defer_retire(ms_scene* scene, ms_sound* sound, const vector<ma_sound*>& voices, ms_arena* arena);
+#endif
+#ifndef MS_NO_SPATIALIZATION
+static int  ms_scene_add_emitter(ms_scene* scene, ms_scene_command command);
+#endif
+
+#ifdef MS_HAS_OCCLUSION
+ma_result ms_scene_set_occlusion_grid(ms_scene* scene, ms_occlusion_grid* grid);
+ma_result ms_sound_set_occlusion(ms_sound* sound, ms_scene* scene, bool occluded);
+
+void      ms_occlusion_grid_init(ms_occlusion_grid* grid, ma_uint32 width, ma_uint32 height, float spacing, float origin_x = 0.0f, float origin_z = 0.0f);
+void      ms_occlusion_grid_set_tile(ms_occlusion_grid* grid, ma_uint32 x, ma_uint32 y, float transmission);
+int       ms_occlusion_grid_tile_at(const ms_occlusion_grid* grid, float x, float z);
+bool      ms_occlusion_grid_update(ms_occlusion_grid* grid, ma_engine* engine);
+#endif /* MS_HAS_OCCLUSION */
+
+#ifdef MS_HAS_AMBISONICS
+ma_result ms_ambisonic_bus_init(ms_ambisonic_bus* bus, ma_engine* engine, ma_uint32 order, ms_ambisonic_decoder decoder, const float* speakerAzimuths = nullptr);
+void      ms_ambisonic_bus_uninit(ms_ambisonic_bus* bus);
+ma_result ms_ambisonic_bus_add_voice(ms_ambisonic_bus* bus, ma_sound* voice, ms_ambisonic_voice* handle);
+void      ms_ambisonic_bus_remove_voice(ms_ambisonic_bus* bus, ms_ambisonic_voice* handle);
+void      ms_ambisonic_voice_set(const ms_ambisonic_voice* handle, ma_sound* voice);
+ma_result ms_sound_set_ambisonic(ms_sound* sound, ms_ambisonic_bus* bus);
+#endif /* MS_HAS_AMBISONICS */
+
+#ifdef MS_HAS_SPEAKER_ARRAY
+ma_result ms_speaker_array_init(ms_speaker_array* array, ma_engine* engine, const float* azimuths, const ma_uint32* channels = nullptr, ma_uint32 speakerAmount = 0);
+ma_result ms_speaker_array_init(ms_speaker_array* array, ma_engine* engine, ms_sound_speaker* const* speakers, ma_uint32 speakerAmount);
+void      ms_speaker_array_uninit(ms_speaker_array* array);
+ma_result ms_speaker_array_add_voice(ms_speaker_array* array, ma_sound* voice, ms_speaker_voice* handle);
+void      ms_speaker_array_remove_voice(ms_speaker_array* array, ms_speaker_voice* handle);
+void      ms_speaker_voice_set(const ms_speaker_voice* handle, ma_sound* voice);
+ma_result ms_sound_set_speaker_array(ms_sound* sound, ms_speaker_array* array);
+#endif /* MS_HAS_SPEAKER_ARRAY */
+
+#ifdef MS_HAS_AMBIENCE
+ma_result ms_ambience_init(ms_ambience* ambience, ms_ambience_type type, ma_uint32 seed = 1, float intensity = 0.5f);
+void      ms_ambience_uninit(ms_ambience* ambience);
+void      ms_ambience_set_intensity(ms_ambience* ambience, float intensity);
+ma_result ms_granular_init(ms_granular* granular, const std::string filepath, ma_uint32 streams = 16, ma_uint32 seed = 1, float clipStart = 0.0f, float clipLength = 0.0f);
+void      ms_granular_uninit(ms_granular* granular);
+void      ms_granular_set_grains(ms_granular* granular, float minLength, float maxLength, float pitchSpread);
+#endif /* MS_HAS_AMBIENCE */
+
+#ifdef MS_HAS_PARALLEL
+ma_result  ms_parallel_init(ms_parallel* parallel, ma_uint32 threads = 0, ma_uint32 channels = 2, ma_uint32 sampleRate = MS_SAMPLE_RATE);
+void       ms_parallel_uninit(ms_parallel* parallel);
+ma_engine* ms_parallel_add_submix(ms_parallel* parallel);
+ma_result  ms_parallel_add_soundscape(ms_parallel* parallel, ms_soundscape* soundscape);
+void       ms_parallel_remove_soundscape(ms_parallel* parallel, const ms_soundscape* soundscape);
+void       ms_parallel_tick(ms_parallel* parallel);
+ma_result  ms_parallel_read(ms_parallel* parallel, float* out, ma_uint64 frameCount, ma_uint64* framesRead = nullptr);
+void       ms_parallel_set_deadline(ms_parallel* parallel, float deadline);
+ms_parallel_stats ms_parallel_get_stats(const ms_parallel* parallel);
+#endif /* MS_HAS_PARALLEL */
+
+ma_result ms_trace_write(const std::string filepath);
+void      ms_trace_data_callback(ma_device* pDevice, void* pFramesOut, const void* pFramesIn, ma_uint32 frameCount);
+
+#ifdef MS_HAS_METRICS
+ms_metrics_snapshot ms_metrics_get();
+void        ms_metrics_reset();
+void        ms_metrics_profile_loads(bool enable);
+vector<ms_load_record> ms_metrics_take_loads();
+static void ms_metrics_load(const ma_sound* voice, ma_result result, const std::string& path, const std::string& owner, double seconds);
+static void ms_metrics_unload(const ma_sound* voice);
+#endif /* MS_HAS_METRICS */
+
+#ifndef MS_NO_SPATIALIZATION
+// send `voice` (or the occlusion filter all of `sound`'s variants feed) to `destination`
+static void ms_sound_route(ms_sound* sound, ma_sound* voice, ma_node* destination, ma_uint32 destinationBus = 0) {
+    #ifdef MS_HAS_OCCLUSION
+        if (sound->occlusion != nullptr) {
+            ma_node_attach_output_bus(sound->occlusion, 0, destination, destinationBus);
+            return;
+        }
+    #else
+        (void)sound;
+    #endif
+    ma_node_attach_output_bus(voice, 0, destination, destinationBus);
+}
+
+// where `sound`'s variants (or its occlusion filter) go when level of detail isn't sending them anywhere else
+static ma_node* ms_sound_output(const ms_sound* sound, ma_engine* engine, ma_uint32* bus) {
+    *bus = 0;
+    #ifdef MS_HAS_AMBISONICS
+        if (sound->ambisonic != nullptr) {
+            *bus = sound->ambisonic->slot;
+            return sound->ambisonic->encoder;
+        }
+    #endif
+    #ifdef MS_HAS_SPEAKER_ARRAY
+        if (sound->speaker_array != nullptr) {
+            *bus = sound->speaker_array->slot;
+            return sound->speaker_array->panner;
+        }
+    #endif
+    return ma_engine_get_endpoint(engine);
+}
+
+// the same gain miniaudio's spatializer would apply at `distance`
+static float ms_voice_attenuation(const ma_sound* voice, float distance) {
+    float minDistance = ma_sound_get_min_distance(voice);
+    float maxDistance = ma_sound_get_max_distance(voice);
+    float rolloff     = ma_sound_get_rolloff(voice);
+    float gain        = 1.0f;
+
+    if (minDistance < maxDistance) {
+        if (distance < minDistance) distance = minDistance;
+        if (distance > maxDistance) distance = maxDistance;
+        switch (ma_sound_get_attenuation_model(voice)) {
+            case ma_attenuation_model_inverse:     gain = minDistance / (minDistance + rolloff * (distance - minDistance));  break;
+            case ma_attenuation_model_linear:      gain = 1.0f - rolloff * (distance - minDistance) / (maxDistance - minDistance); break;
+            case ma_attenuation_model_exponential: gain = powf(distance / minDistance, -rolloff);                             break;
+            default: break;
+        }
+    }
+
+    if (gain < ma_sound_get_min_gain(voice)) gain = ma_sound_get_min_gain(voice);
+    if (gain > ma_sound_get_max_gain(voice)) gain = ma_sound_get_max_gain(voice);
+    return gain;
+}
+#endif /* MS_NO_SPATIALIZATION */
+
+#ifdef MS_HAS_LOD
+// the next `frameCount` (at most MS_LOD_BED_CHUNK) frames of the voice in `slot`, mixed down to mono & stepped to the
+// engine's rate at the voice's pitch, in the bed's scratch. once its data source runs out the rest is silence, the
+// voice is stopped & rewound, as miniaudio would, & `playing` is set to false. audio thread
+static const float* ms_lod_bed_read(ms_lod_bed* bed, ma_uint32 slot, ma_sound* voice, ma_uint32 frameCount, bool* playing) {
+    const ma_uint64 one = (ma_uint64)1 << 32; // positions are 32.32 fixed point, so the source frames `frameCount`
+                                              // output frames step over are known before reading them
+    ma_data_source* source = ma_sound_get_data_source(voice);
+    ma_format format       = bed->formats[slot];
+    ma_uint32 channels     = bed->source_channels[slot];
+    double ratio = (double)bed->source_rates[slot] / bed->sample_rate * ma_sound_get_pitch(voice);
+    if (ratio < 0.0) ratio = 0.0;
+    if (ratio > (double)MS_LOD_BED_CHUNK / frameCount) ratio = (double)MS_LOD_BED_CHUNK / frameCount;
+    ma_uint64 step = (ma_uint64)(ratio * one);
+    ma_uint64 t    = bed->t[slot];
+    ma_uint32 needed = (ma_uint32)((t + frameCount * step) >> 32);
+
+    // the two frames the last chunk ended between come first
+    float* history = bed->mono;
+    float* mono    = bed->mono + 2;
+    history[0] = bed->x0[slot];
+    history[1] = bed->x1[slot];
+
+    ma_uint64 read = 0;
+    bool ended     = false;
+    if (needed > 0) {
+        ma_result result = ma_data_source_read_pcm_frames(source, bed->raw, needed, &read);
+        if (result == MA_BUSY) read = 0;         // a stream still loading, silent until it has
+        else if (read < needed) ended = true;
+        const float* frames = (const float*)bed->raw;
+        if (format != ma_format_f32) {
+            ma_pcm_convert(bed->converted, ma_format_f32, bed->raw, format, read * channels, ma_dither_mode_none);
+            frames = bed->converted;
+        }
+        if (channels == 1) {
+            memcpy(mono, frames, sizeof(float) * read);
+        } else if (channels == 2) {
+            for (ma_uint64 f = 0; f < read; f++) mono[f] = 0.5f * (frames[f * 2] + frames[f * 2 + 1]);
+        } else {
+            float scale = 1.0f / channels;
+            for (ma_uint64 f = 0; f < read; f++) {
+                float sum = 0.0f;
+                for (ma_uint32 c = 0; c < channels; c++) sum += frames[f * channels + c];
+                mono[f] = sum * scale;
+            }
+        }
+        for (ma_uint32 f = (ma_uint32)read; f < needed; f++) mono[f] = 0.0f;
+    }
+
+    *playing = !ended;
+    if (ended) {
+        ma_sound_stop(voice);
+        ma_data_source_seek_to_pcm_frame(source, 0);
+    }
+    float x0 = history[needed];
+    float x1 = history[needed + 1];
+    bed->x0[slot] = ended ? 0.0f : x0;
+    bed->x1[slot] = ended ? 0.0f : x1;
+    bed->t[slot]  = ended ? 0 : (t + frameCount * step) & (one - 1);
+
+    if (step == one && t == 0) return history; // at the engine's rate & a pitch of 1 the frames are used as they are
+    float* out = bed->resampled;
+    if (step == one) { // the fraction never changes
+        float fraction = (float)t * (1.0f / one);
+        for (ma_uint32 i = 0; i < frameCount; i++) out[i] = history[i] + fraction * (history[i + 1] - history[i]);
+    } else {
+        for (ma_uint32 i = 0; i < frameCount; i++) {
+            ma_uint64 position = t + i * step;
+            ma_uint32 index    = (ma_uint32)(position >> 32);
+            float fraction     = (float)(position & (one - 1)) * (1.0f / one);
+            out[i] = history[index] + fraction * (history[index + 1] - history[index]);
+        }
+    }
+    return out;
+}
+
+// add `frameCount` frames of one tier's voices to `out`, `offset` frames into a block of `blockFrames`: far ones to
+// the mono `out`, mid ones panned across the first two of the engine's channels. gains ramp from where the last block
+// left them to where this one ends. audio thread
+static void ms_lod_bed_mix(ms_lod_bed* bed, bool far, float* out, ma_uint32 offset, ma_uint32 frameCount, ma_uint32 blockFrames) {
+    ma_uint32 channels = far ? 1 : bed->channels;
+    for (ma_uint32 slot = 0; slot < MS_LOD_BED_VOICES; slot++) {
+        ma_sound* voice = bed->voices[slot].load(); // seq_cst, against ms_lod_bed_remove()
+        if (voice == nullptr || bed->far[slot].load(std::memory_order_relaxed) != far) continue;
+        if (!ma_sound_is_playing(voice)) {
+            bed->previous[slot] = nullptr;
+            continue;
+        }
+
+        // miniaudio's balance panning, as the voice had in the graph
+        float gain  = bed->gains[slot].load(std::memory_order_relaxed) * ma_sound_get_volume(voice);
+        float to[2] = { gain, gain };
+        if (!far) {
+            float pan = bed->pans[slot].load(std::memory_order_relaxed) + ma_sound_get_pan(voice);
+            if (pan < -1.0f) pan = -1.0f;
+            if (pan >  1.0f) pan =  1.0f;
+            if (pan < 0.0f) to[1] *= 1.0f + pan;
+            else            to[0] *= 1.0f - pan;
+            if (channels == 1) to[0] = 0.5f * (to[0] + to[1]); // a mono engine takes the middle
+        }
+        float* from = bed->applied[slot];
+        if (voice != bed->previous[slot]) {
+            bed->x0[slot] = bed->x1[slot] = 0.0f;
+            bed->t[slot]  = 0;
+            from[0] = to[0];
+            from[1] = to[1];
+            bed->previous[slot] = voice;
+        }
+
+        bool playing;
+        const float* in = ms_lod_bed_read(bed, slot, voice, frameCount, &playing);
+        float step0 = (to[0] - from[0]) / blockFrames;
+        float step1 = (to[1] - from[1]) / blockFrames;
+        float g0    = from[0] + offset * step0;
+        float g1    = from[1] + offset * step1;
+        if (channels == 1) {
+            for (ma_uint32 i = 0; i < frameCount; i++, g0 += step0) out[i] += in[i] * g0;
+        } else if (channels == 2) {
+            for (ma_uint32 i = 0; i < frameCount; i++, g0 += step0, g1 += step1) {
+                out[i * 2]     += in[i] * g0;
+                out[i * 2 + 1] += in[i] * g1;
+            }
+        } else {
+            float* frame = out;
+            for (ma_uint32 i = 0; i < frameCount; i++, frame += channels, g0 += step0, g1 += step1) {
+                frame[0] += in[i] * g0;
+                frame[1] += in[i] * g1;
+            }
+        }
+        if (offset + frameCount == blockFrames || !playing) {
+            from[0] = to[0];
+            from[1] = to[1];
+        }
+    }
+}
+
+static void ms_lod_bed_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut) {
+    (void)ppFramesIn;
+    (void)pFrameCountIn;
+    ms_lod_bed* bed      = (ms_lod_bed*)pNode;
+    float* out           = ppFramesOut[0];
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 channels   = bed->channels;
+
+    bed->epoch.fetch_add(1); // odd
+    memset(out, 0, sizeof(float) * frameCount * channels);
+
+    std::chrono::nanoseconds farTime(0), midTime(0);
+    for (ma_uint32 done = 0; done < frameCount;) {
+        ma_uint32 n = (frameCount - done < MS_LOD_BED_CHUNK) ? frameCount - done : MS_LOD_BED_CHUNK;
+        float* frames = out + (size_t)done * channels;
+
+        // the far voices are one mono sum, centred by copying it across
+        auto started = std::chrono::steady_clock::now();
+        memset(bed->far_sum, 0, sizeof(float) * n);
+        ms_lod_bed_mix(bed, true, bed->far_sum, done, n, frameCount);
+        for (ma_uint32 i = 0; i < n; i++) {
+            for (ma_uint32 c = 0; c < channels && c < 2; c++) frames[i * channels + c] = bed->far_sum[i];
+        }
+        auto summed = std::chrono::steady_clock::now();
+        ms_lod_bed_mix(bed, false, frames, done, n, frameCount);
+        auto mixed = std::chrono::steady_clock::now();
+
+        farTime += summed - started;
+        midTime += mixed - summed;
+        done    += n;
+    }
+
+    bed->ns[MS_LOD_FAR].fetch_add((ma_uint64)farTime.count(), std::memory_order_relaxed);
+    bed->ns[MS_LOD_MID].fetch_add((ma_uint64)midTime.count(), std::memory_order_relaxed);
+    bed->epoch.fetch_add(1); // even, every slot read this block is let go of
+}
+
+static ma_node_vtable ms_lod_bed_vtable = { ms_lod_bed_process, NULL, 0, 1, 0 };
+
+static ma_result ms_lod_bed_init(ms_lod_bed* bed, ma_engine* engine) {
+    bed->channels    = ma_engine_get_channels(engine);
+    bed->sample_rate = ma_engine_get_sample_rate(engine);
+    bed->free_count  = MS_LOD_BED_VOICES;
+    for (int tier = MS_LOD_NEAR; tier <= MS_LOD_FAR; tier++) {
+        bed->ns[tier].store(0);
+        bed->taken_ns[tier] = 0;
+    }
+    for (ma_uint32 i = 0; i < MS_LOD_BED_VOICES; i++) {
+        bed->free_slots[i] = MS_LOD_BED_VOICES - 1 - i; // hand out low slots first
+        bed->sounds[i]     = nullptr;
+        bed->voices[i].store(nullptr);
+        bed->previous[i]   = nullptr;
+    }
+
+    ma_node_config config  = ma_node_config_init();
+    config.vtable          = &ms_lod_bed_vtable;
+    config.pOutputChannels = &bed->channels;
+    ma_result result = ma_node_init(ma_engine_get_node_graph(engine), &config, NULL, &bed->base);
+    if (result != MA_SUCCESS) return result;
+    return ma_node_attach_output_bus(&bed->base, 0, ma_engine_get_endpoint(engine), 0);
+}
+
+// take `sound`'s playing `voice` out of the graph & into a free slot of `bed`. false if the bed is full or can't read
+// the voice's data source. game thread
+static bool ms_lod_bed_add(ms_lod_bed* bed, ms_sound* sound, ma_sound* voice) {
+    if (bed->free_count == 0) return false;
+    ma_format format;
+    ma_uint32 channels, rate;
+    if (ma_data_source_get_data_format(ma_sound_get_data_source(voice), &format, &channels, &rate, NULL, 0) != MA_SUCCESS) return false;
+    if (format == ma_format_unknown || channels == 0 || channels > MS_LOD_BED_MAX_CHANNELS || rate == 0) return false;
+
+    ma_uint32 slot = bed->free_slots[--bed->free_count];
+    bed->sounds[slot]          = sound;
+    bed->formats[slot]         = format;
+    bed->source_channels[slot] = channels;
+    bed->source_rates[slot]    = rate;
+    ma_node_detach_output_bus(voice, 0);
+    bed->voices[slot].store(voice);
+    sound->bed      = bed;
+    sound->bed_slot = slot;
+    return true;
+}
+
+// take `sound`'s voice back out of its bed & return it, still detached. a block being mixed may have read the slot
+// before it was cleared, so this waits for that block to end. game thread
+static ma_sound* ms_lod_bed_remove(ms_sound* sound) {
+    ms_lod_bed* bed = sound->bed;
+    ma_uint32 slot  = sound->bed_slot;
+    ma_sound* voice = bed->voices[slot].exchange(nullptr);
+    ma_uint32 epoch = bed->epoch.load();
+    if (epoch & 1) {
+        while (bed->epoch.load() == epoch) std::this_thread::yield();
+    }
+    bed->sounds[slot] = nullptr;
+    bed->free_slots[bed->free_count++] = slot;
+    sound->bed = nullptr;
+    return voice;
+}
+
+// only the last started variant can have been moved out of the near tier, put it back the way ms_sound_init() left it
+static void ms_sound_reset_lod(ms_sound* sound) {
+    if (sound->bed == nullptr) return;
+    ma_sound* voice = ms_lod_bed_remove(sound);
+    ma_uint32 bus;
+    ma_node* output = ms_sound_output(sound, ma_sound_get_engine(voice), &bus);
+    ms_sound_route(sound, voice, output, bus);
+    sound->lod_tier = MS_LOD_NEAR;
+}
+#endif /* MS_HAS_LOD */
+
+// everything ms_sound_init() & ms_sound_init_from_data_source() set before loading, returning the flags to make the
+// voices with
+static ma_uint32 ms_sound_setup(const std::string& name, ma_engine* engine, unsigned int weight, ms_sound* sound, bool enable_spatialization) {
+    sound->name            = name;
+    sound->id              = ms_intern(name);
+    sound->empty           = false;
+    sound->weight          = weight;
+
+    // -1.0f to 1.0f
+    sound->pan_range[0]    = 0.0f;
+    sound->pan_range[1]    = 0.0f;
+
+    // 0.0f to inf
+    sound->pitch_range[0]  = 1.0f;
+    sound->pitch_range[1]  = 1.0f;
+
+    // 0.0f to inf
+    sound->volume_range[0] = 1.0f;
+    sound->volume_range[1] = 1.0f;
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_sound_init :: initialising " << sound->name << std::endl;
+    #endif
+
+    ms_node_profile_watch_engine(engine);
+
+    // a sound fresh from here sits on the listener at a pitch of 1, so its voices start out without the spatializer
+    // or the resampler. ms_sound_classify() switches the spatializer on once a setter places it, and makes the
+    // variants again with the resampler once something pitches them or they can doppler
+    ma_uint32 flags = 0;
+    #ifndef MS_NO_SPATIALIZATION
+    sound->spatialized = enable_spatialization;
+    if (!enable_spatialization) flags = MA_SOUND_FLAG_NO_SPATIALIZATION;
+    #else
+    (void)enable_spatialization;
+    flags = MA_SOUND_FLAG_NO_SPATIALIZATION;
+    #endif
+    sound->repitched = false;
+    sound->reached_by = nullptr;
+    #ifndef MS_NO_SPATIALIZATION
+    sound->stranded = nullptr;
+    #endif
+    #ifdef MS_HAS_FAST_PATHS
+    flags |= MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_NO_PITCH;
+    sound->stages = 0;
+    #else
+    sound->stages = MS_SOUND_STAGE_PITCH | ((flags & MA_SOUND_FLAG_NO_SPATIALIZATION) ? 0 : MS_SOUND_STAGE_SPATIALIZER);
+    #endif
+
+    return flags;
+}
+
+// make `voice` from `source` or the file at `path` (nullptr for none) with `flags` and add it as `sound`'s next
+// variant. false if miniaudio couldn't, the sound goes on without it
+static bool ms_sound_load_voice(ms_sound* sound, ma_engine* engine, const char* path, ma_data_source* source, ma_uint32 flags, ma_sound* voice) {
+    ma_uint64 traced = ms_trace_begin();
+    #ifdef MS_HAS_METRICS
+        auto started = std::chrono::steady_clock::now();
+    #endif
+    ma_result result = (path != nullptr)
+        ? ma_sound_init_from_file(engine, path, flags | MS_NODE_PROFILE_FLAGS, NULL, NULL, voice)
+        : ma_sound_init_from_data_source(engine, source, flags | MS_NODE_PROFILE_FLAGS, NULL, voice);
+    ms_trace_end("load", traced, (path != nullptr) ? path : "data source");
+    #ifdef MS_HAS_METRICS
+        if (path != nullptr) ms_metrics_load(voice, result, path, sound->name, std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    #endif
+
+    if (result != MA_SUCCESS) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_init :: " << ((path != nullptr) ? path : "a data source") << " failed to initialise and will not be added to " << sound->name << std::endl;
+        #endif
+        return false;
+    }
+
+    #ifndef MS_NO_SPATIALIZATION
+        ma_sound_set_positioning(voice, ma_positioning_relative);
+    #endif
+    sound->sounds.push_back(voice);
+    ms_node_profile_watch(voice, sound->name, sound, nullptr);
+    ms_node_profile_attach(engine, voice);
+    return true;
+}
+
+void ms_sound_init(std::string name, ma_engine* engine, unsigned int weight, std::string filepath, ms_sound* sound, ms_sound_filetype filetype, bool enable_spatialization) {
+    ma_uint32 flags = ms_sound_setup(name, engine, weight, sound, enable_spatialization);
+
+    // find every variant first, so they can be carved out of the arena in one piece
+    vector<std::string> files;
+    for (unsigned short i = 0; ; i++) {
+        std::string str = filepath + to_string(i);
+        switch (filetype) {
+            case WAV:  str += ".wav";  break;
+            case MP3:  str += ".mp3";  break;
+            case FLAC: str += ".flac"; break;
+        }
+        if (!std::filesystem::exists(str)) break; // check if our file exists, if it doesn't we stop looking
+        files.push_back(str);
+    }
+    if (files.empty()) return;
+
+    ma_sound* voices = ms_arena_new<ma_sound>(&sound->arena, files.size());
+    if (voices == nullptr) return;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_init :: loading " << files[i] << std::endl;
+        #endif
+        ms_sound_load_voice(sound, engine, files[i].c_str(), nullptr, flags, &voices[i]);
+    }
+}
+
+// a sound whose variants play `sourcesAmount` data sources the caller made - decoders, streams, generators - in place
+// of files. the sources have to outlive the sound, and each is read by one variant only. voices over someone else's
+// data source can't be made again, so the resampler can't be added later as it is for ms_sound_init()'s: a sound
+// made with `enable_pitch` false ignores pitch & doppler for good, one made with it keeps the resampler throughout
+void ms_sound_init_from_data_source(std::string name, ma_engine* engine, unsigned int weight, ma_data_source* const* sources, size_t sourcesAmount, ms_sound* sound, bool enable_spatialization, bool enable_pitch) {
+    ma_uint32 flags = ms_sound_setup(name, engine, weight, sound, enable_spatialization) & ~MA_SOUND_FLAG_NO_PITCH;
+    sound->stages  |= MS_SOUND_STAGE_PITCH;
+    if (!enable_pitch) {
+        flags         |= MA_SOUND_FLAG_NO_PITCH;
+        sound->stages &= ~MS_SOUND_STAGE_PITCH;
+    }
+    if (sourcesAmount == 0) return;
+
+    ma_sound* voices = ms_arena_new<ma_sound>(&sound->arena, sourcesAmount);
+    if (voices == nullptr) return;
+    for (size_t i = 0; i < sourcesAmount; i++) ms_sound_load_voice(sound, engine, nullptr, sources[i], flags, &voices[i]);
+}
+
+void ms_sound_init_empty(ms_sound* sound, unsigned int weight) {
+    sound->name = "empty";
+    sound->id = ms_intern(sound->name);
+    sound->empty = true;
+    sound->weight = weight;
+}
+
+// uninitialise a voice a sound has let go of, game thread
+static void ms_voice_release(ma_sound* voice) {
+    #ifdef MS_HAS_METRICS
+        ms_metrics_unload(voice);
+    #endif
+    ma_sound_uninit(voice);
+    ms_node_profile_forget(voice);
+}
+
+// whether a command still on a scene's ring names one of `sound`'s voices
+static bool ms_sound_reachable(const ms_sound* sound) {
+    if (sound->reached_by == nullptr) return false;
+    ma_uint32 read = sound->reached_by->command_read.load(std::memory_order_acquire);
+    return (ma_int32)(read - sound->reached_until) <= 0;
+}
+
+// let go of `voices` & what's carved from `arena` (when given), which it empties. they're freed now unless an emitter
+// or a command on a scene's ring can still reach them, then the scene frees them once the audio thread is past that
+static void ms_sound_let_go(ms_sound* sound, const vector<ma_sound*>& voices, ms_arena* arena) {
+    #ifndef MS_NO_SPATIALIZATION
+        if (sound->stranded != nullptr) ms_scene_collect(sound->stranded); // the removal may fit by now
+        if (sound->stranded != nullptr) {
+            for (ma_sound* s : voices) ma_sound_stop(s);
+            ms_scene_defer_retire(sound->stranded, sound, voices, arena);
+            return;
+        }
+    #endif
+    if (ms_sound_reachable(sound)) {
+        // the audio thread lets go of them when it reads the command, the scene frees them after that
+        for (ma_sound* s : voices) ma_sound_stop(s);
+        ms_scene_retire(sound->reached_by, sound->reached_until, voices, arena);
+    } else {
+        for (ma_sound* s : voices) ms_voice_release(s);
+        if (arena != nullptr) ms_arena_release(arena);
+    }
+}
+
+// uninitialise the sounds that were in a scene before the scene
+void ms_sound_uninit(ms_sound* sound) {
+    #ifndef MS_NO_SPATIALIZATION
+        ms_sound_detach(sound);
+    #endif
+    #ifdef MS_HAS_AMBISONICS
+        ms_sound_set_ambisonic(sound, nullptr);
+    #endif
+    #ifdef MS_HAS_SPEAKER_ARRAY
+        ms_sound_set_speaker_array(sound, nullptr);
+    #endif
+    if (sound->table != nullptr) ms_sound_table_remove(sound->table, sound);
+    #ifdef MS_HAS_LOD
+        ms_sound_reset_lod(sound);
+    #endif
+
+    // the variants the resampler replaced go with the rest, they've faded out by now
+    sound->sounds.insert(sound->sounds.end(), sound->handed_over.begin(), sound->handed_over.end());
+    sound->handed_over.clear();
+    ms_sound_let_go(sound, sound->sounds, &sound->arena);
+    sound->sounds.clear(); // uninitialising it again does nothing
+    sound->reached_by = nullptr;
+    #ifndef MS_NO_SPATIALIZATION
+        sound->stranded = nullptr;
+    #endif
+}
+
+bool ms_sound_is_playing(const ms_sound* sound) {
+    for (ma_sound* s : sound->sounds) {
+        if (ma_sound_is_playing(s)) return true;
+    }
+    return false;
+}
+
+// draw a choice for a sound of `variants` variants from its ranges, in the order ms_sound_start() always has
+static inline ms_sound_choice ms_sound_choose(size_t variants, float volumeStart, float volumeEnd, float panStart, float panEnd, float pitchStart, float pitchEnd) {
+    ms_sound_choice choice;
+    choice.variant = (ma_uint32)(ms_rand() % variants);
+    choice.volume  = RAND_IN_RANGE(volumeStart, volumeEnd);
+    choice.pan     = RAND_IN_RANGE(panStart,    panEnd);
+    choice.pitch   = RAND_IN_RANGE(pitchStart,  pitchEnd);
+    return choice;
+}
+
+// give the variant `choice` picked its volume, pan, pitch & position & start it. where ms_sound_start() & a table's
+// batched start both end up, made once per combination of pitched & placed so neither is looked at per start
+template <bool Pitch, bool Placed>
+static ma_result ms_sound_start_variant(ms_sound* sound, const ms_sound_choice& choice, ma_uint64 traced) {
+    #ifdef MS_HAS_LOD
+        ms_sound_reset_lod(sound);
+    #endif
+    size_t i = choice.variant;
+    #ifdef MS_VERBOSE
+        std::cout << "ms_sound_start :: playing " << sound->name << "[" << to_string(i) << "]" << endl;
+    #endif
+    sound->active        = (int)i;
+    sound->active_volume = choice.volume;
+    sound->active_pan    = choice.pan;
+    if constexpr (Pitch) ma_sound_set_pitch(sound->sounds[i], choice.pitch);
+    ma_sound_set_volume(sound->sounds[i], sound->active_volume);
+    ma_sound_set_pan   (sound->sounds[i], sound->active_pan);
+    #ifndef MS_NO_SPATIALIZATION
+    if constexpr (Placed) {
+        ma_vec3f origin = { 0.0f, 0.0f, 0.0f };
+        const ms_path* path = sound->path;
+        if (sound->speakers.size() > 0) {
+            ms_sound_speaker* speaker = sound->speakers[ms_rand() % sound->speakers.size()];
+            origin = { (float)speaker->x, (float)speaker->y, (float)speaker->z };
+            if (speaker->path != nullptr) path = speaker->path;
+            ma_sound_set_position(sound->sounds[i], speaker->x, speaker->y, speaker->z);
+        }
+        if (sound->scene != nullptr) {
+            // start where the path starts rather than waiting a block for the audio thread to move us there
+            if (path != nullptr) {
+                ma_vec3f p = ms_path_evaluate(path, 0.0);
+                ma_sound_set_position(sound->sounds[i], origin.x + p.x, origin.y + p.y, origin.z + p.z);
+            }
+            ms_scene_bind_emitter(sound->scene, sound->emitter, sound->sounds[i], path, origin);
+        }
+    }
+    #endif /* MS_NO_SPATIALIZATION */
+    #ifdef MS_HAS_AMBISONICS
+        if (sound->ambisonic != nullptr) ms_ambisonic_voice_set(sound->ambisonic, sound->sounds[i]);
+    #endif
+    #ifdef MS_HAS_SPEAKER_ARRAY
+        if (sound->speaker_array != nullptr) ms_speaker_voice_set(sound->speaker_array, sound->sounds[i]);
+    #endif
+    MS_METRIC_ADD(voices_started, 1);
+    ma_result result = ma_sound_start(sound->sounds[i]);
+    ms_trace_end("ms_sound_start", traced, sound->name.c_str());
+    return result;
+}
+
+static ma_result ms_sound_start_choice(ms_sound* sound, const ms_sound_choice& choice, ma_uint64 traced) {
+    bool pitch  = (sound->stages & MS_SOUND_STAGE_PITCH) != 0;
+    bool placed = false;
+    #ifndef MS_NO_SPATIALIZATION
+        placed = !sound->speakers.empty() || sound->scene != nullptr;
+    #endif
+    if (pitch) return placed ? ms_sound_start_variant<true,  true>(sound, choice, traced) : ms_sound_start_variant<true,  false>(sound, choice, traced);
+    else       return placed ? ms_sound_start_variant<false, true>(sound, choice, traced) : ms_sound_start_variant<false, false>(sound, choice, traced);
+}
+
+ma_result ms_sound_start(ms_sound* sound) {
+    ma_uint64 traced = ms_trace_begin();
+    if (!ms_sound_is_playing(sound) && !sound->empty && !sound->sounds.empty()) {
+        ms_sound_choice choice = ms_sound_choose(sound->sounds.size(), sound->volume_range[0], sound->volume_range[1],
+            sound->pan_range[0], sound->pan_range[1], sound->pitch_range[0], sound->pitch_range[1]);
+        return ms_sound_start_choice(sound, choice, traced);
+    }
+    MS_METRIC_ADD(voices_rejected, 1);
+    ms_trace_instant("ms_sound_start rejected", sound->name.c_str());
+    return MA_SUCCESS;
+}
+
+ma_result ms_sound_stop(const ms_sound* sound) {
+    if (ms_sound_is_playing(sound)) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_stop :: stopping " << sound->name << endl;
+        #endif
+        for (size_t i = 0; i < sound->sounds.size(); i++) {
+            ma_sound_stop(sound->sounds[i]);
+        }
+    }
+    return MA_SUCCESS;
+}
+
+#ifndef MS_NO_SPATIALIZATION
+// switch miniaudio's spatializer on every variant of `sound` to what ms_sound_classify() decided
+static void ms_sound_apply_spatializer(const ms_sound* sound) {
+    #ifdef MS_HAS_AMBISONICS
+        if (sound->ambisonic != nullptr) return; // picked up again by ms_sound_set_ambisonic(sound, nullptr)
+    #endif
+    #ifdef MS_HAS_SPEAKER_ARRAY
+        if (sound->speaker_array != nullptr) return;
+    #endif
+    for (ma_sound* s : sound->sounds) {
+        ma_sound_set_spatialization_enabled(s, (sound->stages & MS_SOUND_STAGE_SPATIALIZER) != 0);
+    }
+}
+
+void ms_sound_set_spatialization(ms_sound* sound, bool spatialization) {
+    sound->spatialized = spatialization;
+    ms_sound_classify(sound);
+    ms_sound_apply_spatializer(sound);
+}
+
+void ms_sound_add_speaker(ms_sound* sound, const unsigned int speakerAmount, ...) {
+    va_list vl;
+    va_start(vl, speakerAmount);
+
+    for (size_t i = 0; i < speakerAmount; i++) {
+        sound->speakers.push_back(va_arg(vl, ms_sound_speaker*));
+    }
+
+    va_end(vl);
+    ms_sound_classify(sound);
+}
+
+void ms_sound_add_speaker(ms_sound* sound, ms_sound_speaker* speaker) {
+    ms_sound_add_speaker(sound, 1, speaker);
+}
+
+void ms_sound_set_position(ms_sound* sound, double x, double y, double z) {
+    for (ma_sound* s : sound->sounds) {
+        ma_sound_set_position(s, x, y, z);
+    }
+    sound->positioned = true;
+    ms_sound_classify(sound);
+}
+
+// give `sound` an emitter in `scene` defined by `command`, reusing the one it has if it's already in `scene`
+static ma_result ms_sound_set_emitter(ms_sound* sound, ms_scene* scene, ms_scene_command command) {
+    if (sound->scene != nullptr && sound->scene != scene) ms_sound_detach(sound);
+
+    if (sound->scene == nullptr) {
+        int emitter = ms_scene_add_emitter(scene, command);
+        if (emitter < 0) return MA_OUT_OF_MEMORY;
+        sound->scene   = scene;
+        sound->emitter = emitter;
+        ms_sound_classify(sound);
+        return MA_SUCCESS;
+    }
+
+    command.type    = MS_SCENE_EMITTER_SET;
+    command.emitter = (ma_uint32)sound->emitter;
+    return ms_scene_push(scene, command) ? MA_SUCCESS : MA_BUSY;
+}
+
+ma_result ms_sound_set_path(ms_sound* sound, ms_scene* scene, const ms_path* path) {
+    ms_scene_command command = {};
+    command.path = path;
+    ma_result result = ms_sound_set_emitter(sound, scene, command);
+    if (result == MA_SUCCESS) sound->path = path;
+    return result;
+}
+
+ma_result ms_sound_attach_to_entity(ms_sound* sound, ms_scene* scene, ms_entity* entity) {
+    ms_scene_command command = {};
+    command.entity = entity;
+    ma_result result = ms_sound_set_emitter(sound, scene, command);
+    if (result == MA_SUCCESS) sound->path = nullptr;
+    return result;
+}
+
+void ms_sound_detach(ms_sound* sound) {
+    if (sound->scene == nullptr) return;
+    #ifdef MS_HAS_OCCLUSION
+        ms_sound_set_occlusion(sound, sound->scene, false);
+    #endif
+    ma_uint32 index = sound->scene->command_write.load(std::memory_order_relaxed);
+    if (ms_scene_remove_emitter(sound->scene, sound->emitter)) {
+        sound->reached_by    = sound->scene;
+        sound->reached_until = index;
+    } else {
+        ms_scene_defer_remove(sound->scene, (ma_uint32)sound->emitter, sound);
+    }
+    sound->scene   = nullptr;
+    sound->emitter = -1;
+    sound->path    = nullptr;
+    ms_sound_classify(sound);
+}
+#endif /* MS_NO_SPATIALIZATION */
+
+void ms_sound_set_volume(ms_sound* sound, float volume) {
+    if (volume < 0.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_volume :: `volume` must be greater than or equal to 0" << std::endl;
+        #endif
+        volume = 0.0f;
+    }
+
+    sound->volume_range[0] = volume;
+    sound->volume_range[1] = volume;
+    ms_sound_table_sync(sound);
+}
+
+void ms_sound_set_volume(ms_sound* sound, float start, float end) {
+    if (start < end) { // swap start and end
+        float v0 = start;
+        float v1 = end;
+        start = v1;
+        end = v0;
+    }
+
+    if (start < 0.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_volume_range :: `start` must be greater than or equal to 0" << std::endl;
+        #endif
+        start = 0.0f;
+    }
+
+    sound->volume_range[0] = start;
+    sound->volume_range[1] = end;
+    ms_sound_table_sync(sound);
+}
+
+void ms_sound_set_pitch(ms_sound* sound, float pitch) {
+    if (pitch <= 0.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_pitch :: `pitch` must be greater than 0" << std::endl;
+        #endif
+    }
+
+    sound->pitch_range[0] = pitch;
+    sound->pitch_range[1] = pitch;
+    ms_sound_table_sync(sound);
+    ms_sound_classify(sound);
+}
+
+void ms_sound_set_pitch(ms_sound* sound, float start, float end) {
+    if (start < end) { // swap start and end
+        float p0 = start;
+        float p1 = end;
+        start = p1;
+        end = p0;
+    }
+
+    if (start <= 0.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_pitch_range :: `start` must be greater than 0" << std::endl;
+        #endif
+        start = 0.0f;
+    }
+
+    sound->pitch_range[0] = start;
+    sound->pitch_range[1] = end;
+    ms_sound_table_sync(sound);
+    ms_sound_classify(sound);
+}
+
+void ms_sound_set_pan(ms_sound* sound, float pan) {
+    if (pan < -1.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_pan :: `pan` must be greater than or equal to -1.0" << std::endl;
+        #endif
+        pan = -1.0f;
+    }
+
+    if (pan > 1.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_pan :: `pan` must be less than or equal to 1.0" << std::endl;
+        #endif
+        pan = 1.0f;
+    }
+
+    sound->pan_range[0] = pan;
+    sound->pan_range[1] = pan;
+    ms_sound_table_sync(sound);
+}
+
+void ms_sound_set_pan(ms_sound* sound, float start, float end) {
+    if (start < end) { // swap start and end
+        float p0 = start;
+        float p1 = end;
+        start = p1;
         end = p0;
     }
 
-    if (start <= 0.0f) {
+    if (start < -1.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_pan :: `pan` must be greater than or equal to -1.0" << std::endl;
+        #endif
+        start = -1.0f;
+    }
+
+    if (end > 1.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_pan :: `pan` must be less than or equal to 1.0" << std::endl;
+        #endif
+        end = 1.0f;
+    }
+
+    sound->pan_range[0] = start;
+    sound->pan_range[1] = end;
+    ms_sound_table_sync(sound);
+}
+
+#ifdef MS_HAS_FAST_PATHS
+// copy what miniaudio was told about `from` onto `to`, a copy of it made with other flags
+static void ms_voice_copy_state(const ma_sound* from, ma_sound* to) {
+    ma_sound_set_volume(to, ma_sound_get_volume(from));
+    ma_sound_set_pan(to, ma_sound_get_pan(from));
+    ma_sound_set_pan_mode(to, ma_sound_get_pan_mode(from));
+    ma_sound_set_pitch(to, ma_sound_get_pitch(from));
+    ma_sound_set_looping(to, ma_sound_is_looping(from));
+    ma_sound_set_spatialization_enabled(to, ma_sound_is_spatialization_enabled(from));
+    ma_sound_set_positioning(to, ma_sound_get_positioning(from));
+    ma_vec3f p = ma_sound_get_position(from);
+    ma_vec3f v = ma_sound_get_velocity(from);
+    ma_vec3f d = ma_sound_get_direction(from);
+    ma_sound_set_position(to, p.x, p.y, p.z);
+    ma_sound_set_velocity(to, v.x, v.y, v.z);
+    ma_sound_set_direction(to, d.x, d.y, d.z);
+    ma_sound_set_attenuation_model(to, ma_sound_get_attenuation_model(from));
+    ma_sound_set_rolloff(to, ma_sound_get_rolloff(from));
+    ma_sound_set_min_gain(to, ma_sound_get_min_gain(from));
+    ma_sound_set_max_gain(to, ma_sound_get_max_gain(from));
+    ma_sound_set_min_distance(to, ma_sound_get_min_distance(from));
+    ma_sound_set_max_distance(to, ma_sound_get_max_distance(from));
+    ma_sound_set_doppler_factor(to, ma_sound_get_doppler_factor(from));
+}
+
+// frames ahead of `engine`'s clock that the audio thread can't have reached yet, the block it may be mixing & the next
+static ma_uint64 ms_engine_lead(ma_engine* engine) {
+    ma_uint64 period = MS_RENDER_BLOCK;
+    ma_device* device = ma_engine_get_device(engine);
+    if (device != NULL && device->playback.internalPeriodSizeInFrames > period) period = device->playback.internalPeriodSizeInFrames;
+    return 2 * period;
+}
+
+// hand `previous`, playing, over to `s`, its copy: at a time the audio thread hasn't reached, `previous` fades out over
+// MS_HANDOVER_FADE frames as `s` fades in from where `previous` will be by then. false if `previous` ends before that
+static bool ms_voice_hand_over(ma_sound* previous, ma_sound* s) {
+    ma_engine* engine = ma_sound_get_engine(previous);
+    ma_uint32 engineRate = ma_engine_get_sample_rate(engine);
+    ma_uint32 rate = engineRate;
+    ma_sound_get_data_format(previous, NULL, NULL, &rate, NULL, 0);
+
+    // the cursor & the clock move together once a block, read them both in the same one
+    ma_uint64 now    = 0;
+    ma_uint64 cursor = 0;
+    for (int tries = 0; tries < 4; tries++) {
+        now = ma_engine_get_time_in_pcm_frames(engine);
+        ma_sound_get_cursor_in_pcm_frames(previous, &cursor);
+        if (ma_engine_get_time_in_pcm_frames(engine) == now) break;
+    }
+
+    // `previous` has no resampler, so it only moves at its file's rate
+    ma_uint64 at = now + ms_engine_lead(engine);
+    cursor += (at - now) * rate / engineRate;
+    ma_uint64 length = 0;
+    ma_sound_get_length_in_pcm_frames(previous, &length);
+    if (length > 0 && cursor >= length) {
+        if (!ma_sound_is_looping(previous)) return false;
+        cursor %= length;
+    }
+
+    ma_sound_set_stop_time_with_fade_in_pcm_frames(previous, at + MS_HANDOVER_FADE, MS_HANDOVER_FADE);
+    ma_sound_seek_to_pcm_frame(s, cursor);
+    ma_sound_set_fade_in_pcm_frames(s, 0.0f, 1.0f, MS_HANDOVER_FADE); // from the first frame it plays
+    ma_sound_set_start_time_in_pcm_frames(s, at);
+    ma_sound_start(s);
+    return true;
+}
+
+// make `sound`'s variants again with the resampler, miniaudio only takes MA_SOUND_FLAG_NO_PITCH at init. each copy
+// shares its file's data & is sent where the old variant went. every copy is made before any is used, if one can't be
+// they're all given back & the sound keeps going without the resampler until it's next classified. the one playing is
+// handed over by ms_voice_hand_over() & kept in `handed_over` until the sound goes, the rest are uninitialised, their
+// memory stays in the arena until the sound goes. game thread
+static void ms_sound_add_pitch_stage(ms_sound* sound) {
+    if (sound->sounds.empty()) {
+        sound->stages |= MS_SOUND_STAGE_PITCH;
+        return;
+    }
+    // voices over a caller's data source can't be copied, see ms_sound_init_from_data_source()
+    if (sound->sounds[0]->pResourceManagerDataSource == NULL) return;
+    ms_arena_mark mark = ms_arena_get_mark(&sound->arena);
+    ma_sound* voices   = ms_arena_new<ma_sound>(&sound->arena, sound->sounds.size());
+    if (voices == nullptr) return;
+
+    for (size_t i = 0; i < sound->sounds.size(); i++) {
+        ma_sound* previous = sound->sounds[i];
+        ma_uint32 flags    = MA_SOUND_FLAG_NO_DEFAULT_ATTACHMENT;
+        if (!ma_sound_is_spatialization_enabled(previous)) flags |= MA_SOUND_FLAG_NO_SPATIALIZATION;
+        if (ma_sound_init_copy(ma_sound_get_engine(previous), previous, flags, NULL, &voices[i]) != MA_SUCCESS) {
+            for (size_t j = 0; j < i; j++) ma_sound_uninit(&voices[j]);
+            ms_arena_rewind(&sound->arena, mark);
+            return;
+        }
+    }
+    #ifdef MS_HAS_LOD
+        ms_sound_reset_lod(sound); // the graph hands the playing one over, the bed can't
+    #endif
+
+    for (size_t i = 0; i < sound->sounds.size(); i++) {
+        ma_sound* previous = sound->sounds[i];
+        ma_sound* s        = &voices[i];
+        ma_engine* engine  = ma_sound_get_engine(previous);
+        ms_voice_copy_state(previous, s);
+        ms_node_profile_watch(s, sound->name, sound, nullptr);
+
+        // where the old one went, its output isn't something miniaudio lets us ask for
+        ma_node* output = ma_engine_get_endpoint(engine);
+        ma_uint32 bus   = 0;
+        #ifndef MS_NO_SPATIALIZATION
+            output = ms_sound_output(sound, engine, &bus);
+            #ifdef MS_HAS_OCCLUSION
+                if (sound->occlusion != nullptr) {
+                    output = sound->occlusion;
+                    bus    = 0;
+                }
+            #endif
+        #endif
+        ma_node_attach_output_bus(s, 0, output, bus);
+
+        bool handed = ma_sound_is_playing(previous) && ms_voice_hand_over(previous, s);
+        if ((int)i == sound->active) {
+            #ifdef MS_HAS_AMBISONICS
+                if (sound->ambisonic != nullptr) ms_ambisonic_voice_set(sound->ambisonic, s);
+            #endif
+            #ifdef MS_HAS_SPEAKER_ARRAY
+                if (sound->speaker_array != nullptr) ms_speaker_voice_set(sound->speaker_array, s);
+            #endif
+        }
+        if (sound->table != nullptr) sound->table->variants[sound->table->variant_first[sound->handle] + i] = s;
+        sound->sounds[i] = s;
+
+        // a batch still on the ring may name the old one, it's then stopped & left to the scene to free
+        if (handed) sound->handed_over.push_back(previous);
+        else        ms_sound_let_go(sound, { previous }, nullptr);
+    }
+    sound->stages |= MS_SOUND_STAGE_PITCH;
+}
+#endif /* MS_HAS_FAST_PATHS */
+
+// work out which of miniaudio's stages `sound` needs from its pitch range & whether anything places it, after
+// anything that changes either. a sound that sits on the listener skips the spatializer, which is switched straight
+// away. a sound that can't doppler & has a pitch of 1 skips the resampler, which once added stays
+static void ms_sound_classify(ms_sound* sound) {
+    ma_uint32 stages = 0;
+    #ifdef MS_HAS_FAST_PATHS
+        bool pitch = sound->repitched || sound->pitch_range[0] != 1.0f || sound->pitch_range[1] != 1.0f;
+        #ifndef MS_NO_SPATIALIZATION
+            bool placed = !sound->speakers.empty() || sound->scene != nullptr || sound->positioned;
+            if (sound->spatialized && placed) stages |= MS_SOUND_STAGE_SPATIALIZER;
+            pitch = pitch || (sound->spatialized && sound->scene != nullptr); // only emitters are given a velocity to doppler with
+        #endif
+        if (pitch && (sound->stages & MS_SOUND_STAGE_PITCH) == 0) ms_sound_add_pitch_stage(sound);
+        stages |= sound->stages & MS_SOUND_STAGE_PITCH;
+    #else
+        stages |= MS_SOUND_STAGE_PITCH;
+        #ifndef MS_NO_SPATIALIZATION
+            if (sound->spatialized) stages |= MS_SOUND_STAGE_SPATIALIZER;
+        #endif
+    #endif
+
+    bool spatializer = ((stages ^ sound->stages) & MS_SOUND_STAGE_SPATIALIZER) != 0;
+    sound->stages    = stages;
+    #ifndef MS_NO_SPATIALIZATION
+        if (spatializer) ms_sound_apply_spatializer(sound);
+    #else
+        (void)spatializer;
+    #endif
+}
+
+/* --- ms_sound_table --- */
+
+// copy `sound`'s ranges, weight & flags into its table, after anything that changes them
+static void ms_sound_table_sync(const ms_sound* sound) {
+    ms_sound_table* table = sound->table;
+    if (table == nullptr) return;
+
+    ms_sound_handle h      = sound->handle;
+    table->volume_start[h] = sound->volume_range[0];
+    table->volume_end[h]   = sound->volume_range[1];
+    table->pan_start[h]    = sound->pan_range[0];
+    table->pan_end[h]      = sound->pan_range[1];
+    table->pitch_start[h]  = sound->pitch_range[0];
+    table->pitch_end[h]    = sound->pitch_range[1];
+    table->weight[h]       = (ma_uint32)sound->weight;
+    table->ids[h]          = sound->id;
+    table->flags[h]        = sound->empty ? MS_SOUND_TABLE_EMPTY : 0;
+}
+
+// the sounds in `table` are left as they are, just no longer mirrored
+void ms_sound_table_uninit(ms_sound_table* table) {
+    for (ms_sound* sound : table->sounds) sound->table = nullptr;
+    *table = ms_sound_table();
+}
+
+// mirror `sound` in `table`, once it's been through ms_sound_init(). the ms_sound_set_*() functions keep the table up
+// to date & ms_sound_uninit() takes the sound out again. a sound is in one table at a time
+ms_sound_handle ms_sound_table_add(ms_sound_table* table, ms_sound* sound) {
+    if (sound->table == table) return sound->handle;
+    if (sound->table != nullptr) ms_sound_table_remove(sound->table, sound);
+
+    ms_sound_handle h = (ms_sound_handle)table->sounds.size();
+    table->sounds.push_back(sound);
+    table->ids.push_back(MS_ID_NONE);
+    table->volume_start.push_back(0.0f);
+    table->volume_end.push_back(0.0f);
+    table->pan_start.push_back(0.0f);
+    table->pan_end.push_back(0.0f);
+    table->pitch_start.push_back(0.0f);
+    table->pitch_end.push_back(0.0f);
+    table->weight.push_back(0);
+    table->flags.push_back(0);
+    table->variant_first.push_back((ma_uint32)table->variants.size());
+    table->variant_count.push_back((ma_uint32)sound->sounds.size());
+    table->variants.insert(table->variants.end(), sound->sounds.begin(), sound->sounds.end());
+
+    sound->table  = table;
+    sound->handle = h;
+    ms_sound_table_sync(sound);
+    return h;
+}
+
+// the last sound in the table takes the handle `sound` leaves, every other handle stays as it was
+void ms_sound_table_remove(ms_sound_table* table, ms_sound* sound) {
+    if (sound->table != table) return;
+
+    ms_sound_handle h = sound->handle;
+    ma_uint32 first   = table->variant_first[h];
+    ma_uint32 count   = table->variant_count[h];
+    table->variants.erase(table->variants.begin() + first, table->variants.begin() + first + count);
+    for (ma_uint32& f : table->variant_first) {
+        if (f > first) f -= count;
+    }
+
+    ms_sound_handle last     = (ms_sound_handle)table->sounds.size() - 1;
+    table->sounds[h]         = table->sounds[last];
+    table->ids[h]            = table->ids[last];
+    table->volume_start[h]   = table->volume_start[last];
+    table->volume_end[h]     = table->volume_end[last];
+    table->pan_start[h]      = table->pan_start[last];
+    table->pan_end[h]        = table->pan_end[last];
+    table->pitch_start[h]    = table->pitch_start[last];
+    table->pitch_end[h]      = table->pitch_end[last];
+    table->weight[h]         = table->weight[last];
+    table->flags[h]          = table->flags[last];
+    table->variant_first[h]  = table->variant_first[last];
+    table->variant_count[h]  = table->variant_count[last];
+    table->sounds[h]->handle = h;
+
+    table->sounds.pop_back();
+    table->ids.pop_back();
+    table->volume_start.pop_back();
+    table->volume_end.pop_back();
+    table->pan_start.pop_back();
+    table->pan_end.pop_back();
+    table->pitch_start.pop_back();
+    table->pitch_end.pop_back();
+    table->weight.pop_back();
+    table->flags.pop_back();
+    table->variant_first.pop_back();
+    table->variant_count.pop_back();
+
+    sound->table  = nullptr;
+    sound->handle = 0;
+}
+
+// start every sound in `handles` that isn't already playing, as calling ms_sound_start() on each in turn would. the
+// variants, volumes, pans & pitches of the whole batch are chosen first in one pass over the table, then the voices
+// are set up & started. give each handle once. `results`, if given, gets what each start returned
+void ms_sound_table_start(ms_sound_table* table, const ms_sound_handle* handles, size_t count, ma_result* results) {
+    table->choices.resize(count);
+    table->chosen.resize(count);
+
+    size_t chosen = 0;
+    for (size_t k = 0; k < count; k++) {
+        ms_sound_handle h = handles[k];
+        ma_uint32 first   = table->variant_first[h];
+        ma_uint32 amount  = table->variant_count[h];
+        if (results != nullptr) results[k] = MA_SUCCESS;
+
+        bool playing = false;
+        for (ma_uint32 v = 0; v < amount && !playing; v++) playing = ma_sound_is_playing(table->variants[first + v]);
+        if (playing || amount == 0 || (table->flags[h] & MS_SOUND_TABLE_EMPTY) != 0) {
+            ms_trace_instant("ms_sound_start rejected", table->sounds[h]->name.c_str());
+            continue;
+        }
+
+        table->choices[k] = ms_sound_choose(amount, table->volume_start[h], table->volume_end[h],
+            table->pan_start[h], table->pan_end[h], table->pitch_start[h], table->pitch_end[h]);
+        table->chosen[chosen++] = (ma_uint32)k;
+    }
+    MS_METRIC_ADD(voices_rejected, count - chosen);
+
+    for (size_t c = 0; c < chosen; c++) {
+        ma_uint32 k      = table->chosen[c];
+        ma_result result = ms_sound_start_choice(table->sounds[handles[k]], table->choices[k], ms_trace_begin());
+        if (results != nullptr) results[k] = result;
+    }
+}
+
+// a sound in `table` at random, each as likely as its weight says & placeholders never. MS_SOUND_HANDLE_NONE if
+// there's nothing to pick
+ms_sound_handle ms_sound_table_pick(const ms_sound_table* table) {
+    ma_uint64 total = 0;
+    for (size_t h = 0; h < table->weight.size(); h++) {
+        if ((table->flags[h] & MS_SOUND_TABLE_EMPTY) == 0) total += table->weight[h];
+    }
+    if (total == 0) return MS_SOUND_HANDLE_NONE;
+
+    ma_uint64 r = ms_rand() % total;
+    for (size_t h = 0; h < table->weight.size(); h++) {
+        if ((table->flags[h] & MS_SOUND_TABLE_EMPTY) != 0) continue;
+        if (r < table->weight[h]) return (ms_sound_handle)h;
+        r -= table->weight[h];
+    }
+    return MS_SOUND_HANDLE_NONE;
+}
+
+// the first sound in `table` called `id`, MS_SOUND_HANDLE_NONE if there's none. for tools & loading configs
+ms_sound_handle ms_sound_table_find(const ms_sound_table* table, ms_id id) {
+    if (id == MS_ID_NONE) return MS_SOUND_HANDLE_NONE;
+    for (size_t h = 0; h < table->ids.size(); h++) {
+        if (table->ids[h] == id) return (ms_sound_handle)h;
+    }
+    return MS_SOUND_HANDLE_NONE;
+}
+
+ms_sound_handle ms_sound_table_find(const ms_sound_table* table, const std::string& name) {
+    return ms_sound_table_find(table, ms_lookup(name));
+}
+
+/* --- ms_soundscape --- */
+
+#ifndef MS_NO_SOUNDSCAPE
+
+ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, const unsigned int soundsAmount, ...);
+ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, ms_sound* sound);
+ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape);
+ma_result ms_soundscape_init_from_data_source(const std::string name, ma_engine* engine, ma_data_source* ambient, ms_soundscape* soundscape, const unsigned int soundsAmount, ...);
+void      ms_soundscape_uninit(ms_soundscape* soundscape); // its ambient & bed, the sounds added to it are left to their owner
+
+#ifdef MS_VERBOSE
+void      ms_soundscape_debug_list(ms_soundscape* soundscape);
+#endif
+
+void      ms_soundscape_add_sound(ms_soundscape* soundscape, const unsigned int soundsAmount, ...);
+void      ms_soundscape_add_sound(ms_soundscape* soundscape, ms_sound* sound);
+ms_sound* ms_soundscape_find_sound(const ms_soundscape* soundscape, ms_id id);
+ms_sound* ms_soundscape_find_sound(const ms_soundscape* soundscape, const std::string& name);
+void      ms_soundscape_set_tickrate(ms_soundscape* soundscape, float tickrate);
+
+bool      ms_soundscape_is_playing(const ms_soundscape* soundscape);
+
+ma_result ms_soundscape_tick(ms_soundscape* soundscape);
+ma_result ms_soundscape_start(const ms_soundscape* soundscape);
+ma_result ms_soundscape_stop(const ms_soundscape* soundscape);
+ma_result ms_soundscape_play_sound(const ms_soundscape* soundscape);
+ma_result ms_soundscape_play_sound_skip_empty(const ms_soundscape* soundscape);
+void      ms_soundscape_stop_all_sounds(const ms_soundscape* soundscape);
+
+void      ms_soundscape_set_volume(ms_soundscape* soundscape, float volume);
+void      ms_soundscape_set_volume(ms_soundscape* soundscape, float start, float end);
+void      ms_soundscape_set_pitch(ms_soundscape* soundscape, float pitch);
+void      ms_soundscape_set_pitch(ms_soundscape* soundscape, float start, float end);
+void      ms_soundscape_set_pan(ms_soundscape* soundscape, float pan);
+void      ms_soundscape_set_pan(ms_soundscape* soundscape, float start, float end);
+
+ma_result ms_render(ms_soundscape* const* soundscapes, size_t soundscapesAmount, const std::string filepath, double seconds, ms_render_stats* stats = nullptr, ma_format format = ma_format_f32);
+ma_result ms_render(ms_soundscape* soundscape, const std::string filepath, double seconds, ms_render_stats* stats = nullptr, ma_format format = ma_format_f32);
+
+#ifdef MS_HAS_LOD
+void         ms_soundscape_set_lod(ms_soundscape* soundscape, float near_distance, float far_distance);
+void         ms_soundscape_update_lod(ms_soundscape* soundscape);
+ms_lod_stats ms_soundscape_get_lod_stats(const ms_soundscape* soundscape);
+static bool  ms_soundscape_lod_sound(const ms_soundscape* soundscape, ms_sound* sound);
+#endif /* MS_HAS_LOD */
+
+static vector<ms_sound*> ms_soundscape_unique_sounds(const ms_soundscape* soundscape);
+
+// everything but the ambient, which the caller has already set up
+static ma_result ms_soundscape_init_va(ms_soundscape* soundscape, const unsigned int soundsAmount, va_list vl) {
+    ms_node_profile_watch_engine(soundscape->engine);
+    if (soundscape->ambient != nullptr) {
+        ma_sound_set_looping(soundscape->ambient, true);
+        ms_node_profile_watch(soundscape->ambient, soundscape->name + " ambient", nullptr, soundscape);
+        ms_node_profile_attach(soundscape->engine, soundscape->ambient);
+    }
+
+    soundscape->timeSinceLastTick = 0;
+    soundscape->tickrate = MS_DEFAULT_TICK_RATE * MS_SAMPLE_RATE;
+
+    #ifdef MS_HAS_LOD
+        soundscape->bed = new ms_lod_bed();
+        ms_lod_bed_init(soundscape->bed, soundscape->engine);
+        ms_node_profile_watch(&soundscape->bed->base, soundscape->name + " bed", nullptr, soundscape);
+        soundscape->lod_near  = MS_DEFAULT_LOD_NEAR_DISTANCE;
+        soundscape->lod_far   = MS_DEFAULT_LOD_FAR_DISTANCE;
+        soundscape->lod_stats = {};
+    #endif
+
+    for (size_t i = 0; i < soundsAmount; i++) {
+        ms_sound* s = va_arg(vl, ms_sound*);
+        for (int i = 0; i < s->weight; i++) {
+            soundscape->sounds.push_back(s);
+        }
+    }
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_soundscape_init :: initialising " << soundscape->name << " with " << soundsAmount << " ms_sound(s):" << std::endl;
+    #endif
+
+    #ifdef MS_HAS_METRICS
+        g_ms_metrics.soundscapes.push_back(soundscape);
+    #endif
+
+    return MA_SUCCESS;
+}
+
+ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, const unsigned int soundsAmount, ...) {
+    soundscape->name = name;
+    soundscape->id   = ms_intern(name);
+    soundscape->engine = engine;
+
+    // check if the fifth & fourth to last characters in `ambientFilepath` are not '.'
+    // this means the user can input "file.wav", "file.mp3", "file.flac", and "file" and all are valid
+    // we default to using .wav as it is a more common file type
+    // this means we can make the function less verbose by implying the filetype in the filepath dynamically (as opposed to having a whole new argument that would have to be specified) :-)
+    if (ambientFilepath[ambientFilepath.size() - 4] != '.' && ambientFilepath[ambientFilepath.size() - 5] != '.') ambientFilepath += ".wav";
+
+    ma_sound* ambient = ms_arena_new<ma_sound>(&soundscape->arena);
+    ma_uint64 traced = ms_trace_begin();
+    #ifdef MS_HAS_METRICS
+        auto started = std::chrono::steady_clock::now();
+    #endif
+    ma_result loaded = ma_sound_init_from_file(soundscape->engine, ambientFilepath.c_str(), MS_NODE_PROFILE_FLAGS, NULL, NULL, ambient);
+    ms_trace_end("load", traced, ambientFilepath.c_str());
+    #ifdef MS_HAS_METRICS
+        ms_metrics_load(ambient, loaded, ambientFilepath, soundscape->name, std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    #endif
+    soundscape->ambient = (loaded == MA_SUCCESS) ? ambient : nullptr; // the soundbites still play without it
+
+    va_list vl;
+    va_start(vl, soundsAmount);
+    ma_result result = ms_soundscape_init_va(soundscape, soundsAmount, vl);
+    va_end(vl);
+    return (loaded == MA_SUCCESS) ? result : loaded;
+}
+
+// the same, with any data source (an ms_ambience, a decoder, ...) as the ambient. it has to outlive the soundscape
+ma_result ms_soundscape_init_from_data_source(const std::string name, ma_engine* engine, ma_data_source* ambient, ms_soundscape* soundscape, const unsigned int soundsAmount, ...) {
+    soundscape->name = name;
+    soundscape->id   = ms_intern(name);
+    soundscape->engine = engine;
+
+    soundscape->ambient = ms_arena_new<ma_sound>(&soundscape->arena);
+    ma_result result = ma_sound_init_from_data_source(soundscape->engine, ambient, MS_NODE_PROFILE_FLAGS, NULL, soundscape->ambient);
+    if (result != MA_SUCCESS) {
+        ms_arena_release(&soundscape->arena);
+        soundscape->ambient = nullptr;
+        return result;
+    }
+
+    va_list vl;
+    va_start(vl, soundsAmount);
+    result = ms_soundscape_init_va(soundscape, soundsAmount, vl);
+    va_end(vl);
+    return result;
+}
+
+ma_result ms_soundscape_init(std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, ms_sound* sound) {
+    return ms_soundscape_init(name, engine, ambientFilepath, soundscape, 1, sound);
+}
+
+ma_result ms_soundscape_init(std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape) {
+    return ms_soundscape_init(name, engine, ambientFilepath, soundscape, 0, "this is ignored");
+}
+
+// the sounds added to `soundscape` are left alone, uninitialise them yourself. a far voice mixed into the bed goes
+// back to its output first, as if it had come near
+void ms_soundscape_uninit(ms_soundscape* soundscape) {
+    #ifdef MS_HAS_METRICS
+        vector<const ms_soundscape*>& registered = g_ms_metrics.soundscapes;
+        registered.erase(std::remove(registered.begin(), registered.end(), soundscape), registered.end());
+    #endif
+
+    soundscape->sounds.clear();
+
+    if (soundscape->ambient != nullptr) {
+        #ifdef MS_HAS_METRICS
+            ms_metrics_unload(soundscape->ambient);
+        #endif
+        ma_sound_uninit(soundscape->ambient);
+        ms_node_profile_forget(soundscape->ambient);
+        soundscape->ambient = nullptr;
+    }
+    #ifdef MS_HAS_LOD
+        // a sound takes itself out of the bed when it's uninitialised, so the ones left are still there & go back
+        // into the graph
+        for (ms_sound* sound : soundscape->bed->sounds) {
+            if (sound != nullptr) ms_sound_reset_lod(sound);
+        }
+        ma_node_uninit(&soundscape->bed->base, NULL);
+        ms_node_profile_forget(&soundscape->bed->base);
+        delete soundscape->bed;
+        soundscape->bed = nullptr;
+    #endif
+    ms_arena_release(&soundscape->arena);
+}
+
+#ifdef MS_VERBOSE
+void ms_soundscape_debug_list(ms_soundscape* soundscape) {
+    std::cout << "ms_soundscape_debug_list :: " << soundscape->name << std::endl;
+    for (size_t i = 0; i < soundscape->sounds.size(); i++) {
+        std::cout << "ms_soundscape_debug_list :: " << soundscape->sounds[i]->name << std::endl;
+    }
+}
+#endif
+
+ma_result ms_soundscape_tick(ms_soundscape* soundscape) {
+    #ifdef MS_HAS_LOD
+        ms_soundscape_update_lod(soundscape); // voices move between ticks, so level of detail is updated on every call
+    #endif
+    if (ma_engine_get_time_in_pcm_frames(soundscape->engine) < soundscape->timeSinceLastTick + soundscape->tickrate) return MA_SUCCESS; // not enough time has passed for us to tick yet
+    #ifdef MS_VERBOSE
+        std::cout << "ms_soundscape_tick :: " << soundscape->name << " ticking" << std::endl;
+    #endif
+    soundscape->timeSinceLastTick = ma_engine_get_time_in_pcm_frames(soundscape->engine);
+    MS_METRIC_ADD(ticks, 1);
+    ma_uint64 traced = ms_trace_begin();
+    ms_soundscape_play_sound(soundscape);
+    ms_trace_end("ms_soundscape_tick", traced, soundscape->name.c_str());
+    return MA_SUCCESS;
+}
+
+void ms_soundscape_add_sound(ms_soundscape* soundscape, const unsigned int soundsAmount, ...) {
+    va_list vl;
+    va_start(vl, soundsAmount);
+    for (size_t i = 0; i < soundsAmount; i++) {
+        ms_soundscape_add_sound(soundscape, va_arg(vl, ms_sound*));
+    }
+    va_end(vl);
+}
+
+void ms_soundscape_add_sound(ms_soundscape* soundscape, ms_sound* sound) {
+    #ifdef MS_VERBOSE
+        std::cout << "ms_soundscape_add_sound :: adding " << sound->name << " to " << soundscape->name << std::endl;
+    #endif
+    for (int i = 0; i < sound->weight; i++) {
+        soundscape->sounds.push_back(sound);
+    }
+}
+
+// the first sound in `soundscape` called `id`, nullptr if there's none
+ms_sound* ms_soundscape_find_sound(const ms_soundscape* soundscape, ms_id id) {
+    if (id == MS_ID_NONE) return nullptr;
+    for (ms_sound* sound : soundscape->sounds) {
+        if (sound->id == id) return sound;
+    }
+    return nullptr;
+}
+
+ms_sound* ms_soundscape_find_sound(const ms_soundscape* soundscape, const std::string& name) {
+    return ms_soundscape_find_sound(soundscape, ms_lookup(name));
+}
+
+void ms_soundscape_set_tickrate(ms_soundscape* soundscape, float tickrate) {
+    if (tickrate < 0) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_soundscape_set_tickrate :: " << soundscape->name << ", tickrate below zero" << std::endl;
+        #endif
+        tickrate = 0;
+    }
+    soundscape->tickrate = tickrate * MS_SAMPLE_RATE;
+}
+
+bool ms_soundscape_is_playing(const ms_soundscape* soundscape) {
+    for (ms_sound* s : soundscape->sounds) {
+        if (ms_sound_is_playing(s)) return true;
+    }
+    return false;
+}
+
+// https://github.com/mackron/miniaudio/issues/714
+ma_result ms_soundscape_start(const ms_soundscape* soundscape) {
+    if (soundscape->ambient != nullptr) {
+        // ma_sound_set_stop_time_in_milliseconds(soundscape->ambient, ~(ma_uint64)0);
+        // ma_sound_set_fade_in_milliseconds(soundscape->ambient, 0.0f, 1.0f, FADE_AMOUNT_MS);
+        ma_sound_set_stop_time_in_milliseconds(soundscape->ambient, ~(ma_uint64)0);
+        ma_sound_set_fade_in_pcm_frames(soundscape->ambient, 0.0f, 1.0f, MS_DEFAULT_FADE_AMOUNT);
+        ma_sound_start(soundscape->ambient);
+        ms_trace_ahead("fade in", MS_DEFAULT_FADE_AMOUNT_SECONDS, soundscape->name.c_str());
+    }
+    return MA_SUCCESS;
+}
+
+ma_result ms_soundscape_stop(const ms_soundscape* soundscape) {
+    // ma_sound_set_fade_in_milliseconds(soundscape->ambient, -1.0f, 0.0f, FADE_AMOUNT_MS);
+    ma_sound_set_fade_in_pcm_frames(soundscape->ambient, -1.0f, 0.0f, MS_DEFAULT_FADE_AMOUNT);
+    ma_sound_set_stop_time_in_pcm_frames(soundscape->ambient, ma_engine_get_time_in_pcm_frames(soundscape->engine) + MS_DEFAULT_FADE_AMOUNT);
+    ms_trace_ahead("fade out", MS_DEFAULT_FADE_AMOUNT_SECONDS, soundscape->name.c_str());
+    return MA_SUCCESS;
+}
+
+ma_result ms_soundscape_play_sound(const ms_soundscape* soundscape) {
+    if (soundscape->sounds.empty()) return MA_INVALID_OPERATION;
+    ms_sound* sound = soundscape->sounds[ms_rand() % soundscape->sounds.size()];
+    ma_result result = ms_sound_start(sound);
+    #ifdef MS_HAS_LOD
+        ms_soundscape_lod_sound(soundscape, sound); // tier the new voice now rather than on the next tick
+    #endif
+    return result;
+}
+
+ma_result ms_soundscape_play_sound_skip_empty(const ms_soundscape* soundscape) {
+    if (soundscape->sounds.empty()) return MA_INVALID_OPERATION;
+    ms_sound* sound = soundscape->sounds[ms_rand() % soundscape->sounds.size()];
+    for (size_t i = 0; i < soundscape->sounds.size(); i++) {
+        size_t r = ms_rand() % soundscape->sounds.size();
+        if (!soundscape->sounds[r]->empty) {
+            sound = soundscape->sounds[r];
+            break;
+        }
+    }
+    ma_result result = ms_sound_start(sound);
+    #ifdef MS_HAS_LOD
+        ms_soundscape_lod_sound(soundscape, sound);
+    #endif
+    return result;
+}
+
+// every sound in `soundscape` once, weighted sounds are added several times & the setters below scale what's there
+static vector<ms_sound*> ms_soundscape_unique_sounds(const ms_soundscape* soundscape) {
+    vector<ms_sound*> sounds(soundscape->sounds);
+    std::sort(sounds.begin(), sounds.end());
+    sounds.erase(std::unique(sounds.begin(), sounds.end()), sounds.end());
+    return sounds;
+}
+
+void ms_soundscape_stop_all_sounds(const ms_soundscape* soundscape) {
+    for (ms_sound* sound : soundscape->sounds) {
+        ms_sound_stop(sound);
+    }
+}
+
+void ms_soundscape_set_volume(ms_soundscape* soundscape, float volume) {
+    for (ms_sound* s : ms_soundscape_unique_sounds(soundscape)) {
+        ms_sound_set_volume(s, s->volume_range[0] * volume, s->volume_range[1] * volume);
+    }
+}
+
+void ms_soundscape_set_volume(ms_soundscape* soundscape, float start, float end) {
+    for (ms_sound* s : ms_soundscape_unique_sounds(soundscape)) {
+        ms_sound_set_volume(s, s->volume_range[0] * start, s->volume_range[1] * end);
+    }
+}
+
+void ms_soundscape_set_pitch(ms_soundscape* soundscape, float pitch) {
+    for (ms_sound* s : ms_soundscape_unique_sounds(soundscape)) {
+        ms_sound_set_pitch(s, s->pitch_range[0] * pitch, s->pitch_range[1] * pitch);
+    }
+}
+
+void ms_soundscape_set_pitch(ms_soundscape* soundscape, float start, float end) {
+    for (ms_sound* s : ms_soundscape_unique_sounds(soundscape)) {
+        ms_sound_set_pitch(s, s->pitch_range[0] * start, s->pitch_range[1] * end);
+    }
+}
+
+void ms_soundscape_set_pan(ms_soundscape* soundscape, float pan) {
+    for (ms_sound* s : ms_soundscape_unique_sounds(soundscape)) {
+        ms_sound_set_pan(s, pan, pan);
+    }
+}
+
+void ms_soundscape_set_pan(ms_soundscape* soundscape, float start, float end) {
+    for (ms_sound* s : ms_soundscape_unique_sounds(soundscape)) {
+        ms_sound_set_pan(s, start, end);
+    }
+
+}
+
+#ifdef MS_HAS_LOD
+
+void ms_soundscape_set_lod(ms_soundscape* soundscape, float near_distance, float far_distance) {
+    if (near_distance < 0.0f) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_soundscape_set_lod :: `near_distance` must be greater than or equal to 0" << std::endl;
+        #endif
+        near_distance = 0.0f;
+    }
+
+    if (far_distance < near_distance) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_soundscape_set_lod :: `far_distance` must be greater than or equal to `near_distance`" << std::endl;
+        #endif
+        far_distance = near_distance;
+    }
+
+    soundscape->lod_near = near_distance;
+    soundscape->lod_far  = far_distance;
+}
+
+// distance from the listener to `voice`, and how far to the listener's right it is (-1.0f to 1.0f)
+static float ms_lod_locate(ma_engine* engine, const ma_sound* voice, float* pan) {
+    ma_vec3f p = ma_sound_get_position(voice);
+    float right;
+
+    if (ma_sound_get_positioning(voice) == ma_positioning_relative) {
+        right = p.x; // relative positions are already in listener space, +x is to the right
+    } else {
+        ma_uint32 l  = ma_sound_get_listener_index(voice);
+        ma_vec3f lp  = ma_engine_listener_get_position(engine, l);
+        ma_vec3f dir = ma_engine_listener_get_direction(engine, l);
+        ma_vec3f up  = ma_engine_listener_get_world_up(engine, l);
+        p.x -= lp.x; p.y -= lp.y; p.z -= lp.z;
+
+        // the listener's right is direction x up
+        float rx = dir.y * up.z - dir.z * up.y;
+        float ry = dir.z * up.x - dir.x * up.z;
+        float rz = dir.x * up.y - dir.y * up.x;
+        float rl = sqrtf(rx*rx + ry*ry + rz*rz);
+        right = (rl > 0.0f) ? (p.x*rx + p.y*ry + p.z*rz) / rl : 0.0f;
+    }
+
+    float distance = sqrtf(p.x*p.x + p.y*p.y + p.z*p.z);
+    *pan = (distance > 0.0f) ? right / distance : 0.0f;
+    return distance;
+}
+
+// pick a tier for `distance`, a voice has to cross a threshold by MS_LOD_HYSTERESIS before it leaves its current tier
+static ms_lod_tier ms_lod_classify(const ms_soundscape* soundscape, ms_lod_tier current, float distance) {
+    float nearEdge = soundscape->lod_near * (current == MS_LOD_NEAR ? 1.0f + MS_LOD_HYSTERESIS : 1.0f - MS_LOD_HYSTERESIS);
+    float farEdge  = soundscape->lod_far  * (current == MS_LOD_FAR  ? 1.0f - MS_LOD_HYSTERESIS : 1.0f + MS_LOD_HYSTERESIS);
+    if (distance < nearEdge) return MS_LOD_NEAR;
+    if (distance > farEdge)  return MS_LOD_FAR;
+    return MS_LOD_MID;
+}
+
+// re-tier the playing variant of `sound`, returns false if there is nothing to tier
+static bool ms_soundscape_lod_sound(const ms_soundscape* soundscape, ms_sound* sound) {
+    if ((sound->stages & MS_SOUND_STAGE_SPATIALIZER) == 0 || sound->active < 0) return false;
+    #ifdef MS_HAS_AMBISONICS
+        if (sound->ambisonic != nullptr) return false; // the bus pans it
+    #endif
+    #ifdef MS_HAS_SPEAKER_ARRAY
+        if (sound->speaker_array != nullptr) return false;
+    #endif
+    ma_sound* voice = sound->sounds[sound->active];
+    if (!ma_sound_is_playing(voice)) return false;
+
+    float pan;
+    float distance   = ms_lod_locate(soundscape->engine, voice, &pan);
+    ms_lod_tier tier = ms_lod_classify(soundscape, sound->lod_tier, distance);
+
+    #ifdef MS_HAS_OCCLUSION
+        if (sound->occlusion != nullptr) tier = MS_LOD_NEAR; // the filter is in the graph, the voice has to stay there
+    #endif
+
+    if (tier == MS_LOD_NEAR) {
+        ms_sound_reset_lod(sound);
+        return true;
+    }
+    if (sound->bed == nullptr && !ms_lod_bed_add(soundscape->bed, sound, voice)) {
+        sound->lod_tier = MS_LOD_NEAR; // the bed is full, or can't read this voice
+        return true;
+    }
+
+    // the bed adds the voice's own volume & pan on top, as the graph would
+    ms_lod_bed* bed = sound->bed;
+    bed->gains[sound->bed_slot].store(ms_voice_attenuation(voice, distance), std::memory_order_relaxed);
+    bed->pans[sound->bed_slot].store(pan, std::memory_order_relaxed);
+    bed->far[sound->bed_slot].store(tier == MS_LOD_FAR, std::memory_order_relaxed);
+    sound->lod_tier = tier;
+    return true;
+}
+
+// what the playing variant of `sound` has spent processing since the last call, put in the tier it was in. 0 when
+// its nodes aren't timed
+static double ms_lod_take_seconds(const ms_sound* sound) {
+    #ifdef MS_PROFILE_NODES
+        if (sound->active < 0) return 0.0;
+        ma_node_base* base = (ma_node_base*)sound->sounds[sound->active];
+        if (base->vtable->onProcess != ms_node_profile_process) return 0.0;
+
+        ms_node_profile* profile = (ms_node_profile*)base->vtable;
+        ma_uint64 ns = profile->ns.load(std::memory_order_relaxed);
+        if (ns < profile->tiered_ns) profile->tiered_ns = 0; // reset since
+        double seconds = (ns - profile->tiered_ns) / 1e9;
+        profile->tiered_ns = ns;
+        return seconds;
+    #else
+        (void)sound;
+        return 0.0;
+    #endif
+}
+
+void ms_soundscape_update_lod(ms_soundscape* soundscape) {
+    ms_lod_stats* stats = &soundscape->lod_stats;
+    ma_uint64 now       = ma_engine_get_time_in_pcm_frames(soundscape->engine);
+
+    // what each tier played since the last update, by the voices tiered then
+    if (now > stats->last_update) {
+        for (int tier = MS_LOD_NEAR; tier <= MS_LOD_FAR; tier++) stats->voice_frames[tier] += (now - stats->last_update) * stats->voices[tier];
+    }
+    const ms_sound* previous = nullptr;
+    for (const ms_sound* s : soundscape->sounds) {
+        if (s == previous) continue;
+        previous = s;
+        if ((s->stages & MS_SOUND_STAGE_SPATIALIZER) != 0) stats->dsp_seconds[MS_LOD_NEAR] += ms_lod_take_seconds(s);
+    }
+    // the bed times its own mixes, whichever nodes are profiled
+    ms_lod_bed* bed = soundscape->bed;
+    for (int tier = MS_LOD_MID; tier <= MS_LOD_FAR; tier++) {
+        ma_uint64 ns = bed->ns[tier].load(std::memory_order_relaxed);
+        stats->dsp_seconds[tier] += (ns - bed->taken_ns[tier]) / 1e9;
+        bed->taken_ns[tier] = ns;
+    }
+    stats->last_update = now;
+    stats->voices[MS_LOD_NEAR] = 0;
+    stats->voices[MS_LOD_MID]  = 0;
+    stats->voices[MS_LOD_FAR]  = 0;
+
+    previous = nullptr;
+    for (ms_sound* s : soundscape->sounds) {
+        if (s == previous) continue; // weighted sounds are added several times in a row
+        previous = s;
+        if (ms_soundscape_lod_sound(soundscape, s)) stats->voices[s->lod_tier]++;
+    }
+}
+
+ms_lod_stats ms_soundscape_get_lod_stats(const ms_soundscape* soundscape) {
+    return soundscape->lod_stats;
+}
+
+#endif /* MS_HAS_LOD */
+
+#endif /* MS_NO_SOUNDSCAPE */
+
+/* --- ms_sound_speaker --- */
+
+#ifndef MS_NO_SPATIALIZATION
+
+void ms_sound_speaker_init(std::string name, ms_sound_speaker* speaker, double x, double y, double z);
+void ms_sound_speaker_uninit(ms_sound_speaker* speaker);
+bool ms_sound_speaker_is_occupied(ms_sound_speaker* speaker);
+void ms_sound_speaker_set_path(ms_sound_speaker* speaker, const ms_path* path);
+
+void ms_sound_speaker_init(std::string name, ms_sound_speaker* speaker, double x, double y, double z) {
+    speaker->name = name;
+    speaker->x    = x;
+    speaker->y    = y;
+    speaker->z    = z;
+}
+
+void ms_sound_speaker_uninit(ms_sound_speaker* speaker) {
+    delete speaker;
+}
+
+bool ms_sound_speaker_is_occupied(ms_sound_speaker* speaker) {
+    return ms_sound_is_playing(speaker->sound);
+}
+
+void ms_sound_speaker_set_path(ms_sound_speaker* speaker, const ms_path* path) {
+    speaker->path = path;
+}
+
+#endif // MS_NO_SPATIALIZATION
+
+/* --- ms_scene --- */
+
+ma_result ms_scene_init(ms_scene* scene, ma_engine* engine, ma_engine_config* config, ma_uint32 maxEmitters) {
+    scene->engine = engine;
+
+    // every emitter can have a command in flight on top of the usual traffic, rounded up to a power of two for masking
+    ma_uint32 capacity = 1;
+    while (capacity < maxEmitters + MS_SCENE_COMMAND_CAPACITY) capacity <<= 1;
+    scene->commands.resize(capacity);
+    scene->command_read  = 0;
+    scene->command_write = 0;
+
+    #ifndef MS_NO_SPATIALIZATION
+        scene->free_emitters.resize(maxEmitters);
+        for (ma_uint32 i = 0; i < maxEmitters; i++) {
+            scene->free_emitters[i] = maxEmitters - 1 - i; // hand out low handles first
+        }
+
+        scene->emitter_count = 0;
+        scene->emitter_slot.assign(maxEmitters, ~(ma_uint32)0);
+        scene->emitter_handle.resize(maxEmitters);
+        scene->emitter_path.resize(maxEmitters);
+        scene->emitter_entity.resize(maxEmitters);
+        scene->emitter_origin.resize(maxEmitters);
+        scene->emitter_voice.resize(maxEmitters);
+        scene->emitter_start.resize(maxEmitters);
+    #endif
+
+    #ifdef MS_HAS_OCCLUSION
+        scene->occlusion = nullptr;
+        scene->emitter_filter.resize(maxEmitters);
+        scene->emitter_cutoff.resize(maxEmitters);
+    #endif
+
+    if (config != nullptr) {
+        config->onProcess        = ms_scene_process;
+        config->pProcessUserData = scene;
+    }
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_scene_init :: initialising with room for " << maxEmitters << " emitter(s)" << std::endl;
+    #endif
+
+    return MA_SUCCESS;
+}
+
+// uninitialise the engine first, the audio thread must not be inside ms_scene_process()
+void ms_scene_uninit(ms_scene* scene) {
+    for (ms_param_batch* batch : scene->free_batches) delete batch;
+    for (auto& sent : scene->sent_batches) delete sent.second;
+    scene->free_batches.clear();
+    scene->sent_batches.clear();
+    #ifdef MS_HAS_OCCLUSION
+        for (auto& retired : scene->retired) {
+            ma_lpf_node_uninit(retired.second, NULL);
+            ms_node_profile_forget(retired.second);
+            delete retired.second;
+        }
+        scene->retired.clear();
+    #endif
+    #ifndef MS_NO_SPATIALIZATION
+        for (ms_deferred_removal& removal : scene->deferred_removals) {
+            if (removal.sound != nullptr) removal.sound->stranded = nullptr;
+            scene->retired_voices.push_back(std::move(removal.retired));
+        }
+        scene->deferred_removals.clear();
+    #endif
+    for (ms_retired_voices& retired : scene->retired_voices) {
+        for (ma_sound* voice : retired.voices) ms_voice_release(voice);
+        ms_arena_release(&retired.arena);
+    }
+    scene->retired_voices.clear();
+    scene->commands.clear();
+    #ifndef MS_NO_SPATIALIZATION
+        scene->free_emitters.clear();
+        scene->emitter_count = 0;
+    #endif
+}
+
+// game thread: queue `command` for the audio thread without collecting first, false if the ring is full
+static bool ms_scene_try_push(ms_scene* scene, const ms_scene_command& command) {
+    ma_uint32 write = scene->command_write.load(std::memory_order_relaxed);
+    if (write - scene->command_read.load(std::memory_order_acquire) >= scene->commands.size()) return false;
+    scene->commands[write & (scene->commands.size() - 1)] = command;
+    scene->command_write.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+// game thread: take back whatever the audio thread has stopped using, and push the removals that didn't fit before
+static void ms_scene_collect(ms_scene* scene) {
+    ma_uint32 read = scene->command_read.load(std::memory_order_acquire);
+
+    #ifndef MS_NO_SPATIALIZATION
+        // in the order they were asked for, so a sound with two waiting is only let go by the last
+        size_t pushed = 0;
+        for (; pushed < scene->deferred_removals.size(); pushed++) {
+            ms_deferred_removal& removal = scene->deferred_removals[pushed];
+            ms_scene_command command = {};
+            command.type    = MS_SCENE_EMITTER_REMOVE;
+            command.emitter = removal.emitter;
+            ma_uint32 index = scene->command_write.load(std::memory_order_relaxed);
+            if (!ms_scene_try_push(scene, command)) break;
+
+            scene->free_emitters.push_back(removal.emitter);
+            removal.retired.command = index;
+            scene->retired_voices.push_back(std::move(removal.retired));
+            if (removal.sound != nullptr) {
+                removal.sound->stranded      = nullptr;
+                removal.sound->reached_by    = scene;
+                removal.sound->reached_until = index;
+            }
+        }
+        if (pushed > 0) {
+            scene->deferred_removals.erase(scene->deferred_removals.begin(), scene->deferred_removals.begin() + pushed);
+            for (ms_deferred_removal& removal : scene->deferred_removals) {
+                if (removal.sound != nullptr) removal.sound->stranded = scene;
+            }
+        }
+    #endif
+
+    for (size_t i = 0; i < scene->sent_batches.size();) {
+        if ((ma_int32)(read - scene->sent_batches[i].first) > 0) {
+            scene->free_batches.push_back(scene->sent_batches[i].second);
+            scene->sent_batches[i] = scene->sent_batches.back();
+            scene->sent_batches.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    #ifdef MS_HAS_OCCLUSION
+        for (size_t i = 0; i < scene->retired.size();) {
+            if ((ma_int32)(read - scene->retired[i].first) > 0) {
+                ma_lpf_node_uninit(scene->retired[i].second, NULL);
+                ms_node_profile_forget(scene->retired[i].second);
+                delete scene->retired[i].second;
+                scene->retired[i] = scene->retired.back();
+                scene->retired.pop_back();
+            } else {
+                i++;
+            }
+        }
+    #endif
+
+    for (size_t i = 0; i < scene->retired_voices.size();) {
+        ms_retired_voices& retired = scene->retired_voices[i];
+        if ((ma_int32)(read - retired.command) > 0) {
+            for (ma_sound* voice : retired.voices) ms_voice_release(voice);
+            ms_arena_release(&retired.arena);
+            retired = std::move(scene->retired_voices.back());
+            scene->retired_voices.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+// game thread: uninitialise `voices` and release `arena`, which it empties, once the audio thread has read past
+// `command`. they should be stopped, they stay in the graph until then
+static void ms_scene_retire(ms_scene* scene, ma_uint32 command, const vector<ma_sound*>& voices, ms_arena* arena) {
+    ms_retired_voices retired;
+    retired.command = command;
+    retired.voices  = voices;
+    if (arena != nullptr) {
+        retired.arena = std::move(*arena);
+        *arena = ms_arena();
+    }
+    scene->retired_voices.push_back(std::move(retired));
+}
+
+// game thread: queue `command` for the audio thread, false if the ring is full
+static bool ms_scene_push(ms_scene* scene, const ms_scene_command& command) {
+    ms_scene_collect(scene);
+    if (ms_scene_try_push(scene, command)) return true;
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_scene_push :: command ring is full, is the engine running?" << std::endl;
+    #endif
+    MS_METRIC_ADD(commands_dropped, 1);
+    return false;
+}
+
+#ifndef MS_NO_SPATIALIZATION
+// game thread: remove `emitter`, which moved `sound`, once the ring has room for it. `sound` is stranded until then
+static void ms_scene_defer_remove(ms_scene* scene, ma_uint32 emitter, ms_sound* sound) {
+    ms_deferred_removal removal;
+    removal.emitter = emitter;
+    removal.sound   = sound;
+    scene->deferred_removals.push_back(std::move(removal));
+    sound->stranded = scene;
+}
+
+// game thread: hold what stranded `sound` lets go of until its last removal is pushed, then retire it with that. an
+// arena only comes with the sound being uninitialised, the removals forget it
+static void ms_scene_defer_retire(ms_scene* scene, ms_sound* sound, const vector<ma_sound*>& voices, ms_arena* arena) {
+    bool last = true;
+    for (size_t i = scene->deferred_removals.size(); i-- > 0;) {
+        ms_deferred_removal& removal = scene->deferred_removals[i];
+        if (removal.sound != sound) continue;
+        if (last) {
+            removal.retired.voices.insert(removal.retired.voices.end(), voices.begin(), voices.end());
+            if (arena != nullptr) {
+                removal.retired.arena = std::move(*arena);
+                *arena = ms_arena();
+            }
+            last = false;
+        }
+        if (arena != nullptr) removal.sound = nullptr;
+    }
+}
+#endif
+
+#ifndef MS_NO_SPATIALIZATION
+
+// audio thread
+static void ms_scene_apply_emitter_command(ms_scene* scene, const ms_scene_command& command) {
+    ma_uint32 h = command.emitter;
+    ma_uint32 i = scene->emitter_slot[h];
+    ma_uint64 now = ma_engine_get_time_in_pcm_frames(scene->engine);
+
+    switch (command.type) {
+        case MS_SCENE_EMITTER_SET:
+            if (i == ~(ma_uint32)0) {
+                i = scene->emitter_count++;
+                scene->emitter_slot[h]   = i;
+                scene->emitter_handle[i] = h;
+                scene->emitter_voice[i]  = nullptr;
+                #ifdef MS_HAS_OCCLUSION
+                    scene->emitter_filter[i] = nullptr;
+                #endif
+            }
+            scene->emitter_path[i]   = command.path;
+            scene->emitter_entity[i] = command.entity;
+            scene->emitter_origin[i] = command.origin;
+            scene->emitter_start[i]  = now;
+            break;
+        case MS_SCENE_EMITTER_BIND:
+            if (i == ~(ma_uint32)0) break;
+            scene->emitter_voice[i] = command.voice;
+            scene->emitter_start[i] = now;
+            if (command.path != nullptr) {
+                scene->emitter_path[i]   = command.path;
+                scene->emitter_entity[i] = nullptr;
+                scene->emitter_origin[i] = command.origin;
+            }
+            break;
+        case MS_SCENE_EMITTER_REMOVE: {
+            if (i == ~(ma_uint32)0) break;
+            // move the last emitter into the hole
+            ma_uint32 last = --scene->emitter_count;
+            scene->emitter_handle[i] = scene->emitter_handle[last];
+            scene->emitter_path[i]   = scene->emitter_path[last];
+            scene->emitter_entity[i] = scene->emitter_entity[last];
+            scene->emitter_origin[i] = scene->emitter_origin[last];
+            scene->emitter_voice[i]  = scene->emitter_voice[last];
+            scene->emitter_start[i]  = scene->emitter_start[last];
+            #ifdef MS_HAS_OCCLUSION
+                scene->emitter_filter[i] = scene->emitter_filter[last];
+                scene->emitter_cutoff[i] = scene->emitter_cutoff[last];
+            #endif
+            scene->emitter_slot[scene->emitter_handle[i]] = i;
+            scene->emitter_slot[h] = ~(ma_uint32)0;
+            break;
+        }
+        #ifdef MS_HAS_OCCLUSION
+        case MS_SCENE_EMITTER_OCCLUDE:
+            if (i == ~(ma_uint32)0) break;
+            scene->emitter_filter[i] = command.filter;
+            scene->emitter_cutoff[i] = -1.0f; // set the cutoff on the next update whatever it is
+            break;
+        #endif
+        default: break;
+    }
+}
+
+// position & orthonormal axes of the engine's first listener
+static void ms_scene_listener_basis(ma_engine* engine, ma_vec3f* position, ma_vec3f* right, ma_vec3f* up, ma_vec3f* forward) {
+    ma_vec3f d = ma_engine_listener_get_direction(engine, 0);
+    ma_vec3f u = ma_engine_listener_get_world_up(engine, 0);
+    float dl = sqrtf(d.x*d.x + d.y*d.y + d.z*d.z);
+    if (dl > 0.0f) d = { d.x / dl, d.y / dl, d.z / dl };
+
+    ma_vec3f r = { d.y*u.z - d.z*u.y, d.z*u.x - d.x*u.z, d.x*u.y - d.y*u.x };
+    float rl = sqrtf(r.x*r.x + r.y*r.y + r.z*r.z);
+    if (rl > 0.0f) r = { r.x / rl, r.y / rl, r.z / rl };
+
+    *position = ma_engine_listener_get_position(engine, 0);
+    *right    = r;
+    *up       = { r.y*d.z - r.z*d.y, r.z*d.x - r.x*d.z, r.x*d.y - r.y*d.x };
+    *forward  = d;
+}
+
+// audio thread: move every playing voice to where its emitter will be halfway through the next block
+static void ms_scene_update_emitters(ms_scene* scene, ma_uint64 frameCount) {
+    ma_uint32 sampleRate = ma_engine_get_sample_rate(scene->engine);
+    ma_uint64 now        = ma_engine_get_time_in_pcm_frames(scene->engine); // the start of the next block
+    double block         = (double)frameCount / sampleRate;
+
+    #ifdef MS_HAS_OCCLUSION
+        // pick up the newest flood & tell the game thread the other copy is free
+        ms_occlusion_grid* grid = scene->occlusion;
+        const float* gain   = nullptr;
+        const float* cutoff = nullptr;
+        ma_vec3f lp, right, up, forward;
+        if (grid != nullptr) {
+            int b = grid->published.load();
+            grid->in_use.store(b);
+            gain   = grid->gain[b].data();
+            cutoff = grid->cutoff[b].data();
+            ms_scene_listener_basis(scene->engine, &lp, &right, &up, &forward);
+        }
+    #endif
+
+    for (ma_uint32 i = 0; i < scene->emitter_count; i++) {
+        ma_sound* voice = scene->emitter_voice[i];
+        if (voice == nullptr || !ma_sound_is_playing(voice)) continue;
+
+        #ifdef MS_HAS_OCCLUSION
+            ma_lpf_node* filter = scene->emitter_filter[i];
+            if (grid != nullptr && filter != nullptr) {
+                ma_vec3f p = ma_sound_get_position(voice);
+                if (ma_sound_get_positioning(voice) == ma_positioning_relative) {
+                    // listener space has -z ahead of the listener
+                    p = { lp.x + right.x*p.x + up.x*p.y - forward.x*p.z,
+                          lp.y + right.y*p.x + up.y*p.y - forward.y*p.z,
+                          lp.z + right.z*p.x + up.z*p.y - forward.z*p.z };
+                }
+                int tile = ms_occlusion_grid_tile_at(grid, p.x, p.z);
+                ma_node_set_output_bus_volume(filter, 0, gain[tile]);
+
+                // only recalculate coefficients once the cutoff has moved enough to be heard
+                float c = cutoff[tile];
+                if (fabsf(c - scene->emitter_cutoff[i]) > scene->emitter_cutoff[i] * 0.05f) {
+                    ma_lpf_config config = ma_lpf_config_init(ma_format_f32, ma_engine_get_channels(scene->engine), sampleRate, c, 2);
+                    ma_lpf_node_reinit(&config, filter);
+                    scene->emitter_cutoff[i] = c;
+                }
+            }
+        #endif
+
+        ma_vec3f p, v;
+        if (scene->emitter_entity[i] != nullptr) {
+            p = ms_entity_get(scene->emitter_entity[i], now + frameCount / 2, sampleRate, &v);
+        } else if (scene->emitter_path[i] != nullptr) {
+            double t   = (double)(now - scene->emitter_start[i]) / sampleRate;
+            ma_vec3f a = ms_path_evaluate(scene->emitter_path[i], t);
+            ma_vec3f b = ms_path_evaluate(scene->emitter_path[i], t + block);
+            ma_vec3f o = scene->emitter_origin[i];
+            p = { o.x + (a.x + b.x) * 0.5f, o.y + (a.y + b.y) * 0.5f, o.z + (a.z + b.z) * 0.5f };
+            v = { (float)((b.x - a.x) / block), (float)((b.y - a.y) / block), (float)((b.z - a.z) / block) };
+        } else {
+            continue;
+        }
+
+        ma_sound_set_position(voice, p.x, p.y, p.z);
+        ma_sound_set_velocity(voice, v.x, v.y, v.z);
+    }
+}
+
+#endif /* MS_NO_SPATIALIZATION */
+
+// audio thread: clamp each parameter over its whole array first, these are plain loops over floats that vectorise,
+// then hand everything to miniaudio in one pass
+static void ms_scene_apply_params(ms_param_batch* batch) {
+    size_t n      = batch->voices.size();
+    float* volume = batch->volume.empty() ? nullptr : batch->volume.data();
+    float* pitch  = batch->pitch.empty()  ? nullptr : batch->pitch.data();
+    float* pan    = batch->pan.empty()    ? nullptr : batch->pan.data();
+
+    if (volume != nullptr) for (size_t i = 0; i < n; i++) volume[i] = fmaxf(volume[i], 0.0f);
+    if (pitch  != nullptr) for (size_t i = 0; i < n; i++) pitch[i]  = fmaxf(pitch[i], 1e-3f);
+    if (pan    != nullptr) for (size_t i = 0; i < n; i++) pan[i]    = fminf(fmaxf(pan[i], -1.0f), 1.0f);
+
+    for (size_t i = 0; i < n; i++) {
+        ma_sound* voice = batch->voices[i];
+        if (volume != nullptr) ma_sound_set_volume(voice, volume[i]);
+        if (pitch  != nullptr) ma_sound_set_pitch(voice, pitch[i]);
+        if (pan    != nullptr) ma_sound_set_pan(voice, pan[i]);
+    }
+}
+
+// hooked into ma_engine_config::onProcess by ms_scene_init(), runs on the audio thread at the end of every block
+void ms_scene_process(void* pUserData, float* pFramesOut, ma_uint64 frameCount) {
+    (void)pFramesOut;
+    (void)frameCount; // only emitters move with it
+    ms_scene* scene = (ms_scene*)pUserData;
+    ma_uint64 traced = ms_trace_begin();
+
+    ma_uint32 read  = scene->command_read.load(std::memory_order_relaxed);
+    ma_uint32 write = scene->command_write.load(std::memory_order_acquire);
+    for (; read != write; read++) {
+        const ms_scene_command& command = scene->commands[read & (scene->commands.size() - 1)];
+        switch (command.type) {
+            #ifndef MS_NO_SPATIALIZATION
+            case MS_SCENE_EMITTER_SET:
+            case MS_SCENE_EMITTER_BIND:
+            case MS_SCENE_EMITTER_REMOVE:
+            case MS_SCENE_EMITTER_OCCLUDE:
+                ms_scene_apply_emitter_command(scene, command);
+                break;
+            #endif
+            #ifdef MS_HAS_OCCLUSION
+            case MS_SCENE_SET_OCCLUSION_GRID:
+                scene->occlusion = command.grid;
+                break;
+            #endif
+            case MS_SCENE_APPLY_PARAMS:
+                ms_scene_apply_params(command.batch);
+                break;
+            default: break;
+        }
+    }
+    scene->command_read.store(read, std::memory_order_release);
+
+    #ifndef MS_NO_SPATIALIZATION
+        ms_scene_update_emitters(scene, frameCount);
+    #endif
+    ms_trace_end("ms_scene_process", traced);
+}
+
+// set the volume, pitch and/or pan of the playing variant of every sound in `sounds`, all at the next block. any
+// of the arrays can be nullptr to leave that parameter alone. sounds that haven't been started are skipped
+ma_result ms_scene_set_params(ms_scene* scene, ms_sound* const* sounds, size_t soundsAmount, const float* volume, const float* pitch, const float* pan) {
+    ms_scene_collect(scene);
+
+    ms_param_batch* batch;
+    if (scene->free_batches.size() > 0) {
+        batch = scene->free_batches.back();
+        scene->free_batches.pop_back();
+    } else {
+        batch = new ms_param_batch;
+    }
+    batch->voices.clear();
+    batch->volume.clear();
+    batch->pitch.clear();
+    batch->pan.clear();
+
+    for (size_t i = 0; i < soundsAmount; i++) {
+        ms_sound* sound = sounds[i];
+        if (sound->active < 0) continue;
+        if (pitch != nullptr && pitch[i] != 1.0f && (sound->stages & MS_SOUND_STAGE_PITCH) == 0) {
+            sound->repitched = true;
+            ms_sound_classify(sound); // gives it the resampler
+        }
+        batch->voices.push_back(sound->sounds[sound->active]);
+        if (volume != nullptr) {
+            sound->active_volume = volume[i];
+            batch->volume.push_back(volume[i]);
+        }
+        if (pitch != nullptr) batch->pitch.push_back(pitch[i]);
+        if (pan != nullptr) {
+            sound->active_pan = pan[i];
+            batch->pan.push_back(pan[i]);
+        }
+    }
+
+    ms_scene_command command = {};
+    command.type  = MS_SCENE_APPLY_PARAMS;
+    command.batch = batch;
+    ma_uint32 index = scene->command_write.load(std::memory_order_relaxed);
+    if (!ms_scene_push(scene, command)) {
+        scene->free_batches.push_back(batch);
+        return MA_BUSY;
+    }
+    scene->sent_batches.push_back({ index, batch });
+    for (size_t i = 0; i < soundsAmount; i++) {
+        if (sounds[i]->active < 0) continue;
+        sounds[i]->reached_by    = scene;
+        sounds[i]->reached_until = index;
+    }
+    return MA_SUCCESS;
+}
+
+#ifndef MS_NO_SPATIALIZATION
+
+// take a free handle & queue `command` with it
+static int ms_scene_add_emitter(ms_scene* scene, ms_scene_command command) {
+    if (scene->free_emitters.size() == 0) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_scene_add_emitter :: out of emitters, raise `maxEmitters`" << std::endl;
+        #endif
+        return -1;
+    }
+
+    command.type    = MS_SCENE_EMITTER_SET;
+    command.emitter = scene->free_emitters.back();
+    if (!ms_scene_push(scene, command)) return -1;
+
+    scene->free_emitters.pop_back();
+    return (int)command.emitter;
+}
+
+int ms_scene_add_emitter(ms_scene* scene, const ms_path* path, ma_vec3f origin) {
+    ms_scene_command command = {};
+    command.path   = path;
+    command.origin = origin;
+    return ms_scene_add_emitter(scene, command);
+}
+
+int ms_scene_add_emitter(ms_scene* scene, ms_entity* entity) {
+    ms_scene_command command = {};
+    command.entity = entity;
+    return ms_scene_add_emitter(scene, command);
+}
+
+ma_result ms_scene_bind_emitter(ms_scene* scene, int emitter, ma_sound* voice, const ms_path* path, ma_vec3f origin) {
+    if (emitter < 0) return MA_INVALID_ARGS;
+
+    ms_scene_command command = {};
+    command.type    = MS_SCENE_EMITTER_BIND;
+    command.emitter = (ma_uint32)emitter;
+    command.voice   = voice;
+    command.path    = path;
+    command.origin  = origin;
+    return ms_scene_push(scene, command) ? MA_SUCCESS : MA_BUSY;
+}
+
+// false if the ring was full, the emitter then keeps moving the voice it was bound to
+bool ms_scene_remove_emitter(ms_scene* scene, int emitter) {
+    if (emitter < 0) return true;
+
+    ms_scene_command command = {};
+    command.type    = MS_SCENE_EMITTER_REMOVE;
+    command.emitter = (ma_uint32)emitter;
+    // the handle only goes back on the free list once the audio thread is guaranteed to see the removal first
+    if (!ms_scene_push(scene, command)) return false;
+    scene->free_emitters.push_back((ma_uint32)emitter);
+    return true;
+}
+
+/* --- ms_path --- */
+
+void ms_path_init_line(ms_path* path, ma_vec3f from, ma_vec3f to, double duration, ms_path_mode mode) {
+    ma_vec3f points[2] = { from, to };
+    ms_path_init_line(path, points, 2, duration, mode);
+}
+
+void ms_path_init_line(ms_path* path, const ma_vec3f* points, size_t pointAmount, double duration, ms_path_mode mode) {
+    path->type     = MS_PATH_LINE;
+    path->mode     = mode;
+    path->points.assign(points, points + pointAmount);
+    path->duration = duration;
+}
+
+void ms_path_init_spline(ms_path* path, const ma_vec3f* points, size_t pointAmount, double duration, ms_path_mode mode) {
+    ms_path_init_line(path, points, pointAmount, duration, mode);
+    path->type = MS_PATH_SPLINE;
+}
+
+ma_vec3f ms_path_evaluate(const ms_path* path, double seconds) {
+    size_t n = path->points.size();
+    if (n == 0) return { 0.0f, 0.0f, 0.0f };
+    if (n == 1 || path->duration <= 0.0) return path->points[n - 1];
+
+    // progress along the whole path, 0.0 to 1.0
+    double u = seconds / path->duration;
+    switch (path->mode) {
+        case MS_PATH_ONCE:      break;
+        case MS_PATH_LOOP:      u -= floor(u); break;
+        case MS_PATH_PING_PONG: u = fmod(u, 2.0); if (u > 1.0) u = 2.0 - u; break;
+    }
+    if (u < 0.0) u = 0.0;
+    if (u > 1.0) u = 1.0;
+
+    double f = u * (n - 1);
+    size_t k = (size_t)f;
+    if (k > n - 2) k = n - 2;
+    float t = (float)(f - k);
+
+    const ma_vec3f& p1 = path->points[k];
+    const ma_vec3f& p2 = path->points[k + 1];
+
+    if (path->type == MS_PATH_LINE) {
+        return { p1.x + (p2.x - p1.x) * t, p1.y + (p2.y - p1.y) * t, p1.z + (p2.z - p1.z) * t };
+    }
+
+    // catmull-rom, the end points are repeated so the spline passes through every point
+    const ma_vec3f& p0 = path->points[k > 0 ? k - 1 : k];
+    const ma_vec3f& p3 = path->points[k + 2 < n ? k + 2 : k + 1];
+    float t2 = t * t;
+    float t3 = t2 * t;
+    #define MS_CATMULL_ROM(c) (0.5f * (2.0f*p1.c + (p2.c - p0.c)*t + (2.0f*p0.c - 5.0f*p1.c + 4.0f*p2.c - p3.c)*t2 + (3.0f*p1.c - p0.c - 3.0f*p2.c + p3.c)*t3))
+    ma_vec3f out = { MS_CATMULL_ROM(x), MS_CATMULL_ROM(y), MS_CATMULL_ROM(z) };
+    #undef MS_CATMULL_ROM
+    return out;
+}
+
+/* --- ms_entity --- */
+
+void ms_entity_init(ms_entity* entity, ma_vec3f position) {
+    entity->sequence = 0;
+    entity->position[0] = position.x;
+    entity->position[1] = position.y;
+    entity->position[2] = position.z;
+    entity->velocity[0] = 0.0f;
+    entity->velocity[1] = 0.0f;
+    entity->velocity[2] = 0.0f;
+    entity->time = 0;
+}
+
+void ms_entity_set(ms_entity* entity, ma_engine* engine, ma_vec3f position, ma_vec3f velocity) {
+    ma_uint32 sequence = entity->sequence.load(std::memory_order_relaxed);
+    entity->sequence.store(sequence + 1, std::memory_order_relaxed); // odd while writing
+    std::atomic_thread_fence(std::memory_order_release);
+    entity->position[0].store(position.x, std::memory_order_relaxed);
+    entity->position[1].store(position.y, std::memory_order_relaxed);
+    entity->position[2].store(position.z, std::memory_order_relaxed);
+    entity->velocity[0].store(velocity.x, std::memory_order_relaxed);
+    entity->velocity[1].store(velocity.y, std::memory_order_relaxed);
+    entity->velocity[2].store(velocity.z, std::memory_order_relaxed);
+    entity->time.store(ma_engine_get_time_in_pcm_frames(engine), std::memory_order_relaxed);
+    entity->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// where `entity` is at engine time `time`, carried along its velocity from where it was last set
+ma_vec3f ms_entity_get(const ms_entity* entity, ma_uint64 time, ma_uint32 sampleRate, ma_vec3f* velocity) {
+    float p[3], v[3];
+    ma_uint64 stamp;
+
+    // the audio thread can't wait on a writer, so give up after a few tries & use what was read
+    for (int attempt = 0; attempt < 4; attempt++) {
+        ma_uint32 sequence = entity->sequence.load(std::memory_order_acquire);
+        for (int c = 0; c < 3; c++) {
+            p[c] = entity->position[c].load(std::memory_order_relaxed);
+            v[c] = entity->velocity[c].load(std::memory_order_relaxed);
+        }
+        stamp = entity->time.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((sequence & 1) == 0 && entity->sequence.load(std::memory_order_relaxed) == sequence) break;
+    }
+
+    float dt = (time > stamp) ? (float)(time - stamp) / sampleRate : 0.0f;
+    if (dt > MS_ENTITY_MAX_EXTRAPOLATION) dt = MS_ENTITY_MAX_EXTRAPOLATION;
+
+    if (velocity != nullptr) *velocity = { v[0], v[1], v[2] };
+    return { p[0] + v[0] * dt, p[1] + v[1] * dt, p[2] + v[2] * dt };
+}
+
+#endif /* MS_NO_SPATIALIZATION */
+
+/* --- ms_occlusion_grid --- */
+
+#ifdef MS_HAS_OCCLUSION
+
+ma_result ms_scene_set_occlusion_grid(ms_scene* scene, ms_occlusion_grid* grid) {
+    ms_scene_command command = {};
+    command.type = MS_SCENE_SET_OCCLUSION_GRID;
+    command.grid = grid;
+    return ms_scene_push(scene, command) ? MA_SUCCESS : MA_BUSY;
+}
+
+ma_result ms_sound_set_occlusion(ms_sound* sound, ms_scene* scene, bool occluded) {
+    if (occluded == (sound->occlusion != nullptr)) return MA_SUCCESS;
+    if (sound->sounds.size() == 0) return MA_INVALID_OPERATION;
+
+    ma_engine* engine = ma_sound_get_engine(sound->sounds[0]);
+
+    // a voice's tier decides where its output goes, start again from the near tier & let the next update re-tier it
+    #ifdef MS_HAS_LOD
+        ms_sound_reset_lod(sound);
+    #endif
+
+    if (occluded) {
+        // the emitter is static until it is given a path or entity
+        if (sound->scene != scene) {
+            ms_scene_command command = {};
+            ma_result result = ms_sound_set_emitter(sound, scene, command);
+            if (result != MA_SUCCESS) return result;
+        }
+
+        ma_lpf_node* filter = new ma_lpf_node;
+        ma_lpf_node_config config = ma_lpf_node_config_init(ma_engine_get_channels(engine), ma_engine_get_sample_rate(engine), MS_OCCLUSION_MAX_CUTOFF, 2);
+        if (ma_lpf_node_init(ma_engine_get_node_graph(engine), &config, NULL, filter) != MA_SUCCESS) {
+            delete filter;
+            return MA_ERROR;
+        }
+        ms_node_profile_watch(filter, sound->name + " occlusion", sound, nullptr);
+        ma_uint32 bus;
+        ma_node* output = ms_sound_output(sound, engine, &bus);
+        ma_node_attach_output_bus(filter, 0, output, bus);
+        for (ma_sound* s : sound->sounds) {
+            ma_node_attach_output_bus(s, 0, filter, 0);
+        }
+        sound->occlusion = filter;
+
+        ms_scene_command command = {};
+        command.type    = MS_SCENE_EMITTER_OCCLUDE;
+        command.emitter = (ma_uint32)sound->emitter;
+        command.filter  = filter;
+        return ms_scene_push(scene, command) ? MA_SUCCESS : MA_BUSY;
+    }
+
+    ms_scene_command command = {};
+    command.type    = MS_SCENE_EMITTER_OCCLUDE;
+    command.emitter = (ma_uint32)sound->emitter;
+    ma_uint32 index = scene->command_write.load(std::memory_order_relaxed);
+    if (!ms_scene_push(scene, command)) return MA_BUSY;
+
+    ma_uint32 bus;
+    ma_node* output = ms_sound_output(sound, engine, &bus);
+    for (ma_sound* s : sound->sounds) {
+        ma_node_attach_output_bus(s, 0, output, bus);
+    }
+    scene->retired.push_back({ index, sound->occlusion });
+    sound->occlusion = nullptr;
+    return MA_SUCCESS;
+}
+
+void ms_occlusion_grid_init(ms_occlusion_grid* grid, ma_uint32 width, ma_uint32 height, float spacing, float origin_x, float origin_z) {
+    grid->width    = width;
+    grid->height   = height;
+    grid->spacing  = spacing;
+    grid->origin_x = origin_x;
+    grid->origin_z = origin_z;
+    grid->transmission.assign(width * height, 1.0f);
+
+    // nothing is occluded until the first update
+    for (int b = 0; b < 2; b++) {
+        grid->gain[b].assign(width * height, 1.0f);
+        grid->cutoff[b].assign(width * height, (float)MS_OCCLUSION_MAX_CUTOFF);
+    }
+    grid->published = 0;
+    grid->in_use    = 0;
+
+    grid->listener = -1;
+    grid->dirty    = true;
+    grid->raised.clear();
+    grid->heap.reserve(width * height * 4);
+}
+
+void ms_occlusion_grid_set_tile(ms_occlusion_grid* grid, ma_uint32 x, ma_uint32 y, float transmission) {
+    if (x >= grid->width || y >= grid->height) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_occlusion_grid_set_tile :: " << x << ", " << y << " is outside of the grid" << std::endl;
+        #endif
+        return;
+    }
+
+    if (transmission < 0.0f) transmission = 0.0f;
+    if (transmission > 1.0f) transmission = 1.0f;
+
+    ma_uint32 i = y * grid->width + x;
+    // a more open tile can only improve paths through it, anything else has to be flooded from scratch
+    if (transmission > grid->transmission[i])      grid->raised.push_back(i);
+    else if (transmission < grid->transmission[i]) grid->dirty = true;
+    grid->transmission[i] = transmission;
+}
+
+int ms_occlusion_grid_tile_at(const ms_occlusion_grid* grid, float x, float z) {
+    int tx = (int)floorf((x - grid->origin_x) / grid->spacing + 0.5f);
+    int ty = (int)floorf((z - grid->origin_z) / grid->spacing + 0.5f);
+    if (tx < 0) tx = 0;
+    if (ty < 0) ty = 0;
+    if (tx >= (int)grid->width)  tx = grid->width - 1;
+    if (ty >= (int)grid->height) ty = grid->height - 1;
+    return ty * grid->width + tx;
+}
+
+// spread whatever is on the heap through `gain`, loudest path first. a tile is as loud as its loudest neighbour
+// times how much of that it lets through, so this is dijkstra with multiplication in place of addition
+static void ms_occlusion_grid_flood(ms_occlusion_grid* grid, float* gain) {
+    auto& heap = grid->heap;
+    while (heap.size() > 0) {
+        std::pop_heap(heap.begin(), heap.end());
+        float g     = heap.back().first;
+        ma_uint32 i = heap.back().second;
+        heap.pop_back();
+        if (g < gain[i]) continue; // already reached by a louder path
+
+        ma_uint32 x = i % grid->width;
+        ma_uint32 y = i / grid->width;
+        ma_uint32 neighbours[4];
+        int n = 0;
+        if (x > 0)                neighbours[n++] = i - 1;
+        if (x + 1 < grid->width)  neighbours[n++] = i + 1;
+        if (y > 0)                neighbours[n++] = i - grid->width;
+        if (y + 1 < grid->height) neighbours[n++] = i + grid->width;
+
+        for (int k = 0; k < n; k++) {
+            ma_uint32 j = neighbours[k];
+            float through = g * grid->transmission[j] * (float)MS_OCCLUSION_TILE_LOSS;
+            if (through > gain[j] + 1e-6f) {
+                gain[j] = through;
+                heap.push_back({ through, j });
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+}
+
+// game thread, call once per frame. returns true if a new flood was published
+bool ms_occlusion_grid_update(ms_occlusion_grid* grid, ma_engine* engine) {
+    ma_vec3f lp  = ma_engine_listener_get_position(engine, 0);
+    int listener = ms_occlusion_grid_tile_at(grid, lp.x, lp.z);
+    if (listener != grid->listener) grid->dirty = true;
+    if (!grid->dirty && grid->raised.size() == 0) return false;
+
+    // the audio thread is still reading the copy we'd write into, try again next frame
+    int front = grid->published.load();
+    if (grid->in_use.load() != front) return false;
+    int back = 1 - front;
+
+    vector<float>& gain = grid->gain[back];
+    grid->heap.clear();
+    if (grid->dirty) {
+        std::fill(gain.begin(), gain.end(), 0.0f);
+        gain[listener] = 1.0f;
+        grid->heap.push_back({ 1.0f, (ma_uint32)listener });
+    } else {
+        // carry on from the last flood, only tiles that opened up (and what is behind them) can get louder
+        gain = grid->gain[front];
+        for (ma_uint32 i : grid->raised) {
+            ma_uint32 x = i % grid->width;
+            ma_uint32 y = i / grid->width;
+            float best = 0.0f;
+            if (x > 0)                best = fmaxf(best, gain[i - 1]);
+            if (x + 1 < grid->width)  best = fmaxf(best, gain[i + 1]);
+            if (y > 0)                best = fmaxf(best, gain[i - grid->width]);
+            if (y + 1 < grid->height) best = fmaxf(best, gain[i + grid->width]);
+            float g = ((int)i == listener) ? 1.0f : best * grid->transmission[i] * (float)MS_OCCLUSION_TILE_LOSS;
+            if (g > gain[i]) {
+                gain[i] = g;
+                grid->heap.push_back({ g, i });
+                std::push_heap(grid->heap.begin(), grid->heap.end());
+            }
+        }
+    }
+    ms_occlusion_grid_flood(grid, gain.data());
+
+    // the quieter the path, the darker it sounds. interpolated in octaves so it sweeps evenly
+    vector<float>& cutoff = grid->cutoff[back];
+    float ratio = (float)(MS_OCCLUSION_MAX_CUTOFF / MS_OCCLUSION_MIN_CUTOFF);
+    for (size_t i = 0; i < gain.size(); i++) {
+        cutoff[i] = (float)MS_OCCLUSION_MIN_CUTOFF * powf(ratio, gain[i]);
+    }
+
+    grid->listener = listener;
+    grid->dirty    = false;
+    grid->raised.clear();
+    grid->published.store(back);
+    return true;
+}
+
+#endif /* MS_HAS_OCCLUSION */
+
+/* --- ms_ambisonic_bus --- */
+
+#ifdef MS_HAS_AMBISONICS
+
+// real spherical harmonics up to `order` in ACN order & SN3D normalisation, for a unit direction with x ahead, y left & z up
+static void ms_ambisonic_harmonics(float x, float y, float z, ma_uint32 order, float* out) {
+    out[0] = 1.0f;
+    if (order < 1) return;
+    out[1] = y;
+    out[2] = z;
+    out[3] = x;
+    if (order < 2) return;
+    const float s3 = 1.7320508f; // sqrt(3)
+    out[4] = s3 * x * y;
+    out[5] = s3 * y * z;
+    out[6] = 0.5f * (3.0f*z*z - 1.0f);
+    out[7] = s3 * x * z;
+    out[8] = 0.5f * s3 * (x*x - y*y);
+    if (order < 3) return;
+    const float s58 = 0.7905694f; // sqrt(5/8)
+    const float s38 = 0.6123724f; // sqrt(3/8)
+    const float s15 = 3.8729833f; // sqrt(15)
+    out[9]  = s58 * y * (3.0f*x*x - y*y);
+    out[10] = s15 * x * y * z;
+    out[11] = s38 * y * (5.0f*z*z - 1.0f);
+    out[12] = 0.5f * z * (5.0f*z*z - 3.0f);
+    out[13] = s38 * x * (5.0f*z*z - 1.0f);
+    out[14] = 0.5f * s15 * z * (x*x - y*y);
+    out[15] = s58 * x * (x*x - 3.0f*y*y);
+}
+
+// sampling decoder for a horizontal ring of speakers at `azimuths` (radians, anticlockwise from ahead). only the
+// sectoral harmonics change with azimuth, they are weighted for max-rE & the result scaled to keep energy at 1.0f
+static void ms_ambisonic_bus_ring(ms_ambisonic_bus* bus, const float* azimuths, ma_uint32 speakers) {
+    // a ring of n speakers can't tell apart more than (n - 1) / 2 orders, anything above that only smears the image
+    ma_uint32 order = (speakers - 1) / 2;
+    if (order < 1)          order = 1;
+    if (order > bus->order) order = bus->order;
+
+    float ahead[16];
+    ms_ambisonic_harmonics(1.0f, 0.0f, 0.0f, bus->order, ahead);
+
+    bus->speakers = speakers;
+    for (ma_uint32 n = 0; n < speakers; n++) {
+        float h[16];
+        ms_ambisonic_harmonics(cosf(azimuths[n]), sinf(azimuths[n]), 0.0f, bus->order, h);
+        bus->decode[n][0] = 1.0f / speakers;
+        for (ma_uint32 l = 1; l <= order; l++) {
+            // a sectoral harmonic is c * cos(l * azimuth) on the horizon, c being its value straight ahead
+            float weight = cosf(l * MS_PI / (2.0f * order + 2.0f));
+            float c = ahead[l*l + 2*l];
+            bus->decode[n][l*l]       = 2.0f * weight * h[l*l]       / (c * c * speakers);
+            bus->decode[n][l*l + 2*l] = 2.0f * weight * h[l*l + 2*l] / (c * c * speakers);
+        }
+    }
+
+    float h[16];
+    float energy = 0.0f;
+    ms_ambisonic_harmonics(cosf(azimuths[0]), sinf(azimuths[0]), 0.0f, bus->order, h);
+    for (ma_uint32 n = 0; n < speakers; n++) {
+        float g = 0.0f;
+        for (ma_uint32 k = 0; k < bus->channels; k++) g += bus->decode[n][k] * h[k];
+        energy += g * g;
+    }
+    float scale = (energy > 0.0f) ? 1.0f / sqrtf(energy) : 1.0f;
+    for (ma_uint32 n = 0; n < speakers; n++) {
+        for (ma_uint32 k = 0; k < bus->channels; k++) bus->decode[n][k] *= scale;
+    }
+}
+
+// each virtual speaker reaches the far ear later (woodworth's interaural time difference), quieter & low-passed
+static void ms_ambisonic_bus_binaural(ms_ambisonic_bus* bus, ma_uint32 sampleRate) {
+    const float headRadius   = 0.0875f;
+    const float speedOfSound = 343.0f;
+    for (ma_uint32 n = 0; n < bus->speakers; n++) {
+        float side    = sinf(2.0f * MS_PI * n / bus->speakers);
+        float lateral = asinf(fabsf(side));
+        ma_uint32 delay = (ma_uint32)(headRadius / speedOfSound * (lateral + fabsf(side)) * sampleRate + 0.5f);
+        float cutoff    = 20000.0f * powf(1500.0f / 20000.0f, fabsf(side));
+
+        bus->near_left[n]          = side >= 0.0f;
+        bus->delay[n]              = (delay > 63) ? 63 : delay;
+        bus->shadow_gain[n]        = 1.0f - 0.5f * fabsf(side);
+        bus->shadow_coefficient[n] = (fabsf(side) < 1e-3f) ? 0.0f : expf(-2.0f * MS_PI * cutoff / sampleRate);
+        bus->shadow_state[n]       = 0.0f;
+    }
+    memset(bus->history, 0, sizeof(bus->history));
+    bus->history_position = 0;
+}
+
+// turn the forward facing decoder to the listener's yaw. rotating about the vertical only mixes each pair of
+// harmonics with the same order & opposite m, so it's cheap enough to redo every block
+static void ms_ambisonic_bus_rotate(ms_ambisonic_bus* bus) {
+    ma_vec3f d = ma_engine_listener_get_direction(bus->engine, 0);
+    float yaw  = atan2f(-d.x, -d.z); // turning left is positive, like azimuths
+    float c[4], s[4];
+    for (ma_uint32 m = 1; m <= bus->order; m++) {
+        c[m] = cosf(m * yaw);
+        s[m] = sinf(m * yaw);
+    }
+
+    for (ma_uint32 n = 0; n < bus->speakers; n++) {
+        const float* in = bus->decode[n];
+        float* out      = bus->rotated[n];
+        out[0] = in[0];
+        for (ma_uint32 l = 1; l <= bus->order; l++) {
+            ma_uint32 centre = l*l + l;
+            out[centre] = in[centre];
+            for (ma_uint32 m = 1; m <= l; m++) {
+                float cosine = in[centre + m];
+                float sine   = in[centre - m];
+                out[centre + m] = cosine * c[m] - sine * s[m];
+                out[centre - m] = cosine * s[m] + sine * c[m];
+            }
+        }
+    }
+}
+
+static void ms_ambisonic_bus_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut) {
+    (void)pFrameCountIn;
+    ms_ambisonic_bus* bus = (ms_ambisonic_bus*)pNode;
+    const float* in       = ppFramesIn[0];
+    float* out            = ppFramesOut[0];
+    ma_uint32 frameCount  = *pFrameCountOut;
+    ma_uint32 channels    = bus->channels;
+    ma_uint32 outputs     = bus->outputs;
+    ma_uint32 speakers    = bus->speakers;
+
+    ms_ambisonic_bus_rotate(bus);
+
+    if (bus->decoder != MS_AMBISONIC_BINAURAL) {
+        for (ma_uint32 f = 0; f < frameCount; f++) {
+            const float* frame = in + f * channels;
+            for (ma_uint32 n = 0; n < speakers; n++) {
+                float sum = 0.0f;
+                for (ma_uint32 k = 0; k < channels; k++) sum += bus->rotated[n][k] * frame[k];
+                out[f * outputs + n] = sum;
+            }
+            for (ma_uint32 n = speakers; n < outputs; n++) out[f * outputs + n] = 0.0f;
+        }
+        return;
+    }
+
+    // decode to the virtual speakers a chunk at a time, then hear each of them with both ears
+    const ma_uint32 chunkCapacity = sizeof(bus->scratch) / sizeof(bus->scratch[0]) / MS_AMBISONIC_MAX_SPEAKERS;
+    for (ma_uint32 start = 0; start < frameCount; start += chunkCapacity) {
+        ma_uint32 chunk = frameCount - start;
+        if (chunk > chunkCapacity) chunk = chunkCapacity;
+
+        for (ma_uint32 f = 0; f < chunk; f++) {
+            const float* frame = in + (start + f) * channels;
+            for (ma_uint32 n = 0; n < speakers; n++) {
+                float sum = 0.0f;
+                for (ma_uint32 k = 0; k < channels; k++) sum += bus->rotated[n][k] * frame[k];
+                bus->scratch[f * speakers + n] = sum;
+            }
+        }
+
+        for (ma_uint32 f = 0; f < chunk; f++) {
+            ma_uint32 w = bus->history_position;
+            float ears[2] = { 0.0f, 0.0f };
+            for (ma_uint32 n = 0; n < speakers; n++) {
+                float x = bus->scratch[f * speakers + n];
+                bus->history[n][w] = x;
+                float far = bus->history[n][(w - bus->delay[n]) & 63] * bus->shadow_gain[n];
+                bus->shadow_state[n] = far + (bus->shadow_state[n] - far) * bus->shadow_coefficient[n];
+                ears[bus->near_left[n] ? 0 : 1] += x;
+                ears[bus->near_left[n] ? 1 : 0] += bus->shadow_state[n];
+            }
+            bus->history_position = (w + 1) & 63;
+
+            float* frame = out + (start + f) * outputs;
+            frame[0] = ears[0];
+            frame[1] = ears[1];
+            for (ma_uint32 n = 2; n < outputs; n++) frame[n] = 0.0f;
+        }
+    }
+}
+
+static ma_node_vtable ms_ambisonic_bus_vtable = { ms_ambisonic_bus_process, NULL, 1, 1, 0 };
+
+// `speakerAzimuths` is only used by MS_AMBISONIC_SPEAKERS, one per engine channel in degrees anticlockwise from ahead
+ma_result ms_ambisonic_bus_init(ms_ambisonic_bus* bus, ma_engine* engine, ma_uint32 order, ms_ambisonic_decoder decoder, const float* speakerAzimuths) {
+    ma_uint32 outputs = ma_engine_get_channels(engine);
+
+    if (order < 1 || order > 3) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_ambisonic_bus_init :: `order` must be 1, 2 or 3" << std::endl;
+        #endif
+        return MA_INVALID_ARGS;
+    }
+
+    if (decoder == MS_AMBISONIC_SPEAKERS ? (speakerAzimuths == nullptr || outputs > MS_AMBISONIC_MAX_SPEAKERS) : outputs < 2) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_ambisonic_bus_init :: the engine's " << outputs << " channel(s) can't be decoded to" << std::endl;
+        #endif
+        return MA_INVALID_ARGS;
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    bus->engine   = engine;
+    bus->order    = order;
+    bus->channels = (order + 1) * (order + 1);
+    bus->outputs  = outputs;
+    bus->decoder  = decoder;
+
+    switch (decoder) {
+        case MS_AMBISONIC_STEREO:
+            bus->speakers = 2;
+            bus->decode[0][0] = 0.5f; bus->decode[0][1] =  0.5f;
+            bus->decode[1][0] = 0.5f; bus->decode[1][1] = -0.5f;
+            break;
+        case MS_AMBISONIC_BINAURAL: {
+            float azimuths[8];
+            for (int n = 0; n < 8; n++) azimuths[n] = 2.0f * MS_PI * n / 8;
+            ms_ambisonic_bus_ring(bus, azimuths, 8);
+            ms_ambisonic_bus_binaural(bus, ma_engine_get_sample_rate(engine));
+            break;
+        }
+        case MS_AMBISONIC_SPEAKERS: {
+            float azimuths[MS_AMBISONIC_MAX_SPEAKERS];
+            for (ma_uint32 n = 0; n < outputs; n++) azimuths[n] = speakerAzimuths[n] * MS_PI / 180.0f;
+            ms_ambisonic_bus_ring(bus, azimuths, outputs);
+            break;
+        }
+    }
+
+    ma_node_config config      = ma_node_config_init();
+    config.vtable              = &ms_ambisonic_bus_vtable;
+    config.pInputChannels      = &bus->channels;
+    config.pOutputChannels     = &bus->outputs;
+    ma_result result = ma_node_init(ma_engine_get_node_graph(engine), &config, NULL, &bus->base);
+    if (result != MA_SUCCESS) return result;
+    ms_node_profile_watch_engine(engine);
+    ms_node_profile_watch(&bus->base, "ambisonic bus", nullptr, nullptr);
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_ambisonic_bus_init :: order " << order << " bus decoding to " << bus->speakers << " speaker(s)" << std::endl;
+    #endif
+
+    return ma_node_attach_output_bus(&bus->base, 0, ma_engine_get_endpoint(engine), 0);
+}
+
+// voices plugged into `bus` are detached from it
+void ms_ambisonic_bus_uninit(ms_ambisonic_bus* bus) {
+    while (bus->encoders != nullptr) {
+        ms_ambisonic_encoder* encoder = bus->encoders;
+        bus->encoders = encoder->next;
+        ma_node_uninit(&encoder->base, NULL);
+        ms_node_profile_forget(&encoder->base);
+        delete encoder;
+    }
+    ma_node_uninit(&bus->base, NULL);
+    ms_node_profile_forget(&bus->base);
+}
+
+// downmix to mono & add it to `CHANNELS` harmonics, ramping from `from` to `to` across the block so moving voices
+// don't step. the channel count is fixed at compile time & the buffers don't overlap, so the inner loop vectorises
+template <ma_uint32 CHANNELS>
+static void ms_ambisonic_encode(const float* __restrict in, ma_uint32 inputs, float* __restrict out, ma_uint32 frameCount, const float* from, const float* to) {
+    float gain[CHANNELS], step[CHANNELS];
+    for (ma_uint32 k = 0; k < CHANNELS; k++) {
+        gain[k] = from[k];
+        step[k] = (to[k] - from[k]) / frameCount;
+    }
+
+    float downmix = 1.0f / inputs;
+    for (ma_uint32 f = 0; f < frameCount; f++) {
+        const float* frameIn = in + (size_t)f * inputs;
+        float* frameOut      = out + (size_t)f * CHANNELS;
+
+        float mono = 0.0f;
+        for (ma_uint32 c = 0; c < inputs; c++) mono += frameIn[c];
+        mono *= downmix;
+
+        for (ma_uint32 k = 0; k < CHANNELS; k++) {
+            frameOut[k] += mono * gain[k];
+            gain[k]     += step[k];
+        }
+    }
+}
+
+// the harmonics `voice` is heard through, in the world's axes - the bus turns them to face the listener
+static void ms_ambisonic_voice_gains(const ms_ambisonic_bus* bus, const ma_sound* voice, const ma_vec3f* basis, float* gains) {
+    ma_vec3f p = ma_sound_get_position(voice);
+    ma_vec3f v;
+    if (ma_sound_get_positioning(voice) == ma_positioning_relative) {
+        const ma_vec3f& right   = basis[1];
+        const ma_vec3f& up      = basis[2];
+        const ma_vec3f& forward = basis[3];
+        v = { right.x*p.x + up.x*p.y - forward.x*p.z,
+              right.y*p.x + up.y*p.y - forward.y*p.z,
+              right.z*p.x + up.z*p.y - forward.z*p.z };
+    } else {
+        v = { p.x - basis[0].x, p.y - basis[0].y, p.z - basis[0].z };
+    }
+
+    float distance = sqrtf(v.x*v.x + v.y*v.y + v.z*v.z);
+    if (distance > 0.0f) {
+        ms_ambisonic_harmonics(-v.z / distance, -v.x / distance, v.y / distance, bus->order, gains);
+    } else {
+        memset(gains, 0, sizeof(float) * bus->channels);
+        gains[0] = 1.0f; // on top of the listener, heard from everywhere
+    }
+
+    float gain = ms_voice_attenuation(voice, distance);
+    for (ma_uint32 k = 0; k < bus->channels; k++) gains[k] *= gain;
+}
+
+static void ms_ambisonic_encoder_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut) {
+    (void)pFrameCountIn;
+    ms_ambisonic_encoder* encoder = (ms_ambisonic_encoder*)pNode;
+    const ms_ambisonic_bus* bus   = encoder->bus;
+    float* out           = ppFramesOut[0];
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 channels   = bus->channels;
+
+    memset(out, 0, sizeof(float) * frameCount * channels);
+
+    ma_vec3f basis[4];
+    ms_scene_listener_basis(bus->engine, &basis[0], &basis[1], &basis[2], &basis[3]);
+
+    for (ma_uint32 slot = 0; slot < MS_AMBISONIC_ENCODER_VOICES; slot++) {
+        ma_sound* voice = encoder->voices[slot].load(std::memory_order_acquire);
+        if (voice == nullptr || !ma_sound_is_playing(voice)) {
+            encoder->previous[slot] = nullptr;
+            continue;
+        }
+
+        float target[16];
+        ms_ambisonic_voice_gains(bus, voice, basis, target);
+        float* gains = encoder->gains[slot];
+        if (voice != encoder->previous[slot]) {
+            memcpy(gains, target, sizeof(float) * channels);
+            encoder->previous[slot] = voice;
+        }
+
+        switch (channels) {
+            case 4:  ms_ambisonic_encode<4>(ppFramesIn[slot], encoder->inputs, out, frameCount, gains, target);  break;
+            case 9:  ms_ambisonic_encode<9>(ppFramesIn[slot], encoder->inputs, out, frameCount, gains, target);  break;
+            default: ms_ambisonic_encode<16>(ppFramesIn[slot], encoder->inputs, out, frameCount, gains, target); break;
+        }
+        memcpy(gains, target, sizeof(float) * channels);
+    }
+}
+
+static ma_node_vtable ms_ambisonic_encoder_vtable = { ms_ambisonic_encoder_process, NULL, MA_NODE_BUS_COUNT_UNKNOWN, 1, 0 };
+
+static ma_result ms_ambisonic_encoder_init(ms_ambisonic_encoder* encoder, ms_ambisonic_bus* bus) {
+    encoder->bus        = bus;
+    encoder->next       = nullptr;
+    encoder->inputs     = ma_engine_get_channels(bus->engine);
+    encoder->free_count = MS_AMBISONIC_ENCODER_VOICES;
+    for (ma_uint32 i = 0; i < MS_AMBISONIC_ENCODER_VOICES; i++) {
+        encoder->free_slots[i] = MS_AMBISONIC_ENCODER_VOICES - 1 - i; // hand out low slots first
+        encoder->voices[i].store(nullptr);
+        encoder->previous[i] = nullptr;
+    }
+
+    ma_uint32 inputs[MS_AMBISONIC_ENCODER_VOICES];
+    for (ma_uint32 i = 0; i < MS_AMBISONIC_ENCODER_VOICES; i++) inputs[i] = encoder->inputs;
+
+    ma_node_config config      = ma_node_config_init();
+    config.vtable              = &ms_ambisonic_encoder_vtable;
+    config.inputBusCount       = MS_AMBISONIC_ENCODER_VOICES;
+    config.pInputChannels      = inputs;
+    config.pOutputChannels     = &bus->channels;
+    ma_result result = ma_node_init(ma_engine_get_node_graph(bus->engine), &config, NULL, &encoder->base);
+    if (result != MA_SUCCESS) return result;
+    ms_node_profile_watch(&encoder->base, "ambisonic encoder", nullptr, nullptr);
+
+    return ma_node_attach_output_bus(&encoder->base, 0, &bus->base, 0);
+}
+
+// claim a slot in one of `bus`'s encoders & plug `voice` into it. `voice` should have its spatialization disabled,
+// the encoder pans & attenuates it instead
+ma_result ms_ambisonic_bus_add_voice(ms_ambisonic_bus* bus, ma_sound* voice, ms_ambisonic_voice* handle) {
+    ms_ambisonic_encoder* encoder = bus->encoders;
+    while (encoder != nullptr && encoder->free_count == 0) encoder = encoder->next;
+
+    if (encoder == nullptr) {
+        encoder = new ms_ambisonic_encoder;
+        ma_result result = ms_ambisonic_encoder_init(encoder, bus);
+        if (result != MA_SUCCESS) {
+            delete encoder;
+            return result;
+        }
+        encoder->next = bus->encoders;
+        bus->encoders = encoder;
+    }
+
+    handle->encoder = encoder;
+    handle->slot    = encoder->free_slots[--encoder->free_count];
+    ms_ambisonic_voice_set(handle, voice);
+    if (voice != nullptr) ma_node_attach_output_bus(voice, 0, encoder, handle->slot);
+    return MA_SUCCESS;
+}
+
+// give the slot back. anything still attached to it has to be detached first
+void ms_ambisonic_bus_remove_voice(ms_ambisonic_bus* bus, ms_ambisonic_voice* handle) {
+    (void)bus;
+    if (handle->encoder == nullptr) return;
+    ms_ambisonic_voice_set(handle, nullptr);
+    handle->encoder->free_slots[handle->encoder->free_count++] = handle->slot;
+    handle->encoder = nullptr;
+}
+
+// change which voice the slot is positioned by, e.g. when a different variant of a sound starts
+void ms_ambisonic_voice_set(const ms_ambisonic_voice* handle, ma_sound* voice) {
+    handle->encoder->voices[handle->slot].store(voice, std::memory_order_release);
+}
+
+// encode every variant of `sound` into `bus` in place of miniaudio's spatializer, or nullptr to go back to it
+ma_result ms_sound_set_ambisonic(ms_sound* sound, ms_ambisonic_bus* bus) {
+    if (bus == nullptr && sound->ambisonic == nullptr) return MA_SUCCESS;
+    if (sound->sounds.size() == 0) return MA_INVALID_OPERATION;
+
+    ma_engine* engine = ma_sound_get_engine(sound->sounds[0]);
+
+    #ifdef MS_HAS_LOD
+        ms_sound_reset_lod(sound);
+    #endif
+
+    if (sound->ambisonic != nullptr) {
+        ms_ambisonic_voice* handle = sound->ambisonic;
+        sound->ambisonic = nullptr;
+        for (ma_sound* s : sound->sounds) {
+            ma_sound_set_spatialization_enabled(s, (sound->stages & MS_SOUND_STAGE_SPATIALIZER) != 0);
+            ms_sound_route(sound, s, ma_engine_get_endpoint(engine));
+        }
+        ms_ambisonic_bus_remove_voice(handle->encoder->bus, handle);
+        delete handle;
+    }
+
+    if (bus == nullptr) return MA_SUCCESS;
+
+    if (!sound->spatialized) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_ambisonic :: " << sound->name << " isn't spatialized" << std::endl;
+        #endif
+        return MA_INVALID_OPERATION;
+    }
+
+    #ifdef MS_HAS_SPEAKER_ARRAY
+        if (sound->speaker_array != nullptr) return MA_INVALID_OPERATION; // one or the other
+    #endif
+
+    ms_ambisonic_voice* handle = new ms_ambisonic_voice;
+    ma_result result = ms_ambisonic_bus_add_voice(bus, sound->sounds[sound->active >= 0 ? sound->active : 0], handle);
+    if (result != MA_SUCCESS) {
+        delete handle;
+        return result;
+    }
+
+    sound->ambisonic = handle;
+    for (ma_sound* s : sound->sounds) {
+        ma_sound_set_spatialization_enabled(s, MA_FALSE);
+        ms_sound_route(sound, s, handle->encoder, handle->slot);
+    }
+    return MA_SUCCESS;
+}
+
+#endif /* MS_HAS_AMBISONICS */
+
+/* --- ms_speaker_array --- */
+
+#ifdef MS_HAS_SPEAKER_ARRAY
+
+// vector base amplitude panning between the neighbouring speakers around `azimuth`, normalised to constant power
+static ms_vbap_gains ms_speaker_array_vbap(const ms_speaker_array* array, float azimuth) {
+    ms_vbap_gains g;
+    ma_uint32 n = array->speakers;
+    if (n == 1) {
+        g.channel[0] = g.channel[1] = array->outputs[0];
+        g.gain[0] = 1.0f;
+        g.gain[1] = 0.0f;
+        return g;
+    }
+
+    // the pair (a, b) going anticlockwise with `azimuth` between them, wrapping round past the last speaker
+    ma_uint32 a = n - 1;
+    for (ma_uint32 i = 0; i < n; i++) {
+        if (array->azimuths[i] <= azimuth) a = i;
+    }
+    ma_uint32 b = (a + 1) % n;
+
+    float from = array->azimuths[a];
+    float gap  = array->azimuths[b] - from;
+    if (gap <= 0.0f) gap += 2.0f * MS_PI;
+    float t = azimuth - from;
+    if (t < 0.0f) t += 2.0f * MS_PI;
+
+    float ga, gb;
+    if (gap < 0.95f * MS_PI) {
+        // inverting the pair's base: p = ga * la + gb * lb
+        ga = sinf(gap - t) / sinf(gap);
+        gb = sinf(t) / sinf(gap);
+    } else {
+        // speakers this far apart (or opposite) can't form a base, fall back to a sine law across the gap
+        ga = cosf(0.5f * MS_PI * t / gap);
+        gb = sinf(0.5f * MS_PI * t / gap);
+    }
+    float power = sqrtf(ga*ga + gb*gb);
+    if (power > 0.0f) {
+        ga /= power;
+        gb /= power;
+    }
+
+    g.channel[0] = array->outputs[a];
+    g.channel[1] = array->outputs[b];
+    g.gain[0]    = ga;
+    g.gain[1]    = gb;
+    return g;
+}
+
+// where `voice` is, in the listener's axes (x right, y up, -z ahead) the way a relative voice is positioned
+static ma_vec3f ms_speaker_array_relative(const ma_sound* voice, const ma_vec3f* basis) {
+    ma_vec3f p = ma_sound_get_position(voice);
+    if (ma_sound_get_positioning(voice) == ma_positioning_relative) return p;
+
+    ma_vec3f v = { p.x - basis[0].x, p.y - basis[0].y, p.z - basis[0].z };
+    return { v.x*basis[1].x + v.y*basis[1].y + v.z*basis[1].z,
+             v.x*basis[2].x + v.y*basis[2].y + v.z*basis[2].z,
+           -(v.x*basis[3].x + v.y*basis[3].y + v.z*basis[3].z) };
+}
+
+// look up the table row for `relative` & scale it by distance
+static ms_vbap_gains ms_speaker_array_gains(const ms_speaker_array* array, const ma_sound* voice, ma_vec3f relative) {
+    float azimuth = atan2f(-relative.x, -relative.z);
+    if (azimuth < 0.0f) azimuth += 2.0f * MS_PI;
+    ma_uint32 row = (ma_uint32)(azimuth * MS_VBAP_TABLE_SIZE / (2.0f * MS_PI) + 0.5f) % MS_VBAP_TABLE_SIZE;
+
+    ms_vbap_gains g = array->table[row];
+    float gain = ms_voice_attenuation(voice, sqrtf(relative.x*relative.x + relative.y*relative.y + relative.z*relative.z));
+    g.gain[0] *= gain;
+    g.gain[1] *= gain;
+    return g;
+}
+
+// downmix to mono & add it to a handful of output channels, each ramping from `from` to `to` across the block
+static void ms_speaker_array_mix(const float* __restrict in, ma_uint32 channels, float* __restrict out, ma_uint32 frameCount, const ma_uint32* targets, const float* from, const float* to, ma_uint32 count) {
+    float gain[4], step[4];
+    for (ma_uint32 k = 0; k < count; k++) {
+        gain[k] = from[k];
+        step[k] = (to[k] - from[k]) / frameCount;
+    }
+
+    float downmix = 1.0f / channels;
+    for (ma_uint32 f = 0; f < frameCount; f++) {
+        const float* frameIn = in + (size_t)f * channels;
+        float* frameOut      = out + (size_t)f * channels;
+
+        float mono = 0.0f;
+        for (ma_uint32 c = 0; c < channels; c++) mono += frameIn[c];
+        mono *= downmix;
+
+        for (ma_uint32 k = 0; k < count; k++) {
+            frameOut[targets[k]] += mono * gain[k];
+            gain[k]              += step[k];
+        }
+    }
+}
+
+static void ms_speaker_panner_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut) {
+    (void)pFrameCountIn;
+    ms_speaker_panner* panner     = (ms_speaker_panner*)pNode;
+    const ms_speaker_array* array = panner->array;
+    float* out           = ppFramesOut[0];
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 channels   = array->channels;
+
+    memset(out, 0, sizeof(float) * frameCount * channels);
+
+    ma_vec3f basis[4];
+    ms_scene_listener_basis(array->engine, &basis[0], &basis[1], &basis[2], &basis[3]);
+
+    for (ma_uint32 slot = 0; slot < MS_SPEAKER_ARRAY_PANNER_VOICES; slot++) {
+        ma_sound* voice = panner->voices[slot].load(std::memory_order_acquire);
+        if (voice == nullptr || !ma_sound_is_playing(voice)) {
+            panner->previous[slot] = nullptr;
+            continue;
+        }
+
+        // nothing has moved, the gains from last block still hold
+        ma_vec3f relative      = ms_speaker_array_relative(voice, basis);
+        ma_vec3f& last         = panner->positions[slot];
+        ms_vbap_gains& current = panner->gains[slot];
+        ms_vbap_gains target   = current;
+        if (voice != panner->previous[slot] || relative.x != last.x || relative.y != last.y || relative.z != last.z) {
+            target = ms_speaker_array_gains(array, voice, relative);
+            last   = relative;
+        }
+        if (voice != panner->previous[slot]) {
+            current = target;
+            panner->previous[slot] = voice;
+        }
+
+        // ramp the channels of both pairs, crossing into a neighbouring pair only changes one of them
+        ma_uint32 targets[4];
+        float from[4], to[4];
+        ma_uint32 count = 0;
+        for (int i = 0; i < 2; i++) {
+            if (i == 1 && current.channel[1] == current.channel[0]) break; // a lone speaker
+            targets[count] = current.channel[i];
+            from[count]    = current.gain[i];
+            to[count]      = 0.0f;
+            for (int j = 0; j < 2; j++) {
+                if (target.channel[j] == current.channel[i]) to[count] += target.gain[j];
+            }
+            count++;
+        }
+        for (int j = 0; j < 2; j++) {
+            if (target.channel[j] == current.channel[0] || target.channel[j] == current.channel[1]) continue;
+            targets[count] = target.channel[j];
+            from[count]    = 0.0f;
+            to[count]      = target.gain[j];
+            count++;
+        }
+
+        ms_speaker_array_mix(ppFramesIn[slot], channels, out, frameCount, targets, from, to, count);
+        current = target;
+    }
+}
+
+static ma_node_vtable ms_speaker_panner_vtable = { ms_speaker_panner_process, NULL, MA_NODE_BUS_COUNT_UNKNOWN, 1, 0 };
+
+// `azimuths` in degrees anticlockwise from ahead, one per speaker. speaker n is wired to device channel `channels[n]`,
+// or channel n if `channels` is nullptr. `speakerAmount` defaults to one speaker per engine channel
+ma_result ms_speaker_array_init(ms_speaker_array* array, ma_engine* engine, const float* azimuths, const ma_uint32* channels, ma_uint32 speakerAmount) {
+    ma_uint32 outputs = ma_engine_get_channels(engine);
+    if (speakerAmount == 0) speakerAmount = outputs;
+
+    if (azimuths == nullptr || speakerAmount > MS_SPEAKER_ARRAY_MAX_SPEAKERS) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_speaker_array_init :: can't drive " << speakerAmount << " speaker(s)" << std::endl;
+        #endif
+        return MA_INVALID_ARGS;
+    }
+
+    vector<std::pair<float, ma_uint32> > ring(speakerAmount);
+    for (ma_uint32 n = 0; n < speakerAmount; n++) {
+        float azimuth = fmodf(azimuths[n], 360.0f);
+        if (azimuth < 0.0f) azimuth += 360.0f;
+        ring[n] = { azimuth * MS_PI / 180.0f, channels != nullptr ? channels[n] : n };
+        if (ring[n].second >= outputs) {
+            #ifdef MS_VERBOSE
+                std::cout << "ms_speaker_array_init :: the engine has no channel " << ring[n].second << std::endl;
+            #endif
+            return MA_INVALID_ARGS;
+        }
+    }
+    std::sort(ring.begin(), ring.end());
+
+    array->engine   = engine;
+    array->channels = outputs;
+    array->speakers = speakerAmount;
+    array->panners  = nullptr;
+    for (ma_uint32 n = 0; n < speakerAmount; n++) {
+        array->azimuths[n] = ring[n].first;
+        array->outputs[n]  = ring[n].second;
+    }
+
+    for (ma_uint32 row = 0; row < MS_VBAP_TABLE_SIZE; row++) {
+        array->table[row] = ms_speaker_array_vbap(array, 2.0f * MS_PI * row / MS_VBAP_TABLE_SIZE);
+    }
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_speaker_array_init :: panning across " << speakerAmount << " speaker(s) on " << outputs << " channel(s)" << std::endl;
+    #endif
+
+    return MA_SUCCESS;
+}
+
+// one speaker per channel, in the order given, placed round the origin wherever the ms_sound_speaker is on x/z
+ma_result ms_speaker_array_init(ms_speaker_array* array, ma_engine* engine, ms_sound_speaker* const* speakers, ma_uint32 speakerAmount) {
+    if (speakerAmount > MS_SPEAKER_ARRAY_MAX_SPEAKERS) return MA_INVALID_ARGS;
+
+    float azimuths[MS_SPEAKER_ARRAY_MAX_SPEAKERS];
+    for (ma_uint32 n = 0; n < speakerAmount; n++) {
+        azimuths[n] = atan2f((float)-speakers[n]->x, (float)-speakers[n]->z) * 180.0f / MS_PI;
+    }
+    return ms_speaker_array_init(array, engine, azimuths, nullptr, speakerAmount);
+}
+
+// voices plugged into `array` are detached from it
+void ms_speaker_array_uninit(ms_speaker_array* array) {
+    while (array->panners != nullptr) {
+        ms_speaker_panner* panner = array->panners;
+        array->panners = panner->next;
+        ma_node_uninit(&panner->base, NULL);
+        ms_node_profile_forget(&panner->base);
+        delete panner;
+    }
+}
+
+static ma_result ms_speaker_panner_init(ms_speaker_panner* panner, ms_speaker_array* array) {
+    panner->array      = array;
+    panner->next       = nullptr;
+    panner->free_count = MS_SPEAKER_ARRAY_PANNER_VOICES;
+    for (ma_uint32 i = 0; i < MS_SPEAKER_ARRAY_PANNER_VOICES; i++) {
+        panner->free_slots[i] = MS_SPEAKER_ARRAY_PANNER_VOICES - 1 - i; // hand out low slots first
+        panner->voices[i].store(nullptr);
+        panner->previous[i] = nullptr;
+    }
+
+    ma_uint32 inputs[MS_SPEAKER_ARRAY_PANNER_VOICES];
+    for (ma_uint32 i = 0; i < MS_SPEAKER_ARRAY_PANNER_VOICES; i++) inputs[i] = array->channels;
+
+    ma_node_config config      = ma_node_config_init();
+    config.vtable              = &ms_speaker_panner_vtable;
+    config.inputBusCount       = MS_SPEAKER_ARRAY_PANNER_VOICES;
+    config.pInputChannels      = inputs;
+    config.pOutputChannels     = &array->channels;
+    ma_result result = ma_node_init(ma_engine_get_node_graph(array->engine), &config, NULL, &panner->base);
+    if (result != MA_SUCCESS) return result;
+    ms_node_profile_watch_engine(array->engine);
+    ms_node_profile_watch(&panner->base, "speaker panner", nullptr, nullptr);
+
+    return ma_node_attach_output_bus(&panner->base, 0, ma_engine_get_endpoint(array->engine), 0);
+}
+
+// claim a slot in one of `array`'s panners & plug `voice` into it. `voice` should have its spatialization disabled,
+// the panner pans & attenuates it instead
+ma_result ms_speaker_array_add_voice(ms_speaker_array* array, ma_sound* voice, ms_speaker_voice* handle) {
+    ms_speaker_panner* panner = array->panners;
+    while (panner != nullptr && panner->free_count == 0) panner = panner->next;
+
+    if (panner == nullptr) {
+        panner = new ms_speaker_panner;
+        ma_result result = ms_speaker_panner_init(panner, array);
+        if (result != MA_SUCCESS) {
+            delete panner;
+            return result;
+        }
+        panner->next   = array->panners;
+        array->panners = panner;
+    }
+
+    handle->panner = panner;
+    handle->slot   = panner->free_slots[--panner->free_count];
+    ms_speaker_voice_set(handle, voice);
+    if (voice != nullptr) ma_node_attach_output_bus(voice, 0, panner, handle->slot);
+    return MA_SUCCESS;
+}
+
+// give the slot back. anything still attached to it has to be detached first
+void ms_speaker_array_remove_voice(ms_speaker_array* array, ms_speaker_voice* handle) {
+    (void)array;
+    if (handle->panner == nullptr) return;
+    ms_speaker_voice_set(handle, nullptr);
+    handle->panner->free_slots[handle->panner->free_count++] = handle->slot;
+    handle->panner = nullptr;
+}
+
+// change which voice the slot is positioned by, e.g. when a different variant of a sound starts
+void ms_speaker_voice_set(const ms_speaker_voice* handle, ma_sound* voice) {
+    handle->panner->voices[handle->slot].store(voice, std::memory_order_release);
+}
+
+// pan every variant of `sound` across `array` in place of miniaudio's spatializer, or nullptr to go back to it
+ma_result ms_sound_set_speaker_array(ms_sound* sound, ms_speaker_array* array) {
+    if (array == nullptr && sound->speaker_array == nullptr) return MA_SUCCESS;
+    if (sound->sounds.size() == 0) return MA_INVALID_OPERATION;
+
+    ma_engine* engine = ma_sound_get_engine(sound->sounds[0]);
+
+    #ifdef MS_HAS_LOD
+        ms_sound_reset_lod(sound);
+    #endif
+
+    if (sound->speaker_array != nullptr) {
+        ms_speaker_voice* handle = sound->speaker_array;
+        sound->speaker_array = nullptr;
+        for (ma_sound* s : sound->sounds) {
+            ma_sound_set_spatialization_enabled(s, (sound->stages & MS_SOUND_STAGE_SPATIALIZER) != 0);
+            ms_sound_route(sound, s, ma_engine_get_endpoint(engine));
+        }
+        ms_speaker_array_remove_voice(handle->panner->array, handle);
+        delete handle;
+    }
+
+    if (array == nullptr) return MA_SUCCESS;
+
+    if (!sound->spatialized) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_sound_set_speaker_array :: " << sound->name << " isn't spatialized" << std::endl;
+        #endif
+        return MA_INVALID_OPERATION;
+    }
+
+    #ifdef MS_HAS_AMBISONICS
+        if (sound->ambisonic != nullptr) return MA_INVALID_OPERATION; // one or the other
+    #endif
+
+    ms_speaker_voice* handle = new ms_speaker_voice;
+    ma_result result = ms_speaker_array_add_voice(array, sound->sounds[sound->active >= 0 ? sound->active : 0], handle);
+    if (result != MA_SUCCESS) {
+        delete handle;
+        return result;
+    }
+
+    sound->speaker_array = handle;
+    for (ma_sound* s : sound->sounds) {
+        ma_sound_set_spatialization_enabled(s, MA_FALSE);
+        ms_sound_route(sound, s, handle->panner, handle->slot);
+    }
+    return MA_SUCCESS;
+}
+
+#endif /* MS_HAS_SPEAKER_ARRAY */
+
+/* --- ms_ambience --- */
+
+#ifdef MS_HAS_AMBIENCE
+
+typedef enum {
+    MS_BIQUAD_LOWPASS,
+    MS_BIQUAD_HIGHPASS,
+    MS_BIQUAD_BANDPASS
+} ms_biquad_type;
+
+// robert bristow-johnson's cookbook coefficients for one lane
+static void ms_biquad4_set(ms_biquad4* filter, ma_uint32 lane, ms_biquad_type type, float frequency, float q, float sampleRate) {
+    float w     = 2.0f * MS_PI * frequency / sampleRate;
+    float cosw  = cosf(w);
+    float alpha = sinf(w) / (2.0f * q);
+    float a0    = 1.0f + alpha;
+
+    float b0, b1, b2;
+    switch (type) {
+        case MS_BIQUAD_LOWPASS:  b0 = (1.0f - cosw) * 0.5f; b1 = 1.0f - cosw;    b2 = b0;     break;
+        case MS_BIQUAD_HIGHPASS: b0 = (1.0f + cosw) * 0.5f; b1 = -(1.0f + cosw); b2 = b0;     break;
+        default:                 b0 = alpha;                b1 = 0.0f;           b2 = -alpha; break;
+    }
+
+    filter->b0[lane] = b0 / a0;
+    filter->b1[lane] = b1 / a0;
+    filter->b2[lane] = b2 / a0;
+    filter->a1[lane] = -2.0f * cosw / a0;
+    filter->a2[lane] = (1.0f - alpha) / a0;
+}
+
+// filter a block of four interleaved lanes in place. every frame depends on the last, so the lanes are what's done
+// in parallel - the four of them fit one SSE register
+static void ms_biquad4_process(ms_biquad4* filter, float* __restrict lanes) {
+    float b0[4], b1[4], b2[4], a1[4], a2[4], z1[4], z2[4];
+    for (int l = 0; l < 4; l++) {
+        b0[l] = filter->b0[l]; b1[l] = filter->b1[l]; b2[l] = filter->b2[l];
+        a1[l] = filter->a1[l]; a2[l] = filter->a2[l];
+        z1[l] = filter->z1[l]; z2[l] = filter->z2[l];
+    }
+
+    for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+        float* frame = lanes + f * 4;
+        for (int l = 0; l < 4; l++) {
+            float x = frame[l];
+            float y = b0[l] * x + z1[l];
+            z1[l]   = b1[l] * x - a1[l] * y + z2[l];
+            z2[l]   = b2[l] * x - a2[l] * y;
+            frame[l] = y;
+        }
+    }
+
+    for (int l = 0; l < 4; l++) {
+        filter->z1[l] = z1[l];
+        filter->z2[l] = z2[l];
+    }
+}
+
+// a block of white noise in [-1, 1) on four interleaved lanes, each its own xorshift so the lanes are independent
+// & vectorise
+static void ms_noise4(ma_uint32* state, float* __restrict lanes) {
+    ma_uint32 s[4] = { state[0], state[1], state[2], state[3] };
+    for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+        for (int l = 0; l < 4; l++) {
+            s[l] ^= s[l] << 13;
+            s[l] ^= s[l] >> 17;
+            s[l] ^= s[l] << 5;
+            lanes[f * 4 + l] = (float)(ma_int32)s[l] * (1.0f / 2147483648.0f);
+        }
+    }
+    for (int l = 0; l < 4; l++) state[l] = s[l];
+}
+
+// one draw from the slow generator, [0, 1)
+static float ms_ambience_random(ms_ambience* ambience) {
+    return ms_random01(&ambience->random);
+}
+
+// sin(2 pi phase) for a phase in [0, 1), folded onto a quarter cycle & evaluated without branches. good to ~4e-6
+static inline float ms_sine_cycles(float phase) {
+    float x = phase - 0.5f;
+    x = copysignf(0.25f - fabsf(0.25f - fabsf(x)), x);
+    x *= 2.0f * MS_PI;
+    float x2 = x * x;
+    return -x * (1.0f + x2 * (-1.0f/6.0f + x2 * (1.0f/120.0f + x2 * (-1.0f/5040.0f + x2 * (1.0f/362880.0f)))));
+}
+
+// hiss on lanes 0 & 1, droplets on 2 & 3: only the rare noise samples past a threshold get through, and each rings
+// its band-pass for a moment
+static void ms_ambience_rain(ms_ambience* ambience, float* __restrict lanes, float intensity) {
+    ms_noise4(ambience->noise, lanes);
+
+    float threshold = 0.9995f - 0.003f * intensity; // more droplets the harder it rains
+    float keep[4]   = { 0.0f, 0.0f, threshold, threshold };
+    for (ma_uint32 i = 0; i < MS_AMBIENCE_BLOCK * 4; i++) {
+        float x = lanes[i];
+        lanes[i] = (fabsf(x) >= keep[i & 3]) ? x : 0.0f;
+    }
+
+    ms_biquad4_process(&ambience->filter, lanes);
+
+    float hiss = 0.05f + 0.25f * intensity;
+    float drop = 1.5f;
+    ambience->mix[0][0] = hiss; ambience->mix[1][1] = hiss;
+    ambience->mix[2][0] = drop * 0.8f; ambience->mix[2][1] = drop * 0.2f;
+    ambience->mix[3][0] = drop * 0.2f; ambience->mix[3][1] = drop * 0.8f;
+}
+
+// the body on lanes 0 & 1 & a whistle on 2 & 3, both following a gust that drifts towards a new target now & then
+static void ms_ambience_wind(ms_ambience* ambience, float* __restrict lanes, float intensity) {
+    if (ambience->gust_left-- == 0) {
+        ambience->gust_target = intensity * (0.4f + 0.6f * ms_ambience_random(ambience));
+        ambience->gust_left   = (ma_uint32)((0.5f + 3.0f * ms_ambience_random(ambience)) * ambience->sampleRate / MS_AMBIENCE_BLOCK);
+    }
+    ambience->gust += (ambience->gust_target - ambience->gust) * 0.002f; // about a second to settle
+
+    float gust = ambience->gust;
+    float sr   = (float)ambience->sampleRate;
+    for (ma_uint32 l = 0; l < 2; l++) {
+        ms_biquad4_set(&ambience->filter, l,     MS_BIQUAD_LOWPASS,  200.0f + 900.0f * gust,            0.7f, sr);
+        ms_biquad4_set(&ambience->filter, l + 2, MS_BIQUAD_BANDPASS, 500.0f + 1200.0f * gust + 80.0f * l, 12.0f, sr);
+    }
+
+    ms_noise4(ambience->noise, lanes);
+    ms_biquad4_process(&ambience->filter, lanes);
+
+    float body    = 0.2f + 1.2f * gust;
+    float whistle = 1.5f * gust * gust;
+    ambience->mix[0][0] = body;    ambience->mix[1][1] = body;
+    ambience->mix[2][0] = whistle; ambience->mix[3][1] = whistle;
+}
+
+// each insect is a high tone pulsed by a half-wave squared sine, gated in & out of phrases. nothing here is noise,
+// every lane is an oscillator of its own, worked out a lane at a time & interleaved at the end
+static void ms_ambience_insects(ms_ambience* ambience, float* __restrict lanes, float intensity) {
+    float tone[4][MS_AMBIENCE_BLOCK];
+    for (int l = 0; l < 4; l++) {
+        if (ambience->phrase_left[l]-- == 0) {
+            // busier insects sing more often & rest for less
+            ambience->singing[l] = !ambience->singing[l] && ms_ambience_random(ambience) < 0.2f + 0.8f * intensity;
+            float seconds = ambience->singing[l] ? 0.3f + 1.5f * ms_ambience_random(ambience) : (0.2f + 2.0f * ms_ambience_random(ambience)) * (1.5f - intensity);
+            ambience->phrase_left[l] = (ma_uint32)(seconds * ambience->sampleRate / MS_AMBIENCE_BLOCK);
+        }
+        float target = ambience->singing[l] ? 1.0f : 0.0f;
+        float gate   = ambience->gate[l];
+        float next   = gate + (target - gate) * 0.3f;
+        float step   = (next - gate) / MS_AMBIENCE_BLOCK;
+        ambience->gate[l] = next;
+
+        float phase     = ambience->phase[l];
+        float increment = ambience->increment[l];
+        float pulse     = ambience->pulse_phase[l];
+        float rate      = ambience->pulse_increment[l];
+        float* out      = tone[l];
+        for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+            float p = phase + increment * f;
+            float q = pulse + rate * f;
+            p -= (float)(int)p;
+            q -= (float)(int)q;
+            float chirp = ms_sine_cycles(q);
+            chirp = (chirp > 0.0f) ? chirp : 0.0f;
+            out[f] = ms_sine_cycles(p) * chirp * chirp * (gate + step * f);
+        }
+
+        float p = phase + increment * MS_AMBIENCE_BLOCK;
+        float q = pulse + rate * MS_AMBIENCE_BLOCK;
+        ambience->phase[l]       = p - (float)(int)p;
+        ambience->pulse_phase[l] = q - (float)(int)q;
+    }
+
+    for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+        lanes[f * 4]     = tone[0][f];
+        lanes[f * 4 + 1] = tone[1][f];
+        lanes[f * 4 + 2] = tone[2][f];
+        lanes[f * 4 + 3] = tone[3][f];
+    }
+}
+
+// render the next block into `block`
+static void ms_ambience_render(ms_ambience* ambience) {
+    float intensity = ambience->intensity.load(std::memory_order_relaxed);
+
+    float lanes[MS_AMBIENCE_BLOCK * 4];
+    switch (ambience->type) {
+        case MS_AMBIENCE_RAIN:    ms_ambience_rain(ambience, lanes, intensity);    break;
+        case MS_AMBIENCE_WIND:    ms_ambience_wind(ambience, lanes, intensity);    break;
+        case MS_AMBIENCE_INSECTS: ms_ambience_insects(ambience, lanes, intensity); break;
+    }
+
+    float mix[4][2];
+    memcpy(mix, ambience->mix, sizeof(mix));
+    for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+        const float* l = lanes + f * 4;
+        ambience->block[f * 2]     = l[0] * mix[0][0] + l[1] * mix[1][0] + l[2] * mix[2][0] + l[3] * mix[3][0];
+        ambience->block[f * 2 + 1] = l[0] * mix[0][1] + l[1] * mix[1][1] + l[2] * mix[2][1] + l[3] * mix[3][1];
+    }
+    ambience->block_position = 0;
+}
+
+static ma_result ms_ambience_read(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead) {
+    ms_ambience* ambience = (ms_ambience*)pDataSource;
+    float* out            = (float*)pFramesOut;
+
+    for (ma_uint64 done = 0; done < frameCount; ) {
+        if (ambience->block_position == MS_AMBIENCE_BLOCK) ms_ambience_render(ambience);
+
+        ma_uint64 frames = MS_AMBIENCE_BLOCK - ambience->block_position;
+        if (frames > frameCount - done) frames = frameCount - done;
+        if (out != NULL) memcpy(out + done * 2, ambience->block + ambience->block_position * 2, sizeof(float) * 2 * frames);
+
+        ambience->block_position += (ma_uint32)frames;
+        done += frames;
+    }
+    ambience->cursor += frameCount;
+
+    if (pFramesRead != NULL) *pFramesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+static void ms_ambience_reset(ms_ambience* ambience);
+
+// everything follows from the seed, so the only way to a frame is to start again & render up to it. that costs as
+// much as playing that far, a minute of rain is ~40 ms
+static ma_result ms_ambience_seek(ma_data_source* pDataSource, ma_uint64 frameIndex) {
+    ms_ambience* ambience = (ms_ambience*)pDataSource;
+
+    ms_ambience_reset(ambience);
+    for (ma_uint64 b = 0; b < frameIndex / MS_AMBIENCE_BLOCK; b++) ms_ambience_render(ambience);
+    ambience->block_position = MS_AMBIENCE_BLOCK;
+    if (frameIndex % MS_AMBIENCE_BLOCK != 0) {
+        ms_ambience_render(ambience);
+        ambience->block_position = (ma_uint32)(frameIndex % MS_AMBIENCE_BLOCK);
+    }
+    ambience->cursor = frameIndex;
+
+    return MA_SUCCESS;
+}
+
+static ma_result ms_ambience_get_cursor(ma_data_source* pDataSource, ma_uint64* pCursor) {
+    *pCursor = ((ms_ambience*)pDataSource)->cursor;
+    return MA_SUCCESS;
+}
+
+// endless, so it has no length. looping it does nothing
+static ma_result ms_ambience_get_length(ma_data_source* pDataSource, ma_uint64* pLength) {
+    (void)pDataSource;
+    *pLength = 0;
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_result ms_ambience_get_data_format(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap) {
+    ms_ambience* ambience = (ms_ambience*)pDataSource;
+    if (pFormat != NULL)     *pFormat     = ma_format_f32;
+    if (pChannels != NULL)   *pChannels   = 2;
+    if (pSampleRate != NULL) *pSampleRate = ambience->sampleRate;
+    if (pChannelMap != NULL) ma_channel_map_init_standard(ma_standard_channel_map_default, pChannelMap, channelMapCap, 2);
+    return MA_SUCCESS;
+}
+
+static ma_data_source_vtable ms_ambience_vtable = { ms_ambience_read, ms_ambience_seek, ms_ambience_get_data_format, ms_ambience_get_cursor, ms_ambience_get_length, NULL, 0 };
+
+// back to the first frame `seed` makes
+static void ms_ambience_reset(ms_ambience* ambience) {
+    ma_uint32 seed        = ambience->seed;
+    ms_ambience_type type = ambience->type;
+
+    ambience->cursor = 0;
+    ambience->random = seed * 2654435761u + 1; // never 0, xorshift would stay there
+    for (int l = 0; l < 4; l++) ambience->noise[l] = (seed + l + 1) * 2246822519u | 1;
+    memset(&ambience->filter, 0, sizeof(ambience->filter));
+    memset(ambience->mix, 0, sizeof(ambience->mix));
+    ambience->block_position = MS_AMBIENCE_BLOCK; // nothing rendered yet
+
+    ambience->gust        = 0.0f;
+    ambience->gust_target = 0.0f;
+    ambience->gust_left   = 0;
+
+    float sr = (float)ambience->sampleRate;
+    for (int l = 0; l < 4; l++) {
+        ambience->phase[l]           = ms_ambience_random(ambience);
+        ambience->increment[l]       = (3500.0f + 2500.0f * ms_ambience_random(ambience)) / sr;
+        ambience->pulse_phase[l]     = 0.0f;
+        ambience->pulse_increment[l] = (12.0f + 20.0f * ms_ambience_random(ambience)) / sr;
+        ambience->gate[l]            = 0.0f;
+        ambience->phrase_left[l]     = (ma_uint32)(ms_ambience_random(ambience) * sr / MS_AMBIENCE_BLOCK);
+        ambience->singing[l]         = MA_FALSE;
+    }
+
+    switch (type) {
+        case MS_AMBIENCE_RAIN:
+            ms_biquad4_set(&ambience->filter, 0, MS_BIQUAD_BANDPASS, 3000.0f, 0.4f, sr);
+            ms_biquad4_set(&ambience->filter, 1, MS_BIQUAD_BANDPASS, 3200.0f, 0.4f, sr);
+            ms_biquad4_set(&ambience->filter, 2, MS_BIQUAD_BANDPASS, 2000.0f + 3000.0f * ms_ambience_random(ambience), 6.0f, sr);
+            ms_biquad4_set(&ambience->filter, 3, MS_BIQUAD_BANDPASS, 2000.0f + 3000.0f * ms_ambience_random(ambience), 6.0f, sr);
+            break;
+        case MS_AMBIENCE_INSECTS:
+            for (int l = 0; l < 4; l++) {
+                float pan = ms_ambience_random(ambience);
+                ambience->mix[l][0] = 0.15f * sqrtf(1.0f - pan);
+                ambience->mix[l][1] = 0.15f * sqrtf(pan);
+            }
+            break;
+        default: break;
+    }
+}
+
+// `seed` picks which rain, wind or insects you get - the same seed always makes the same sound, so long as the
+// intensity is the same
+ma_result ms_ambience_init(ms_ambience* ambience, ms_ambience_type type, ma_uint32 seed, float intensity) {
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable = &ms_ambience_vtable;
+    ma_result result = ma_data_source_init(&config, &ambience->base);
+    if (result != MA_SUCCESS) return result;
+
+    ambience->type       = type;
+    ambience->sampleRate = MS_SAMPLE_RATE;
+    ambience->seed       = seed;
+    ambience->intensity.store(intensity < 0.0f ? 0.0f : (intensity > 1.0f ? 1.0f : intensity));
+    ms_ambience_reset(ambience);
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_ambience_init :: seed " << seed << ", " << sizeof(ms_ambience) << " bytes" << std::endl;
+    #endif
+
+    return MA_SUCCESS;
+}
+
+void ms_ambience_uninit(ms_ambience* ambience) {
+    ma_data_source_uninit(&ambience->base);
+}
+
+// how hard it rains, how strong the wind blows or how busy the insects are, 0.0 to 1.0. any thread
+void ms_ambience_set_intensity(ms_ambience* ambience, float intensity) {
+    ambience->intensity.store(intensity < 0.0f ? 0.0f : (intensity > 1.0f ? 1.0f : intensity), std::memory_order_relaxed);
+}
+
+/* --- ms_granular --- */
+
+// start stream `s` on a new grain, after a short wait so the streams don't fall into step
+static void ms_granular_spawn(ms_granular* granular, ma_uint32 s) {
+    ma_uint32* random = &granular->random;
+    float minLength   = granular->min_length.load(std::memory_order_relaxed);
+    float maxLength   = granular->max_length.load(std::memory_order_relaxed);
+    float spread      = granular->pitch_spread.load(std::memory_order_relaxed);
+
+    float length = minLength + (maxLength - minLength) * ms_random01(random);
+    float pitch  = 1.0f + spread * (2.0f * ms_random01(random) - 1.0f);
+    float span   = length * pitch;
+    float room   = (float)granular->clipFrames - span - 2.0f; // the last frame read is interpolated towards the next
+    if (room < 0.0f) {
+        // the settings changed halfway through being read
+        span = (float)granular->clipFrames - 2.0f;
+        room = 0.0f;
+    }
+
+    granular->start[s]      = (ma_uint32)(ms_random01(random) * room);
+    granular->age[s]        = -0.5f * length * ms_random01(random);
+    granular->inv_length[s] = 1.0f / length;
+    granular->span[s]       = span;
+    granular->shape[s]      = ms_random01(random);
+
+    float pan  = ms_random01(random);
+    float gain = (0.5f + 0.5f * ms_random01(random)) / sqrtf((float)granular->streams);
+    granular->gain_left[s]  = gain * sqrtf(1.0f - pan);
+    granular->gain_right[s] = gain * sqrtf(pan);
+}
+
+// render the next block into `block`
+static void ms_granular_render(ms_granular* granular) {
+    float left[MS_AMBIENCE_BLOCK]  = { 0 };
+    float right[MS_AMBIENCE_BLOCK] = { 0 };
+    float offset[MS_AMBIENCE_BLOCK];
+    float window[MS_AMBIENCE_BLOCK];
+    float sample[MS_AMBIENCE_BLOCK];
+    const float* clip = granular->clip;
+
+    for (ma_uint32 s = 0; s < granular->streams; s++) {
+        float age   = granular->age[s];
+        float inv   = granular->inv_length[s];
+        float span  = granular->span[s];
+        float shape = granular->shape[s];
+
+        // where the grain is & how loud, clamped so a grain that's waiting or done reads its first or last frame silently
+        for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+            float t = (age + f) * inv;
+            t = 0.5f * (fabsf(t) - fabsf(t - 1.0f) + 1.0f); // clamped to [0, 1] without a branch
+            float h   = ms_sine_cycles(0.5f * t);
+            h        *= h;
+            offset[f] = t * span;
+            window[f] = h * (1.0f + shape * (1.0f - h));
+        }
+
+        // the one part that can't vectorise without gathers
+        const float* from = clip + granular->start[s];
+        for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+            ma_uint32 i = (ma_uint32)offset[f];
+            float frac  = offset[f] - (float)i;
+            sample[f]   = from[i] + frac * (from[i + 1] - from[i]);
+        }
+
+        float gainLeft  = granular->gain_left[s];
+        float gainRight = granular->gain_right[s];
+        for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+            float v   = sample[f] * window[f];
+            left[f]  += v * gainLeft;
+            right[f] += v * gainRight;
+        }
+    }
+
+    // age every stream at once, then start new grains on the few that ran out
+    ma_uint32 done[MS_GRANULAR_STREAMS];
+    for (ma_uint32 s = 0; s < MS_GRANULAR_STREAMS; s++) {
+        granular->age[s] += MS_AMBIENCE_BLOCK;
+        done[s] = granular->age[s] * granular->inv_length[s] >= 1.0f;
+    }
+    for (ma_uint32 s = 0; s < granular->streams; s++) {
+        if (done[s]) ms_granular_spawn(granular, s);
+    }
+
+    for (ma_uint32 f = 0; f < MS_AMBIENCE_BLOCK; f++) {
+        granular->block[f * 2]     = left[f];
+        granular->block[f * 2 + 1] = right[f];
+    }
+    granular->block_position = 0;
+}
+
+static ma_result ms_granular_read(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead) {
+    ms_granular* granular = (ms_granular*)pDataSource;
+    float* out            = (float*)pFramesOut;
+
+    for (ma_uint64 done = 0; done < frameCount; ) {
+        if (granular->block_position == MS_AMBIENCE_BLOCK) ms_granular_render(granular);
+
+        ma_uint64 frames = MS_AMBIENCE_BLOCK - granular->block_position;
+        if (frames > frameCount - done) frames = frameCount - done;
+        if (out != NULL) memcpy(out + done * 2, granular->block + granular->block_position * 2, sizeof(float) * 2 * frames);
+
+        granular->block_position += (ma_uint32)frames;
+        done += frames;
+    }
+    granular->cursor += frameCount;
+
+    if (pFramesRead != NULL) *pFramesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+static ma_result ms_granular_get_data_format(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap) {
+    ms_granular* granular = (ms_granular*)pDataSource;
+    if (pFormat != NULL)     *pFormat     = ma_format_f32;
+    if (pChannels != NULL)   *pChannels   = 2;
+    if (pSampleRate != NULL) *pSampleRate = granular->sampleRate;
+    if (pChannelMap != NULL) ma_channel_map_init_standard(ma_standard_channel_map_default, pChannelMap, channelMapCap, 2);
+    return MA_SUCCESS;
+}
+
+// back to the first frame the seed makes
+static void ms_granular_reset(ms_granular* granular) {
+    granular->cursor         = 0;
+    granular->random         = granular->seed * 2654435761u + 1;
+    granular->block_position = MS_AMBIENCE_BLOCK;
+
+    for (ma_uint32 s = 0; s < MS_GRANULAR_STREAMS; s++) {
+        granular->start[s]      = 0;
+        granular->age[s]        = 0.0f;
+        granular->inv_length[s] = 0.0f; // never done, the streams past `streams` stay put
+        granular->span[s]       = 0.0f;
+        granular->shape[s]      = 0.0f;
+        granular->gain_left[s]  = 0.0f;
+        granular->gain_right[s] = 0.0f;
+    }
+    // staggered over a whole grain, so they don't all start together
+    for (ma_uint32 s = 0; s < granular->streams; s++) {
+        ms_granular_spawn(granular, s);
+        granular->age[s] = -ms_random01(&granular->random) * granular->max_length.load();
+    }
+}
+
+// like ms_ambience_seek(), rendered up to `frameIndex` from the start
+static ma_result ms_granular_seek(ma_data_source* pDataSource, ma_uint64 frameIndex) {
+    ms_granular* granular = (ms_granular*)pDataSource;
+
+    ms_granular_reset(granular);
+    for (ma_uint64 b = 0; b < frameIndex / MS_AMBIENCE_BLOCK; b++) ms_granular_render(granular);
+    granular->block_position = MS_AMBIENCE_BLOCK;
+    if (frameIndex % MS_AMBIENCE_BLOCK != 0) {
+        ms_granular_render(granular);
+        granular->block_position = (ma_uint32)(frameIndex % MS_AMBIENCE_BLOCK);
+    }
+    granular->cursor = frameIndex;
+
+    return MA_SUCCESS;
+}
+
+static ma_result ms_granular_get_cursor(ma_data_source* pDataSource, ma_uint64* pCursor) {
+    *pCursor = ((ms_granular*)pDataSource)->cursor;
+    return MA_SUCCESS;
+}
+
+static ma_data_source_vtable ms_granular_vtable = { ms_granular_read, ms_granular_seek, ms_granular_get_data_format, ms_granular_get_cursor, ms_ambience_get_length, NULL, 0 };
+
+// decodes `filepath` to mono at MS_SAMPLE_RATE and keeps `clipLength` seconds of it from `clipStart` (all of it for
+// 0.0). `streams` grains play at once, at most MS_GRANULAR_STREAMS. grains are 50 to 250 ms long, +- 5% in pitch
+// until ms_granular_set_grains() says otherwise
+ma_result ms_granular_init(ms_granular* granular, const std::string filepath, ma_uint32 streams, ma_uint32 seed, float clipStart, float clipLength) {
+    if (streams == 0 || streams > MS_GRANULAR_STREAMS) return MA_INVALID_ARGS;
+
+    ma_decoder_config decoderConfig = ma_decoder_config_init(ma_format_f32, 1, MS_SAMPLE_RATE);
+    void* frames;
+    ma_uint64 frameCount;
+    ma_uint64 traced = ms_trace_begin();
+    ma_result result = ma_decode_file(filepath.c_str(), &decoderConfig, &frameCount, &frames);
+    ms_trace_end("decode", traced, filepath.c_str());
+    if (result != MA_SUCCESS) {
+        MS_METRIC_ADD(load_failures, 1);
+        return result;
+    }
+    MS_METRIC_ADD(loads, 1);
+
+    // only the crop is kept
+    ma_uint64 first = (ma_uint64)(clipStart * MS_SAMPLE_RATE);
+    ma_uint64 count = (clipLength > 0.0f) ? (ma_uint64)(clipLength * MS_SAMPLE_RATE) : frameCount;
+    if (first > frameCount) first = frameCount;
+    if (count > frameCount - first) count = frameCount - first;
+
+    // room for the longest grain at the highest pitch
+    if (count < (ma_uint64)(0.25f * MS_SAMPLE_RATE * 1.05f) + 2) {
+        ma_free(frames, NULL);
+        return MA_INVALID_DATA;
+    }
+
+    granular->clip = (float*)ma_malloc(sizeof(float) * count, NULL);
+    if (granular->clip == NULL) {
+        ma_free(frames, NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+    memcpy(granular->clip, (float*)frames + first, sizeof(float) * count);
+    ma_free(frames, NULL);
+
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable = &ms_granular_vtable;
+    result = ma_data_source_init(&config, &granular->base);
+    if (result != MA_SUCCESS) {
+        ma_free(granular->clip, NULL);
+        return result;
+    }
+
+    granular->sampleRate = MS_SAMPLE_RATE;
+    granular->clipFrames = count;
+    granular->streams    = streams;
+    granular->seed       = seed;
+    granular->min_length.store(0.05f * MS_SAMPLE_RATE);
+    granular->max_length.store(0.25f * MS_SAMPLE_RATE);
+    granular->pitch_spread.store(0.05f);
+    ms_granular_reset(granular);
+    MS_METRIC_ADD(bytes_resident, (ma_int64)(sizeof(float) * count));
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_granular_init :: " << filepath << ", " << count << " frames kept, " << streams << " streams" << std::endl;
+    #endif
+
+    return MA_SUCCESS;
+}
+
+void ms_granular_uninit(ms_granular* granular) {
+    ma_data_source_uninit(&granular->base);
+    ma_free(granular->clip, NULL);
+    MS_METRIC_ADD(bytes_resident, -(ma_int64)(sizeof(float) * granular->clipFrames));
+}
+
+// grain lengths in seconds & how far their pitch wanders either way, 0.05 being +- 5%. the longest grain at the
+// highest pitch has to fit in the clip, anything longer is shortened. any thread, new grains pick it up
+void ms_granular_set_grains(ms_granular* granular, float minLength, float maxLength, float pitchSpread) {
+    if (pitchSpread < 0.0f) pitchSpread = 0.0f;
+    if (pitchSpread > 0.9f) pitchSpread = 0.9f;
+
+    float longest = ((float)granular->clipFrames - 2.0f) / (1.0f + pitchSpread);
+    maxLength *= granular->sampleRate;
+    minLength *= granular->sampleRate;
+    if (maxLength > longest)   maxLength = longest;
+    if (maxLength < 64.0f)     maxLength = 64.0f;
+    if (minLength > maxLength) minLength = maxLength;
+    if (minLength < 64.0f)     minLength = 64.0f;
+
+    granular->min_length.store(minLength, std::memory_order_relaxed);
+    granular->max_length.store(maxLength, std::memory_order_relaxed);
+    granular->pitch_spread.store(pitchSpread, std::memory_order_relaxed);
+}
+
+#endif /* MS_HAS_AMBIENCE */
+
+/* --- ms_render --- */
+
+#ifndef MS_NO_SOUNDSCAPE
+
+// render `seconds` of `soundscapes`, which all have to share an engine made with `noDevice`, into a wav file at
+// `filepath`. written as 32 bit float unless `format` says otherwise, e.g. ma_format_s16 for a bed to ship
+ma_result ms_render(ms_soundscape* const* soundscapes, size_t soundscapesAmount, const std::string filepath, double seconds, ms_render_stats* stats, ma_format format) {
+    if (soundscapesAmount == 0 || seconds < 0.0) return MA_INVALID_ARGS;
+
+    ma_engine* engine = soundscapes[0]->engine;
+    for (size_t i = 1; i < soundscapesAmount; i++) {
+        if (soundscapes[i]->engine != engine) return MA_INVALID_ARGS;
+    }
+    if (ma_engine_get_device(engine) != NULL) {
         #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_pitch_range :: `start` must be greater than 0" << std::endl;
+            std::cout << "ms_render :: the engine drives a device, it needs `noDevice` to be rendered offline" << std::endl;
         #endif
-        start = 0.0f;
+        return MA_INVALID_OPERATION;
+    }
+
+    if (filepath.size() >= 5 && filepath.compare(filepath.size() - 5, 5, ".flac") == 0) {
+        #ifdef MS_VERBOSE
+            std::cout << "ms_render :: miniaudio can only encode wav, not " << filepath << std::endl;
+        #endif
+        return MA_FORMAT_NOT_SUPPORTED;
+    }
+
+    ma_uint32 channels   = ma_engine_get_channels(engine);
+    ma_uint32 sampleRate = ma_engine_get_sample_rate(engine);
+
+    ma_encoder_config encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, format, channels, sampleRate);
+    ma_encoder encoder;
+    ma_result result = ma_encoder_init_file(filepath.c_str(), &encoderConfig, &encoder);
+    if (result != MA_SUCCESS) return result;
+
+    vector<float> mixed(MS_RENDER_BLOCK * channels);
+    vector<ma_uint8> converted((format == ma_format_f32) ? 0 : MS_RENDER_BLOCK * ma_get_bytes_per_frame(format, channels));
+
+    // triangular dither a least significant bit wide, from a generator of the render's own rather than miniaudio's
+    // shared one, so integer renders come out the same every time as well
+    float lsb        = (format == ma_format_u8) ? 1.0f / 128.0f : 1.0f / (float)(1ULL << (ma_get_bytes_per_sample(format) * 8 - 1));
+    ma_uint32 dither = 0x9E3779B9;
+
+    ma_uint64 target = (ma_uint64)(seconds * sampleRate);
+    ma_uint64 done   = 0;
+    auto start       = std::chrono::steady_clock::now();
+    while (done < target && result == MA_SUCCESS) {
+        for (size_t i = 0; i < soundscapesAmount; i++) {
+            if (!soundscapes[i]->sounds.empty()) ms_soundscape_tick(soundscapes[i]); // an ambient alone has nothing to tick
+        }
+
+        ma_uint64 frames = (target - done < MS_RENDER_BLOCK) ? target - done : MS_RENDER_BLOCK;
+        result = ma_engine_read_pcm_frames(engine, mixed.data(), frames, &frames);
+        if (result != MA_SUCCESS) break;
+
+        const void* out = mixed.data();
+        if (format != ma_format_f32) {
+            for (ma_uint64 i = 0; i < frames * channels; i++) {
+                mixed[i] += lsb * (ms_random01(&dither) - ms_random01(&dither));
+            }
+            ma_convert_pcm_frames_format(converted.data(), format, mixed.data(), ma_format_f32, frames, channels, ma_dither_mode_none);
+            out = converted.data();
+        }
+        result = ma_encoder_write_pcm_frames(&encoder, out, frames, NULL);
+        done  += frames;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ma_encoder_uninit(&encoder);
+
+    if (stats != nullptr) {
+        stats->frames          = done;
+        stats->audio_seconds   = (double)done / sampleRate;
+        stats->wall_seconds    = elapsed;
+        stats->realtime_factor = (elapsed > 0.0) ? stats->audio_seconds / elapsed : 0.0;
+    }
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_render :: " << filepath << ", " << (double)done / sampleRate << " s in " << elapsed << " s" << std::endl;
+    #endif
+
+    return result;
+}
+
+ma_result ms_render(ms_soundscape* soundscape, const std::string filepath, double seconds, ms_render_stats* stats, ma_format format) {
+    return ms_render(&soundscape, 1, filepath, seconds, stats, format);
+}
+
+#endif /* MS_NO_SOUNDSCAPE */
+
+/* --- ms_parallel --- */
+
+#ifdef MS_HAS_PARALLEL
+
+// render submix `index` into its block for block `block`. one still rendering an earlier block it was late for is
+// skipped, it's left out of this block too
+static void ms_parallel_render(ms_parallel* parallel, ma_uint32 index, ma_uint32 block) {
+    ms_submix* submix = parallel->submixes[index];
+    if (submix->busy.exchange(true, std::memory_order_acquire)) return;
+
+    ma_uint64 traced  = ms_trace_begin();
+    ma_uint64 frames  = 0;
+    ma_engine_read_pcm_frames(&submix->engine, submix->block.data(), parallel->frames, &frames);
+    if (frames < parallel->frames) {
+        memset(submix->block.data() + frames * parallel->channels, 0, (parallel->frames - frames) * parallel->channels * sizeof(float));
+    }
+    ms_trace_end("submix", traced);
+
+    submix->rendered.store(block, std::memory_order_release);
+    submix->busy.store(false, std::memory_order_release);
+}
+
+// one submix of block `block` done. a thread that claimed it for a block the reading thread has since given up on
+// leaves the count alone, it's the next block's by now
+static void ms_parallel_finish(ms_parallel* parallel, ma_uint32 block) {
+    ma_uint64 remaining = parallel->remaining.load(std::memory_order_relaxed);
+    while ((ma_uint32)(remaining >> 32) == block && (ma_uint32)remaining > 0) {
+        if (parallel->remaining.compare_exchange_weak(remaining, remaining - 1, std::memory_order_release, std::memory_order_relaxed)) return;
+    }
+}
+
+// render submixes of block `block` until none are left to claim, from `self`'s queue first and then stealing from
+// the others'
+static void ms_parallel_work(ms_parallel* parallel, ma_uint32 self, ma_uint32 block) {
+    for (ma_uint32 q = 0; q < parallel->threads; q++) {
+        ms_parallel_queue& queue = parallel->queues[(self + q) % parallel->threads];
+        for (;;) {
+            ma_uint64 range = queue.range.fetch_add(1, std::memory_order_acq_rel);
+            ma_uint32 index = (ma_uint32)range;
+            if (index >= (ma_uint32)(range >> 32)) break;
+
+            ms_parallel_render(parallel, index, block);
+            if (q != 0) parallel->stolen.fetch_add(1, std::memory_order_relaxed);
+            ms_parallel_finish(parallel, block);
+        }
+    }
+}
+
+static void ms_parallel_worker(ms_parallel* parallel, ma_uint32 self) {
+    ms_trace_thread_name(("submix " + to_string(self)).c_str());
+    for (;;) {
+        ma_event_wait(&parallel->wake[self]);
+        if (parallel->quit.load(std::memory_order_acquire)) return;
+        // read before claiming, so a claim from a later block's queues is tagged as too old to be summed
+        ms_parallel_work(parallel, self, parallel->block_index.load(std::memory_order_acquire));
+    }
+}
+
+// render & sum the next MS_RENDER_BLOCK frames into `mixed`. nothing is ticked or started here, it may be the audio
+// thread
+static void ms_parallel_block(ms_parallel* parallel) {
+    auto start = std::chrono::steady_clock::now();
+
+    ma_uint32 count  = (ma_uint32)parallel->submixes.size();
+    ma_uint32 block  = parallel->block_index.load(std::memory_order_relaxed) + 1;
+    parallel->block_index.store(block, std::memory_order_release);
+    if (parallel->threads == 1 || count < 2 || parallel->sitting_out > 0) {
+        for (ma_uint32 i = 0; i < count; i++) ms_parallel_render(parallel, i, block);
+        if (parallel->sitting_out > 0) {
+            parallel->sitting_out--;
+            parallel->stats.serial++;
+        }
+    } else {
+        // a worker that wakes late may still be claiming from the last block's queues, which are all used up by now
+        parallel->remaining.store((ma_uint64)block << 32 | count, std::memory_order_relaxed);
+        for (ma_uint32 t = 0; t < parallel->threads; t++) {
+            ma_uint64 begin = (ma_uint64)t * count / parallel->threads;
+            ma_uint64 end   = (ma_uint64)(t + 1) * count / parallel->threads;
+            parallel->queues[t].range.store(end << 32 | begin, std::memory_order_release);
+        }
+        for (ma_uint32 t = 1; t < parallel->threads; t++) ma_event_signal(&parallel->wake[t]);
+
+        // this thread takes its share too, and whatever the workers haven't got to once it's done. then it waits for
+        // the ones they're still on, but no longer than the block lasts: past that the device is starved anyway, and a
+        // submix that isn't done is left out of the block rather than holding up the audio thread
+        ms_parallel_work(parallel, 0, block);
+        auto giveUp = start + std::chrono::duration<double>((double)MS_RENDER_BLOCK / parallel->sampleRate);
+        while ((ma_uint32)parallel->remaining.load(std::memory_order_acquire) != 0 && std::chrono::steady_clock::now() < giveUp) std::this_thread::yield();
+
+        double took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        parallel->stats.pooled++;
+        if (took > parallel->deadline * MS_RENDER_BLOCK / parallel->sampleRate) {
+            parallel->stats.missed++;
+            if (++parallel->misses >= MS_PARALLEL_MISSES) {
+                parallel->misses      = 0;
+                parallel->sitting_out = MS_PARALLEL_SIT_OUT;
+                #ifdef MS_VERBOSE
+                    std::cout << "ms_parallel :: " << MS_PARALLEL_MISSES << " blocks over the deadline, rendering on one thread for " << MS_PARALLEL_SIT_OUT << std::endl;
+                #endif
+            }
+        } else {
+            parallel->misses = 0;
+        }
+    }
+
+    // summed in submix order, so the mix comes out the same whichever thread rendered what
+    float* mixed   = parallel->mixed.data();
+    ma_uint32 size = parallel->frames * parallel->channels;
+    memset(mixed, 0, size * sizeof(float));
+    for (const ms_submix* submix : parallel->submixes) {
+        if (submix->rendered.load(std::memory_order_acquire) != block) {
+            parallel->stats.dropped++;
+            continue;
+        }
+        const float* rendered = submix->block.data();
+        for (ma_uint32 i = 0; i < size; i++) mixed[i] += rendered[i];
     }
 
-    sound->pitch_range[0] = start;
-    sound->pitch_range[1] = end;
+    parallel->stats.blocks++;
+    parallel->stats.wall_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// `frameCount` frames of the mix into `out`, interleaved float. blocks are rendered as they're needed
+ma_result ms_parallel_read(ms_parallel* parallel, float* out, ma_uint64 frameCount, ma_uint64* framesRead) {
+    ma_uint64 done = 0;
+    while (done < frameCount) {
+        if (parallel->mixed_position == MS_RENDER_BLOCK) {
+            ms_parallel_block(parallel);
+            parallel->mixed_position = 0;
+        }
+
+        ma_uint64 frames = MS_RENDER_BLOCK - parallel->mixed_position;
+        if (frames > frameCount - done) frames = frameCount - done;
+        memcpy(out + done * parallel->channels, parallel->mixed.data() + parallel->mixed_position * parallel->channels, frames * parallel->channels * sizeof(float));
+        parallel->mixed_position += (ma_uint32)frames;
+        done += frames;
+    }
+    parallel->cursor += done;
+
+    if (framesRead != nullptr) *framesRead = done;
+    return MA_SUCCESS;
+}
+
+static ma_result ms_parallel_source_read(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead) {
+    return ms_parallel_read((ms_parallel*)pDataSource, (float*)pFramesOut, frameCount, pFramesRead);
+}
+
+// the soundscapes can't be played backwards, and rendering up to a frame would tick them along the way
+static ma_result ms_parallel_source_seek(ma_data_source* pDataSource, ma_uint64 frameIndex) {
+    (void)pDataSource;
+    (void)frameIndex;
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_result ms_parallel_source_get_data_format(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap) {
+    ms_parallel* parallel = (ms_parallel*)pDataSource;
+    if (pFormat != NULL)     *pFormat     = ma_format_f32;
+    if (pChannels != NULL)   *pChannels   = parallel->channels;
+    if (pSampleRate != NULL) *pSampleRate = parallel->sampleRate;
+    if (pChannelMap != NULL) ma_channel_map_init_standard(ma_standard_channel_map_default, pChannelMap, channelMapCap, parallel->channels);
+    return MA_SUCCESS;
+}
+
+static ma_result ms_parallel_source_get_cursor(ma_data_source* pDataSource, ma_uint64* pCursor) {
+    *pCursor = ((ms_parallel*)pDataSource)->cursor;
+    return MA_SUCCESS;
+}
+
+// endless, like an ambience
+static ma_result ms_parallel_source_get_length(ma_data_source* pDataSource, ma_uint64* pLength) {
+    (void)pDataSource;
+    *pLength = 0;
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_data_source_vtable ms_parallel_vtable = { ms_parallel_source_read, ms_parallel_source_seek, ms_parallel_source_get_data_format, ms_parallel_source_get_cursor, ms_parallel_source_get_length, NULL, 0 };
+
+// start a pool of `threads` threads, counting whichever one reads, to mix submixes of `channels` at `sampleRate`.
+// 0 threads is one for every core. the ms_parallel can't be moved once the pool is running
+ma_result ms_parallel_init(ms_parallel* parallel, ma_uint32 threads, ma_uint32 channels, ma_uint32 sampleRate) {
+    if (channels == 0 || sampleRate == 0) return MA_INVALID_ARGS;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    ma_data_source_config sourceConfig = ma_data_source_config_init();
+    sourceConfig.vtable = &ms_parallel_vtable;
+    ma_result result = ma_data_source_init(&sourceConfig, &parallel->base);
+    if (result != MA_SUCCESS) return result;
+
+    // as an engine would make for itself
+    ma_resource_manager_config resourceConfig = ma_resource_manager_config_init();
+    resourceConfig.decodedFormat     = ma_format_f32;
+    resourceConfig.decodedChannels   = 0;
+    resourceConfig.decodedSampleRate = sampleRate;
+    result = ma_resource_manager_init(&resourceConfig, &parallel->resources);
+    if (result != MA_SUCCESS) {
+        ma_data_source_uninit(&parallel->base);
+        return result;
+    }
+
+    parallel->channels       = channels;
+    parallel->sampleRate     = sampleRate;
+    parallel->threads        = threads;
+    parallel->frames         = MS_RENDER_BLOCK;
+    parallel->deadline       = MS_DEFAULT_PARALLEL_DEADLINE;
+    parallel->misses         = 0;
+    parallel->sitting_out    = 0;
+    parallel->mixed.assign(MS_RENDER_BLOCK * channels, 0.0f);
+    parallel->mixed_position = MS_RENDER_BLOCK; // nothing rendered yet
+    parallel->cursor         = 0;
+    parallel->stats          = ms_parallel_stats();
+    parallel->block_index.store(0);
+    parallel->remaining.store(0);
+    parallel->stolen.store(0);
+    parallel->quit.store(false);
+
+    parallel->queues = vector<ms_parallel_queue>(threads);
+    parallel->wake   = vector<ma_event>(threads);
+    for (ma_uint32 t = 1; t < threads; t++) {
+        ma_event_init(&parallel->wake[t]);
+        parallel->workers.emplace_back(ms_parallel_worker, parallel, t);
+    }
+
+    #ifdef MS_VERBOSE
+        std::cout << "ms_parallel :: " << threads << " threads" << std::endl;
+    #endif
+
+    return MA_SUCCESS;
 }
 
-void ms_sound_set_pan(ms_sound* sound, float pan) {
-    if (pan < -1.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_pan :: `pan` must be greater than or equal to -1.0" << std::endl;
-        #endif
-        pan = -1.0f;
+// stops the pool & uninitialises the submixes' engines. uninitialise the soundscapes built on them first
+void ms_parallel_uninit(ms_parallel* parallel) {
+    parallel->quit.store(true, std::memory_order_release);
+    for (ma_uint32 t = 1; t < parallel->threads; t++) ma_event_signal(&parallel->wake[t]);
+    for (std::thread& worker : parallel->workers) worker.join();
+    for (ma_uint32 t = 1; t < parallel->threads; t++) ma_event_uninit(&parallel->wake[t]);
+    parallel->workers.clear();
+    parallel->wake.clear();
+    parallel->queues.clear();
+
+    for (ms_submix* submix : parallel->submixes) {
+        ma_engine_uninit(&submix->engine);
+        delete submix;
     }
+    parallel->submixes.clear();
 
-    if (pan > 1.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_pan :: `pan` must be less than or equal to 1.0" << std::endl;
-        #endif
-        pan = 1.0f;
+    ma_resource_manager_uninit(&parallel->resources);
+    ma_data_source_uninit(&parallel->base);
+}
+
+// a new submix, returning the engine to build its soundscapes on. nullptr if the engine couldn't be made. submixes
+// are rendered in parallel with each other, so put soundscapes that are heavy on different ones. not while the
+// ms_parallel is being read
+ma_engine* ms_parallel_add_submix(ms_parallel* parallel) {
+    ms_submix* submix = new ms_submix;
+
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice         = MA_TRUE;
+    config.channels         = parallel->channels;
+    config.sampleRate       = parallel->sampleRate;
+    config.pResourceManager = &parallel->resources;
+    if (ma_engine_init(&config, &submix->engine) != MA_SUCCESS) {
+        delete submix;
+        return nullptr;
     }
 
-    sound->pan_range[0] = pan;
-    sound->pan_range[1] = pan;
+    submix->block.assign(MS_RENDER_BLOCK * parallel->channels, 0.0f);
+    parallel->submixes.push_back(submix);
+    return &submix->engine;
 }
 
-void ms_sound_set_pan(ms_sound* sound, float start, float end) {
-    if (start < end) { // swap start and end
-        float p0 = start;
-        float p1 = end;
-        start = p1;
-        end = p0;
+// tick `soundscape`, which was built on one of the submixes' engines, with the others in ms_parallel_tick(), so it
+// shouldn't also be ticked elsewhere. not while the ms_parallel is being read
+ma_result ms_parallel_add_soundscape(ms_parallel* parallel, ms_soundscape* soundscape) {
+    for (ms_submix* submix : parallel->submixes) {
+        if (&submix->engine != soundscape->engine) continue;
+        submix->soundscapes.push_back(soundscape);
+        return MA_SUCCESS;
     }
+    return MA_INVALID_ARGS;
+}
 
-    if (start < -1.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_pan :: `pan` must be greater than or equal to -1.0" << std::endl;
-        #endif
-        start = -1.0f;
+// stop ticking `soundscape`, before it's uninitialised
+void ms_parallel_remove_soundscape(ms_parallel* parallel, const ms_soundscape* soundscape) {
+    for (ms_submix* submix : parallel->submixes) {
+        vector<ms_soundscape*>& scapes = submix->soundscapes;
+        scapes.erase(std::remove(scapes.begin(), scapes.end(), soundscape), scapes.end());
     }
+}
 
-    if (end > 1.0f) {
-        #ifdef MS_VERBOSE
-            std::cout << "ms_sound_set_pan :: `pan` must be less than or equal to 1.0" << std::endl;
-        #endif
-        end = 1.0f;
+// game thread: tick every soundscape added, a submix at a time in the order they were added. ticks draw from the
+// shared generator & start sounds, so they're kept off the threads that mix, and in the one order the choices are
+// the same however many threads there are. call it once a frame as ms_soundscape_tick() would be, or between reads
+// of MS_RENDER_BLOCK frames for a render that comes out the same every time
+void ms_parallel_tick(ms_parallel* parallel) {
+    for (ms_submix* submix : parallel->submixes) {
+        for (ms_soundscape* soundscape : submix->soundscapes) {
+            if (!soundscape->sounds.empty()) ms_soundscape_tick(soundscape);
+        }
     }
+}
 
-    sound->pan_range[0] = start;
-    sound->pan_range[1] = end;
+// the fraction of a block's length the pool has to render it in before it counts as missed. a device has the whole
+// block for the rest of the graph as well, so it's well under 1 by default
+void ms_parallel_set_deadline(ms_parallel* parallel, float deadline) {
+    parallel->deadline = deadline;
 }
 
-/* --- ms_soundscape --- */
+ms_parallel_stats ms_parallel_get_stats(const ms_parallel* parallel) {
+    ms_parallel_stats stats = parallel->stats;
+    stats.stolen = parallel->stolen.load(std::memory_order_relaxed);
+    return stats;
+}
 
-#ifndef MS_NO_SOUNDSCAPE
+#endif /* MS_HAS_PARALLEL */
 
-ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, const unsigned int soundsAmount, ...);
-ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, ms_sound* sound);
-ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape);
-void      ms_soundscape_uninit(ms_soundscape* soundscape);
+/* --- ms_metrics --- */
 
-#ifdef MS_VERBOSE
-void      ms_soundscape_debug_list(ms_soundscape* soundscape);
-#endif
+#ifdef MS_HAS_METRICS
 
-void      ms_soundscape_add_sound(ms_soundscape* soundscape, const unsigned int soundsAmount, ...);
-void      ms_soundscape_add_sound(ms_soundscape* soundscape, ms_sound* sound);
-void      ms_soundscape_set_tickrate(ms_soundscape* soundscape, float tickrate);
+// the bytes miniaudio holds for `voice`'s file & how many sounds share them. streams & sounds made from a data source
+// hold next to nothing of their own
+static size_t ms_metrics_resident(const ma_sound* voice, ma_uint32* holders) {
+    *holders = 0;
+    const ma_resource_manager_data_source* source = voice->pResourceManagerDataSource;
+    if (source == NULL || (source->flags & MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_STREAM) != 0) return 0;
 
-bool      ms_soundscape_is_playing(const ms_soundscape* soundscape);
+    const ma_resource_manager_data_buffer_node* node = source->backend.buffer.pNode;
+    if (node == NULL) return 0;
+    *holders = node->refCount;
 
-ma_result ms_soundscape_tick(ms_soundscape* soundscape);
-ma_result ms_soundscape_start(const ms_soundscape* soundscape);
-ma_result ms_soundscape_stop(const ms_soundscape* soundscape);
-ma_result ms_soundscape_play_sound(const ms_soundscape* soundscape);
-ma_result ms_soundscape_play_sound_skip_empty(const ms_soundscape* soundscape);
-void      ms_soundscape_stop_all_sounds(const ms_soundscape* soundscape);
+    const ma_resource_manager_data_supply& data = node->data;
+    switch ((ma_resource_manager_data_supply_type)data.type) {
+        case ma_resource_manager_data_supply_type_encoded:
+            return data.backend.encoded.sizeInBytes;
+        case ma_resource_manager_data_supply_type_decoded:
+            return (size_t)data.backend.decoded.totalFrameCount * ma_get_bytes_per_frame(data.backend.decoded.format, data.backend.decoded.channels);
+        default:
+            return 0;
+    }
+}
 
-void      ms_soundscape_set_volume(ms_soundscape* soundscape, float volume);
-void      ms_soundscape_set_volume(ms_soundscape* soundscape, float start, float end);
-void      ms_soundscape_set_pitch(ms_soundscape* soundscape, float pitch);
-void      ms_soundscape_set_pitch(ms_soundscape* soundscape, float start, float end);
-void      ms_soundscape_set_pan(ms_soundscape* soundscape, float pan);
-void      ms_soundscape_set_pan(ms_soundscape* soundscape, float start, float end);
+// straight after `voice` was loaded from `path` for `owner` with `result`, taking `seconds`
+static void ms_metrics_load(const ma_sound* voice, ma_result result, const std::string& path, const std::string& owner, double seconds) {
+    ms_load_record record = {};
+    record.path         = path;
+    record.owner        = owner;
+    record.result       = result;
+    record.load_seconds = seconds;
 
-ma_result ms_soundscape_init(const std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, const unsigned int soundsAmount, ...) {
-    soundscape->name = name;
-    soundscape->engine = engine;
+    if (result != MA_SUCCESS) {
+        MS_METRIC_ADD(load_failures, 1);
+    } else {
+        MS_METRIC_ADD(loads, 1);
 
-    // check if the fifth & fourth to last characters in `ambientFilepath` are not '.'
-    // this means the user can input "file.wav", "file.mp3", "file.flac", and "file" and all are valid
-    // we default to using .wav as it is a more common file type
-    // this means we can make the function less verbose by implying the filetype in the filepath dynamically (as opposed to having a whole new argument that would have to be specified) :-)
-    if (ambientFilepath[ambientFilepath.size() - 4] != '.' && ambientFilepath[ambientFilepath.size() - 5] != '.') ambientFilepath += ".wav";
+        ma_uint32 holders;
+        size_t bytes = ms_metrics_resident(voice, &holders);
+        if (holders > 1) MS_METRIC_ADD(cache_hits, 1); // miniaudio shares the data it already had
+        else             MS_METRIC_ADD(bytes_resident, (ma_int64)bytes);
+        record.resident_bytes = (holders > 1) ? 0 : bytes;
+    }
 
-    ma_sound* ambient = new ma_sound;
-    ma_sound_init_from_file(soundscape->engine, ambientFilepath.c_str(), 0, NULL, NULL, ambient);
-    soundscape->ambient = ambient;
-    ma_sound_set_looping(soundscape->ambient, true);
+    if (!g_ms_metrics.profile_loads) return;
 
-    soundscape->timeSinceLastTick = 0;
-    soundscape->tickrate = MS_DEFAULT_TICK_RATE * MS_SAMPLE_RATE;
+    std::error_code error;
+    record.file_bytes = (size_t)std::filesystem::file_size(path, error);
+    if (error) record.file_bytes = 0;
 
-    if (soundsAmount > 0) {
-        va_list vl;
-        va_start(vl, soundsAmount);
-        for (size_t i = 0; i < soundsAmount; i++) {
-            ms_sound* s = va_arg(vl, ms_sound*);
-            for (size_t i = 0; i < s->weight; i++) {
-                soundscape->sounds.push_back(s);
-            }
+    if (result == MA_SUCCESS) {
+        // the file as it's stored, the voice's own decoder was asked for float. opening it again costs a little more
+        // but only while profiling
+        ma_decoder_config config = ma_decoder_config_init(ma_format_unknown, 0, 0);
+        ma_decoder native;
+        if (ma_decoder_init_file(path.c_str(), &config, &native) == MA_SUCCESS) {
+            ma_decoder_get_data_format(&native, &record.format, &record.channels, &record.sample_rate, NULL, 0);
+            ma_decoder_get_length_in_pcm_frames(&native, &record.frames);
+            ma_decoder_uninit(&native);
+        }
+        if (record.sample_rate > 0) {
+            ma_uint32 engineRate = ma_engine_get_sample_rate(ma_sound_get_engine(voice));
+            record.duration      = (double)record.frames / record.sample_rate;
+            record.decoded_bytes = (size_t)((double)record.frames * engineRate / record.sample_rate) * record.channels * sizeof(float);
         }
-        va_end(vl);
     }
 
-    #ifdef MS_VERBOSE
-        std::cout << "ms_soundscape_init :: initialising " << soundscape->name << " with " << soundsAmount << " ms_sound(s):" << std::endl;
-    #endif
+    g_ms_metrics.load_records.push_back(record);
+}
 
-    return MA_SUCCESS;
+// just before `voice` is uninitialised. the data is only freed with the last sound holding it
+static void ms_metrics_unload(const ma_sound* voice) {
+    ma_uint32 holders;
+    size_t bytes = ms_metrics_resident(voice, &holders);
+    if (holders == 1) MS_METRIC_ADD(bytes_resident, -(ma_int64)bytes);
 }
 
-ma_result ms_soundscape_init(std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape, ms_sound* sound) {
-    return ms_soundscape_init(name, engine, ambientFilepath, soundscape, 1, sound);
+// start or stop keeping an ms_load_record for every file ms_sound_init() & ms_soundscape_init() open. game thread
+void ms_metrics_profile_loads(bool enable) {
+    g_ms_metrics.profile_loads = enable;
 }
 
-ma_result ms_soundscape_init(std::string name, ma_engine* engine, std::string ambientFilepath, ms_soundscape* soundscape) {
-    return ms_soundscape_init(name, engine, ambientFilepath, soundscape, 0, "this is ignored");
+// the records kept since the last call, oldest first
+vector<ms_load_record> ms_metrics_take_loads() {
+    vector<ms_load_record> records;
+    records.swap(g_ms_metrics.load_records);
+    return records;
 }
 
-void ms_soundscape_uninit(ms_soundscape* soundscape) {
-    if (soundscape->sounds.size() == 0) return;
-    for (size_t i = soundscape->sounds.size(); i == 0; i--) {
-        ms_sound_uninit(soundscape->sounds[i]);
+#ifdef MS_PROFILE_NODES
+// add up the node timings into `snapshot`: per node with a sound's voices together, & per soundscape
+static void ms_metrics_profile_nodes(ms_metrics_snapshot* snapshot) {
+    for (const ms_node_profile* profile : g_ms_metrics.nodes) {
+        if (profile->engine != nullptr) {
+            ma_uint64 now = ma_engine_get_time_in_pcm_frames(profile->engine);
+            if (now > profile->clock_start) {
+                snapshot->audio_seconds += (double)(now - profile->clock_start) / ma_engine_get_sample_rate(profile->engine);
+            }
+            continue;
+        }
+        double seconds = profile->ns.load(std::memory_order_relaxed) / 1e9;
+
+        // a sound belongs to the first soundscape it was added to
+        const ms_soundscape* owner = profile->soundscape;
+        #ifndef MS_NO_SOUNDSCAPE
+        for (size_t i = 0; owner == nullptr && profile->sound != nullptr && i < g_ms_metrics.soundscapes.size(); i++) {
+            const vector<ms_sound*>& sounds = g_ms_metrics.soundscapes[i]->sounds;
+            if (std::find(sounds.begin(), sounds.end(), profile->sound) != sounds.end()) owner = g_ms_metrics.soundscapes[i];
+        }
+        for (size_t i = 0; owner != nullptr && i < g_ms_metrics.soundscapes.size(); i++) {
+            if (g_ms_metrics.soundscapes[i] == owner) snapshot->soundscapes[i].dsp_seconds += seconds;
+        }
+        #endif
+
+        std::string soundscape = (owner != nullptr) ? owner->name : "";
+        auto node = std::find_if(snapshot->nodes.begin(), snapshot->nodes.end(), [&](const ms_metrics_node& n) {
+            return n.name == profile->name && n.soundscape == soundscape;
+        });
+        if (node == snapshot->nodes.end()) snapshot->nodes.push_back({ profile->name, soundscape, seconds, 0.0, 0.0 });
+        else                               node->seconds += seconds;
+        snapshot->dsp_seconds += seconds;
     }
-}
 
-#ifdef MS_VERBOSE
-void ms_soundscape_debug_list(ms_soundscape* soundscape) {
-    std::cout << "ms_soundscape_debug_list :: " << soundscape->name << std::endl;
-    for (size_t i = 0; i < soundscape->sounds.size(); i++) {
-        std::cout << "ms_soundscape_debug_list :: " << soundscape->sounds[i]->name << std::endl;
+    for (ms_metrics_node& node : snapshot->nodes) {
+        node.share = (snapshot->dsp_seconds > 0.0) ? node.seconds / snapshot->dsp_seconds : 0.0;
+        node.load  = (snapshot->audio_seconds > 0.0) ? node.seconds / snapshot->audio_seconds : 0.0;
+    }
+    for (ms_metrics_soundscape& soundscape : snapshot->soundscapes) {
+        soundscape.dsp_share = (snapshot->dsp_seconds > 0.0) ? soundscape.dsp_seconds / snapshot->dsp_seconds : 0.0;
+        soundscape.dsp_load  = (snapshot->audio_seconds > 0.0) ? soundscape.dsp_seconds / snapshot->audio_seconds : 0.0;
     }
+    std::sort(snapshot->nodes.begin(), snapshot->nodes.end(), [](const ms_metrics_node& a, const ms_metrics_node& b) {
+        return a.seconds > b.seconds;
+    });
 }
 #endif
 
-ma_result ms_soundscape_tick(ms_soundscape* soundscape) {
-    if (ma_engine_get_time_in_pcm_frames(soundscape->engine) < soundscape->timeSinceLastTick + soundscape->tickrate) return MA_SUCCESS; // not enough time has passed for us to tick yet
-    #ifdef MS_VERBOSE
-        std::cout << "ms_soundscape_tick :: " << soundscape->name << " ticking" << std::endl;
+// the counters can be read from any thread. the soundscapes are listed by walking every one between init & uninit, so
+// call it from the thread that makes & destroys them. nothing here makes the audio thread wait, a HUD can call it
+// every frame
+ms_metrics_snapshot ms_metrics_get() {
+    ms_metrics_snapshot snapshot;
+    snapshot.voices_started   = g_ms_metrics.voices_started.load(std::memory_order_relaxed);
+    snapshot.voices_rejected  = g_ms_metrics.voices_rejected.load(std::memory_order_relaxed);
+    snapshot.ticks            = g_ms_metrics.ticks.load(std::memory_order_relaxed);
+    snapshot.loads            = g_ms_metrics.loads.load(std::memory_order_relaxed);
+    snapshot.load_failures    = g_ms_metrics.load_failures.load(std::memory_order_relaxed);
+    snapshot.cache_hits       = g_ms_metrics.cache_hits.load(std::memory_order_relaxed);
+    snapshot.commands_dropped = g_ms_metrics.commands_dropped.load(std::memory_order_relaxed);
+    snapshot.bytes_resident   = g_ms_metrics.bytes_resident.load(std::memory_order_relaxed);
+
+    #ifndef MS_NO_SOUNDSCAPE
+    for (const ms_soundscape* soundscape : g_ms_metrics.soundscapes) {
+        unsigned int voices = (soundscape->ambient != nullptr && ma_sound_is_playing(soundscape->ambient)) ? 1 : 0;
+        for (const ms_sound* sound : ms_soundscape_unique_sounds(soundscape)) {
+            for (ma_sound* s : sound->sounds) voices += ma_sound_is_playing(s) ? 1 : 0;
+        }
+        snapshot.soundscapes.push_back({ soundscape->name, voices, 0.0, 0.0, 0.0 });
+    }
     #endif
-    soundscape->timeSinceLastTick = ma_engine_get_time_in_pcm_frames(soundscape->engine);
-    ms_soundscape_play_sound(soundscape);
-    return MA_SUCCESS;
+
+    snapshot.dsp_seconds   = 0.0;
+    snapshot.audio_seconds = 0.0;
+    #ifdef MS_PROFILE_NODES
+        ms_metrics_profile_nodes(&snapshot);
+    #endif
+
+    return snapshot;
 }
 
-void ms_soundscape_add_sound(ms_soundscape* soundscape, const unsigned int soundsAmount, ...) {
-    va_list vl;
-    va_start(vl, soundsAmount);
-    for (size_t i = 0; i < soundsAmount; i++) {
-        ms_soundscape_add_sound(soundscape, va_arg(vl, ms_sound*));
-    }
-    va_end(vl);
+// zero the counters, e.g. between levels. bytes resident is left alone, it's what's loaded rather than a count
+void ms_metrics_reset() {
+    g_ms_metrics.voices_started.store(0, std::memory_order_relaxed);
+    g_ms_metrics.voices_rejected.store(0, std::memory_order_relaxed);
+    g_ms_metrics.ticks.store(0, std::memory_order_relaxed);
+    g_ms_metrics.loads.store(0, std::memory_order_relaxed);
+    g_ms_metrics.load_failures.store(0, std::memory_order_relaxed);
+    g_ms_metrics.cache_hits.store(0, std::memory_order_relaxed);
+    g_ms_metrics.commands_dropped.store(0, std::memory_order_relaxed);
+    #ifdef MS_PROFILE_NODES
+        for (ms_node_profile* profile : g_ms_metrics.nodes) {
+            profile->ns.store(0, std::memory_order_relaxed);
+            profile->frames.store(0, std::memory_order_relaxed);
+            profile->tiered_ns = 0;
+            if (profile->engine != nullptr) profile->clock_start = ma_engine_get_time_in_pcm_frames(profile->engine);
+        }
+    #endif
 }
 
-void ms_soundscape_add_sound(ms_soundscape* soundscape, ms_sound* sound) {
-    #ifdef MS_VERBOSE
-        std::cout << "ms_soundscape_add_sound :: adding " << sound->name << " to " << soundscape->name << std::endl;
+#endif /* MS_HAS_METRICS */
+
+/* --- ms_trace --- */
+
+// an engine's device callback that traces every read as a span on a thread called "audio". hand it to the engine
+// with ma_engine_config's `dataCallback`, miniaudio points the device's user data at the engine
+void ms_trace_data_callback(ma_device* pDevice, void* pFramesOut, const void* pFramesIn, ma_uint32 frameCount) {
+    #ifdef MS_TRACE
+        if (t_ms_trace.thread == nullptr) ms_trace_thread_name("audio");
     #endif
-    for (size_t i = 0; i < sound->weight; i++) {
-        soundscape->sounds.push_back(sound);
-    }
+    ma_uint64 traced = ms_trace_begin();
+    ma_engine_read_pcm_frames((ma_engine*)pDevice->pUserData, pFramesOut, frameCount, NULL);
+    ms_trace_end("audio callback", traced);
+    (void)pFramesIn;
 }
 
-void ms_soundscape_set_tickrate(ms_soundscape* soundscape, float tickrate) {
-    if (tickrate < 0) {
+// everything recorded since the last call, as chrome trace event json for chrome://tracing or ui.perfetto.dev. one
+// thread at a time, any thread. without MS_TRACE there's nothing to write
+ma_result ms_trace_write(const std::string filepath) {
+    #ifdef MS_TRACE
+        FILE* file = fopen(filepath.c_str(), "w");
+        if (file == NULL) return MA_ACCESS_DENIED;
+
+        fprintf(file, "{\"traceEvents\":[\n");
+        bool first = true;
+        ma_uint32 threads = 0;
+        for (ma_uint32 t = 0; t < MS_TRACE_THREADS; t++) {
+            ms_trace_thread& thread = g_ms_trace_threads[t];
+            if (!thread.used.load(std::memory_order_acquire)) continue;
+            threads++;
+            fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", t, (thread.name[0] != 0) ? thread.name : "thread");
+            first = false;
+
+            ma_uint32 read  = thread.read.load(std::memory_order_relaxed);
+            ma_uint32 write = thread.write.load(std::memory_order_acquire);
+            for (; read != write; read++) {
+                const ms_trace_event& e = thread.events[read & (MS_TRACE_CAPACITY - 1)];
+                double ts = (double)(ma_int64)(e.start - g_ms_trace_epoch) / 1000.0; // microseconds
+                fprintf(file, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f", e.phase, t, e.name, ts);
+                if (e.phase == 'X') fprintf(file, ",\"dur\":%.3f", e.duration / 1000.0);
+                if (e.phase == 'i') fprintf(file, ",\"s\":\"t\"");
+                if (e.detail[0] != 0) {
+                    fprintf(file, ",\"args\":{\"detail\":\"");
+                    for (const char* c = e.detail; *c != 0; c++) {
+                        if (*c == '"' || *c == '\\') fputc('\\', file);
+                        fputc(*c, file);
+                    }
+                    fprintf(file, "\"}");
+                }
+                fprintf(file, "}");
+            }
+            thread.read.store(read, std::memory_order_release);
+
+            ma_uint32 dropped = thread.dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                fprintf(file, ",\n{\"ph\":\"i\",\"pid\":1,\"tid\":%u,\"name\":\"%u events dropped\",\"ts\":%.3f,\"s\":\"t\"}", t, dropped, (double)(ma_int64)(ms_trace_now() - g_ms_trace_epoch) / 1000.0);
+            }
+        }
+        fprintf(file, "\n]}\n");
+        fclose(file);
+
         #ifdef MS_VERBOSE
-            std::cout << "ms_soundscape_set_tickrate :: " << soundscape->name << ", tickrate below zero" << std::endl;
+            std::cout << "ms_trace_write :: " << filepath << ", " << threads << " thread(s)" << std::endl;
         #endif
-        tickrate = 0;
-    }
-    soundscape->tickrate = tickrate * MS_SAMPLE_RATE;
+        return MA_SUCCESS;
+    #else
+        (void)filepath;
+        return MA_NOT_IMPLEMENTED;
+    #endif
 }
 
-bool ms_soundscape_is_playing(const ms_soundscape* soundscape) {
-    for (ms_sound* s : soundscape->sounds) {
-        if (ms_sound_is_playing(s)) return true;
-    }
-    return false;
-}
+/* --- ms::Sound, ms::Soundscape & ms::Speaker --- */
 
-// https://github.com/mackron/miniaudio/issues/714
-ma_result ms_soundscape_start(const ms_soundscape* soundscape) {
-    if (soundscape->ambient != nullptr) {
-        // ma_sound_set_stop_time_in_milliseconds(soundscape->ambient, ~(ma_uint64)0);
-        // ma_sound_set_fade_in_milliseconds(soundscape->ambient, 0.0f, 1.0f, FADE_AMOUNT_MS);
-        ma_sound_set_stop_time_in_milliseconds(soundscape->ambient, ~(ma_uint64)0);
-        ma_sound_set_fade_in_pcm_frames(soundscape->ambient, 0.0f, 1.0f, MS_DEFAULT_FADE_AMOUNT);
-        ma_sound_start(soundscape->ambient);
-    }
-    return MA_SUCCESS;
-}
+// move-only owners of an ms_sound, an ms_soundscape & an ms_sound_speaker, for C++ that would rather not pair every
+// init with an uninit by hand or pass pointers through `...`. each keeps its struct on the heap, so moving one hands
+// the pointer over & never allocates, and anything pointing at the struct (a soundscape at its sounds, a sound at its
+// speakers, a sound table) stays valid. each only tears down what it made, a soundscape never its sounds nor a sound
+// its speakers. get() is there for everything not wrapped
+namespace ms {
 
-ma_result ms_soundscape_stop(const ms_soundscape* soundscape) {
-    // ma_sound_set_fade_in_milliseconds(soundscape->ambient, -1.0f, 0.0f, FADE_AMOUNT_MS);
-    ma_sound_set_fade_in_pcm_frames(soundscape->ambient, -1.0f, 0.0f, MS_DEFAULT_FADE_AMOUNT);
-    ma_sound_set_stop_time_in_pcm_frames(soundscape->ambient, ma_engine_get_time_in_pcm_frames(soundscape->engine) + MS_DEFAULT_FADE_AMOUNT);
-    return MA_SUCCESS;
-}
+// a view of `size()` items in a row - an array, a vector or a pointer & a count - read during the call it's passed to
+// and never kept, so nothing is copied. the owners take braced lists too, as std::initializer_list
+template <typename T>
+class span {
+public:
+    constexpr span() = default;
+    constexpr span(T* items, size_t count) : items(items), count(count) {}
+    template <size_t N>
+    constexpr span(T (&array)[N]) : items(array), count(N) {}
+    span(vector<std::remove_const_t<T>>& v) : items(v.data()), count(v.size()) {}
+    span(const vector<std::remove_const_t<T>>& v) : items(v.data()), count(v.size()) {}
 
-ma_result ms_soundscape_play_sound(const ms_soundscape* soundscape) {
-    return ms_sound_start(soundscape->sounds[rand() % soundscape->sounds.size()]);
-}
+    constexpr T* begin() const { return items; }
+    constexpr T* end() const { return items + count; }
+    constexpr size_t size() const { return count; }
 
-ma_result ms_soundscape_play_sound_skip_empty(const ms_soundscape* soundscape) {
-    for (size_t i = 0; i < soundscape->sounds.size(); i++) {
-        size_t r = rand() % soundscape->sounds.size();
-        if (soundscape->sounds[r]->name != "empty") return ms_sound_start(soundscape->sounds[r]);
-    }
-    return ms_sound_start(soundscape->sounds[rand() % soundscape->sounds.size()]);
-}
+private:
+    T* items     = nullptr;
+    size_t count = 0;
+};
 
-void ms_soundscape_stop_all_sounds(const ms_soundscape* soundscape) {
-    for (ms_sound* sound : soundscape->sounds) {
-        ms_sound_stop(sound);
+#ifndef MS_NO_SPATIALIZATION
+class Speaker {
+public:
+    Speaker(const std::string& name, double x, double y, double z) : speaker(new ms_sound_speaker()) {
+        ms_sound_speaker_init(name, speaker, x, y, z);
     }
-}
-
-void ms_soundscape_set_volume(ms_soundscape* soundscape, float volume) {
-    for (ms_sound* s : soundscape->sounds) {
-        ms_sound_set_volume(s, s->volume_range[0] * volume, s->volume_range[1] * volume);
+    Speaker(Speaker&& other) noexcept : speaker(std::exchange(other.speaker, nullptr)) {}
+    Speaker& operator=(Speaker&& other) noexcept {
+        if (this != &other) {
+            release();
+            speaker = std::exchange(other.speaker, nullptr);
+        }
+        return *this;
     }
-}
+    Speaker(const Speaker&) = delete;
+    Speaker& operator=(const Speaker&) = delete;
+    ~Speaker() { release(); }
 
-void ms_soundscape_set_volume(ms_soundscape* soundscape, float start, float end) {
-    for (ms_sound* s : soundscape->sounds) {
-        ms_sound_set_volume(s, s->volume_range[0] * start, s->volume_range[1] * end);
-    }
-}
+    void set_path(const ms_path* path) { ms_sound_speaker_set_path(speaker, path); }
+    bool is_occupied() const { return speaker->sound != nullptr && ms_sound_speaker_is_occupied(speaker); }
+    ms_sound_speaker* get() const { return speaker; }
 
-void ms_soundscape_set_pitch(ms_soundscape* soundscape, float pitch) {
-    for (ms_sound* s : soundscape->sounds) {
-        ms_sound_set_pitch(s, s->pitch_range[0] * pitch, s->pitch_range[1] * pitch);
+private:
+    void release() {
+        if (speaker != nullptr) ms_sound_speaker_uninit(speaker); // deletes it
+        speaker = nullptr;
     }
-}
 
-void ms_soundscape_set_pitch(ms_soundscape* soundscape, float start, float end) {
-    for (ms_sound* s : soundscape->sounds) {
-        ms_sound_set_pitch(s, s->pitch_range[0] * start, s->pitch_range[1] * end);
+    ms_sound_speaker* speaker;
+};
+#endif /* MS_NO_SPATIALIZATION */
+
+class Sound {
+public:
+    Sound(const std::string& name, ma_engine* engine, unsigned int weight, const std::string& filepath, ms_sound_filetype filetype = MS_DEFAULT_FILETYPE, bool spatialization = true) : sound(new ms_sound()) {
+        ms_sound_init(name, engine, weight, filepath, sound, filetype, spatialization);
     }
-}
+    // a placeholder that's never started, see ms_sound_init_empty()
+    static Sound empty(unsigned int weight) {
+        Sound placeholder;
+        ms_sound_init_empty(placeholder.sound, weight);
+        return placeholder;
+    }
+    Sound(Sound&& other) noexcept : sound(std::exchange(other.sound, nullptr)) {}
+    Sound& operator=(Sound&& other) noexcept {
+        if (this != &other) {
+            release();
+            sound = std::exchange(other.sound, nullptr);
+        }
+        return *this;
+    }
+    Sound(const Sound&) = delete;
+    Sound& operator=(const Sound&) = delete;
+    ~Sound() { release(); }
 
-void ms_soundscape_set_pan(ms_soundscape* soundscape, float pan) {
-    for (ms_sound* s : soundscape->sounds) {
-        ms_sound_set_pan(s, pan, pan);
+    // false when none of its files loaded
+    bool loaded() const { return !sound->sounds.empty(); }
+
+    ma_result start() { return ms_sound_start(sound); }
+    ma_result stop() { return ms_sound_stop(sound); }
+    bool is_playing() const { return ms_sound_is_playing(sound); }
+
+    void set_volume(float volume) { ms_sound_set_volume(sound, volume); }
+    void set_volume(float start, float end) { ms_sound_set_volume(sound, start, end); }
+    void set_pitch(float pitch) { ms_sound_set_pitch(sound, pitch); }
+    void set_pitch(float start, float end) { ms_sound_set_pitch(sound, start, end); }
+    void set_pan(float pan) { ms_sound_set_pan(sound, pan); }
+    void set_pan(float start, float end) { ms_sound_set_pan(sound, start, end); }
+
+    #ifndef MS_NO_SPATIALIZATION
+    void set_spatialization(bool spatialization) { ms_sound_set_spatialization(sound, spatialization); }
+    void set_position(double x, double y, double z) { ms_sound_set_position(sound, x, y, z); }
+    void add_speakers(span<Speaker* const> speakers) {
+        for (Speaker* speaker : speakers) sound->speakers.push_back(speaker->get());
+        ms_sound_classify(sound);
     }
-}
+    void add_speakers(std::initializer_list<Speaker*> speakers) { add_speakers(span<Speaker* const>(speakers.begin(), speakers.size())); }
+    #endif
 
-void ms_soundscape_set_pan(ms_soundscape* soundscape, float start, float end) {
-    for (ms_sound* s : soundscape->sounds) {
-        ms_sound_set_pan(s, start, end);
+    const std::string& name() const { return sound->name; }
+    ms_sound* get() const { return sound; }
+
+private:
+    Sound() : sound(new ms_sound()) {}
+
+    void release() {
+        if (sound == nullptr) return;
+        ms_sound_uninit(sound);
+        delete sound;
+        sound = nullptr;
     }
 
-}
+    ms_sound* sound;
+};
 
-#endif /* MS_NO_SOUNDSCAPE */
+#ifndef MS_NO_SOUNDSCAPE
+class Soundscape {
+public:
+    // `ambientFilepath` as ms_soundscape_init() takes it. whether it loaded is in result(), a soundscape whose ambient
+    // didn't load still plays its sounds
+    Soundscape(const std::string& name, ma_engine* engine, const std::string& ambientFilepath, span<Sound* const> sounds) : soundscape(new ms_soundscape()) {
+        initialised = ms_soundscape_init(name, engine, ambientFilepath, soundscape);
+        usable      = true;
+        add(sounds);
+    }
+    Soundscape(const std::string& name, ma_engine* engine, const std::string& ambientFilepath, std::initializer_list<Sound*> sounds = {})
+        : Soundscape(name, engine, ambientFilepath, span<Sound* const>(sounds.begin(), sounds.size())) {}
+    // any data source as the ambient, it has to outlive the soundscape. if it can't be played nothing is initialised,
+    // see ok()
+    Soundscape(const std::string& name, ma_engine* engine, ma_data_source* ambient, span<Sound* const> sounds) : soundscape(new ms_soundscape()) {
+        initialised = ms_soundscape_init_from_data_source(name, engine, ambient, soundscape, 0);
+        usable      = (initialised == MA_SUCCESS);
+        add(sounds);
+    }
+    Soundscape(const std::string& name, ma_engine* engine, ma_data_source* ambient, std::initializer_list<Sound*> sounds = {})
+        : Soundscape(name, engine, ambient, span<Sound* const>(sounds.begin(), sounds.size())) {}
+    Soundscape(Soundscape&& other) noexcept : soundscape(std::exchange(other.soundscape, nullptr)), initialised(other.initialised), usable(other.usable) {}
+    Soundscape& operator=(Soundscape&& other) noexcept {
+        if (this != &other) {
+            release();
+            soundscape  = std::exchange(other.soundscape, nullptr);
+            initialised = other.initialised;
+            usable      = other.usable;
+        }
+        return *this;
+    }
+    Soundscape(const Soundscape&) = delete;
+    Soundscape& operator=(const Soundscape&) = delete;
+    ~Soundscape() { release(); }
 
-/* --- ms_sound_speaker --- */
+    // what initialising it returned
+    ma_result result() const { return initialised; }
+    // false when there's no soundscape behind it, only result() & get() mean anything then. adding to one is ignored
+    bool ok() const { return usable; }
 
-#ifndef MS_NO_SPATIALIZATION
+    void add(span<Sound* const> sounds) {
+        if (!usable) return;
+        for (Sound* sound : sounds) ms_soundscape_add_sound(soundscape, sound->get());
+    }
+    void add(std::initializer_list<Sound*> sounds) { add(span<Sound* const>(sounds.begin(), sounds.size())); }
 
-void ms_sound_speaker_init(std::string name, ms_sound_speaker* speaker, double x, double y, double z);
-void ms_sound_speaker_uninit(ms_sound_speaker* speaker);
-bool ms_sound_speaker_is_occupied(ms_sound_speaker* speaker);
+    ma_result tick() { return ms_soundscape_tick(soundscape); }
+    ma_result start() { return ms_soundscape_start(soundscape); }
+    ma_result stop() { return ms_soundscape_stop(soundscape); }
+    ma_result play_sound() { return ms_soundscape_play_sound(soundscape); }
+    ma_result play_sound_skip_empty() { return ms_soundscape_play_sound_skip_empty(soundscape); }
+    void stop_all_sounds() { ms_soundscape_stop_all_sounds(soundscape); }
+    bool is_playing() const { return ms_soundscape_is_playing(soundscape); }
 
-void ms_sound_speaker_init(std::string name, ms_sound_speaker* speaker, double x, double y, double z) {
-    speaker->name = name;
-    speaker->x    = x;
-    speaker->y    = y;
-    speaker->z    = z;
-}
+    void set_tickrate(float tickrate) { ms_soundscape_set_tickrate(soundscape, tickrate); }
+    void set_volume(float volume) { ms_soundscape_set_volume(soundscape, volume); }
+    void set_volume(float start, float end) { ms_soundscape_set_volume(soundscape, start, end); }
+    void set_pitch(float pitch) { ms_soundscape_set_pitch(soundscape, pitch); }
+    void set_pitch(float start, float end) { ms_soundscape_set_pitch(soundscape, start, end); }
+    void set_pan(float pan) { ms_soundscape_set_pan(soundscape, pan); }
+    void set_pan(float start, float end) { ms_soundscape_set_pan(soundscape, start, end); }
 
-void ms_sound_speaker_uninit(ms_sound_speaker* speaker) {
-    delete speaker;
-}
+    ms_sound* find_sound(const std::string& name) const { return ms_soundscape_find_sound(soundscape, name); }
+    const std::string& name() const { return soundscape->name; }
+    ms_soundscape* get() const { return soundscape; }
 
-bool ms_sound_speaker_is_occupied(ms_sound_speaker* speaker) {
-    return ms_sound_is_playing(speaker->sound);
-}
+private:
+    void release() {
+        if (soundscape == nullptr) return;
+        if (usable) ms_soundscape_uninit(soundscape); // its sounds are their ms::Sound's
+        delete soundscape;
+        soundscape = nullptr;
+    }
 
-#endif // MS_NO_SPATIALIZATION
+    ms_soundscape* soundscape;
+    ma_result initialised = MA_SUCCESS;
+    bool usable           = false; // initialised, even if without its ambient
+};
+#endif /* MS_NO_SOUNDSCAPE */
+
+} // namespace ms
 
 #endif // MINISOUNDSCAPE_H
\ No newline at end of file
@@ -0,0 +1,141 @@
+#ifndef CALLBACK_TIMER_H
+#define CALLBACK_TIMER_H
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+
+// include miniaudio.h first, from wherever the project keeps it. 01 & 02 both find this header through -I../common
+
+// how long the audio callback takes next to the time it has, which is the length of the buffer it was asked to fill.
+// wrap the engine read in callback_timer_begin() & callback_timer_end() and any thread can callback_timer_get() the
+// counts: callbacks, underruns (a callback that took longer than its buffer plays for), the mean & worst duration,
+// how much of the deadline the last & worst took, and a histogram of durations in doubling buckets. the audio thread
+// is the only writer & never blocks. timing is opt-in, define CALLBACK_TIMING or begin & end compile to nothing
+
+#ifndef CALLBACK_TIMER_BUCKETS
+    #define CALLBACK_TIMER_BUCKETS 20 // bucket b holds durations under 2^b microseconds, the last one everything longer
+#endif
+
+struct callback_timer {
+    std::atomic<ma_uint64> callbacks;
+    std::atomic<ma_uint64> underruns;
+    std::atomic<ma_uint64> total_ns;
+    std::atomic<ma_uint64> worst_ns;
+    std::atomic<float> last_load;  // fraction of its deadline the last callback took
+    std::atomic<float> worst_load;
+    std::atomic<ma_uint64> histogram[CALLBACK_TIMER_BUCKETS];
+    ma_uint32 sample_rate;
+};
+
+// a copy of the counts at one moment
+struct callback_timer_stats {
+    ma_uint64 callbacks;
+    ma_uint64 underruns;
+    double mean_us;
+    double worst_us;
+    float last_load;
+    float worst_load;
+    ma_uint64 histogram[CALLBACK_TIMER_BUCKETS];
+};
+
+static void callback_timer_init(callback_timer* timer, ma_uint32 sampleRate) {
+    timer->callbacks.store(0);
+    timer->underruns.store(0);
+    timer->total_ns.store(0);
+    timer->worst_ns.store(0);
+    timer->last_load.store(0.0f);
+    timer->worst_load.store(0.0f);
+    for (int b = 0; b < CALLBACK_TIMER_BUCKETS; b++) timer->histogram[b].store(0);
+    timer->sample_rate = sampleRate;
+}
+
+static inline ma_uint64 callback_timer_now() {
+    return (ma_uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------------------------------------------------
+// audio thread
+
+static inline ma_uint64 callback_timer_begin() {
+    #ifdef CALLBACK_TIMING
+        return callback_timer_now();
+    #else
+        return 0;
+    #endif
+}
+
+// `frameCount` is what the callback was asked for, playing it takes as long as the callback has
+static inline void callback_timer_end(callback_timer* timer, ma_uint64 start, ma_uint32 frameCount) {
+    #ifdef CALLBACK_TIMING
+        ma_uint64 elapsed  = callback_timer_now() - start;
+        ma_uint64 deadline = (ma_uint64)frameCount * 1000000000 / timer->sample_rate;
+        float load         = (deadline > 0) ? (float)elapsed / (float)deadline : 0.0f;
+
+        // only this thread writes, so plain loads & stores are enough & nothing here ever waits
+        timer->callbacks.store(timer->callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        timer->total_ns.store(timer->total_ns.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+        if (elapsed > deadline) {
+            timer->underruns.store(timer->underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        if (elapsed > timer->worst_ns.load(std::memory_order_relaxed)) {
+            timer->worst_ns.store(elapsed, std::memory_order_relaxed);
+        }
+        if (load > timer->worst_load.load(std::memory_order_relaxed)) {
+            timer->worst_load.store(load, std::memory_order_relaxed);
+        }
+        timer->last_load.store(load, std::memory_order_relaxed);
+
+        // the bucket is the number of bits the duration in microseconds takes
+        ma_uint64 us = elapsed / 1000;
+        int bucket   = 0;
+        while (us > 0 && bucket < CALLBACK_TIMER_BUCKETS - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        timer->histogram[bucket].store(timer->histogram[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    #else
+        (void)timer;
+        (void)start;
+        (void)frameCount;
+    #endif
+}
+
+// ------------------------------------------------------------
+// any thread
+
+static callback_timer_stats callback_timer_get(const callback_timer* timer) {
+    callback_timer_stats stats;
+    stats.callbacks  = timer->callbacks.load(std::memory_order_relaxed);
+    stats.underruns  = timer->underruns.load(std::memory_order_relaxed);
+    stats.mean_us    = (stats.callbacks > 0) ? timer->total_ns.load(std::memory_order_relaxed) / 1000.0 / stats.callbacks : 0.0;
+    stats.worst_us   = timer->worst_ns.load(std::memory_order_relaxed) / 1000.0;
+    stats.last_load  = timer->last_load.load(std::memory_order_relaxed);
+    stats.worst_load = timer->worst_load.load(std::memory_order_relaxed);
+    for (int b = 0; b < CALLBACK_TIMER_BUCKETS; b++) {
+        stats.histogram[b] = timer->histogram[b].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+// the duration in microseconds `fraction` of callbacks came in under, to the nearest bucket. 0.99 for the p99
+static double callback_timer_percentile(const callback_timer_stats* stats, double fraction) {
+    ma_uint64 total = 0;
+    for (int b = 0; b < CALLBACK_TIMER_BUCKETS; b++) total += stats->histogram[b];
+    if (total == 0) return 0.0;
+
+    ma_uint64 seen = 0;
+    for (int b = 0; b < CALLBACK_TIMER_BUCKETS; b++) {
+        seen += stats->histogram[b];
+        if (seen >= fraction * total) return (double)(1ULL << b);
+    }
+    return stats->worst_us;
+}
+
+static void callback_timer_print(const callback_timer_stats* stats, FILE* out = stdout) {
+    fprintf(out, "audio callback | %llu calls | %llu underruns | mean %.0f us | p99 < %.0f us | worst %.0f us | load %.0f%% now, %.0f%% worst\n",
+        (unsigned long long)stats->callbacks, (unsigned long long)stats->underruns, stats->mean_us,
+        callback_timer_percentile(stats, 0.99), stats->worst_us, 100.0f * stats->last_load, 100.0f * stats->worst_load);
+}
+
+#endif